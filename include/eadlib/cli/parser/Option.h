@@ -20,6 +20,7 @@ namespace eadlib {
             size_t valuesExpected() const;
             std::vector<bool> getValueFlags() const;
             std::vector<std::string> getValues() const;
+            bool isSet() const;
           private:
             struct Value {
                 Value( const std::regex &regex, const std::string &fail_msg ) :
@@ -207,6 +208,19 @@ namespace eadlib {
             }
             return v;
         }
+
+        /**
+         * Checks if any value of the Option was given (defaults aside)
+         * @return Set state
+         */
+        inline bool Option::isSet() const {
+            for( auto it = _values.begin(); it != _values.end(); ++it ) {
+                if( it->_flag ) {
+                    return true;
+                }
+            }
+            return false;
+        }
     }
 }
 
@@ -50,6 +50,7 @@ namespace eadlib {
             void printInfo() const;
             std::vector<bool> getValueFlags( const std::string &option_name ) const;
             std::vector<std::string> getValues( const std::string &option_name ) const;
+            bool isSet( const std::string &option_name ) const;
             size_t size() const;
             bool isEmpty() const;
 
@@ -253,6 +254,24 @@ namespace eadlib {
             }
         }
 
+        /**
+         * Checks if an option was given a value (i.e. not just its default)
+         * @param option_name Option name
+         * @return Set state
+         * @throws std::out_of_range when option name given is not found
+         */
+        inline bool Parser::isSet( const std::string &option_name ) const {
+            if( _name_map.find( option_name ) != _name_map.end() ) {
+                return _options.at( _name_map.at( option_name ) ).isSet();
+            } else if( _alt_map.find( option_name ) != _alt_map.end() ) {
+                return _options.at( _alt_map.at( option_name ) ).isSet();
+            } else {
+                std::cerr << "Option '" << option_name << "' does not exist." << std::endl;
+                throw std::out_of_range( "[eadlib::cli::Parser::isSet( std::string )] "
+                                             "Name of option given does not exist." );
+            }
+        }
+
         /**
          * Gets the list of values for an option
          * @param option_name Option name
@@ -17,6 +17,7 @@
 #include <fstream>
 #include <memory>
 #include <errno.h>
+#include <cstring>
 #include "../logger/Logger.h"
 
 namespace eadlib {
@@ -16,6 +16,7 @@
 
 #include <fstream>
 #include <memory>
+#include <cstring>
 #include "../logger/Logger.h"
 
 namespace eadlib {
@@ -37,12 +37,122 @@ void genomeMaker::cli::setupOptions( char **argv, const std::string &program_tit
         //Simulated sequencer reads file creation section
         parser.option( "Sequencer", "-f", "-fasta", "Name of the FASTA file to create.", false,
                        {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
-        parser.option( "Sequencer", "-l", "-length", "Character length of each reads.", false,
-                       {{ std::regex( "[0-9]+" ), "Character length value must be integer.", "260" }} );
+        parser.option( "Sequencer", "-l", "-length", "Character length of each reads (default 260, maximum length for long reads).", false,
+                       {{ std::regex( "[0-9]+" ), "Character length value must be integer." }} );
         parser.option( "Sequencer", "-d", "-depth", "Depth of reads.", false,
                        {{ std::regex( "[0-9]+" ), "Depth of reads value must be integer." }} );
+        parser.option( "Sequencer", "-tl", "-tiling", "Reads tiling the genome at a fixed stride (instead of -d).", false,
+                       {{ std::regex( "^[1-9][0-9]*$" ), "Tiling stride must be a positive integer." }} );
+        parser.option( "Sequencer", "-tu", "-topup", "Depth to top the reads of an existing sequencer file up to (instead of -d).", false,
+                       {{ std::regex( "[0-9]+" ), "Top-up depth value must be integer." }} );
         parser.option( "Sequencer", "-e", "-error", "Error rate of the simulated sequencer (0 <= x <= 1).", false,
                        {{ std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Error rate should be between 0-1 inclusive.", "0" }} );
+        parser.option( "Sequencer", "-st", "-strand", "Genome strand(s) the reads are taken from (forward, both).", false,
+                       {{ std::regex( "^forward$|^both$", std::regex::icase ), "Strand must be either \'forward\' or \'both\'", "forward" }} );
+        parser.option( "Sequencer", "-io", "-ioblock", "Size of the blocks read from the genome file (bytes, or with a K, M or G suffix).", false,
+                       {{ std::regex( "^[1-9][0-9]*[kKmMgG]?$" ), "I/O block size must be a positive integer with an optional K, M or G suffix.", "64M" }} );
+        parser.option( "Sequencer", "-sd", "-seed", "Seed the reads are generated from (any read can then be regenerated on its own).", false,
+                       {{ std::regex( "^[0-9]+$" ), "Seed must be a positive integer.", "0" }} );
+        //FASTQ output and quality models
+        parser.option( "FASTQ", "-q", "-fastq", "Name of the FASTQ file to create (instead of FASTA).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "FASTQ", "-qp", "-qprofile", "Empirical quality profile file (one line of Q0,Q1,.. counts per read position).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "FASTQ", "-qd", "-qdecay", "Mean quality at the start and end of reads for the decay curve (0-41).", false,
+                       {{ std::regex( "^[0-9]$|^[1-3][0-9]$|^4[0-1]$" ), "Start quality must be an integer between 0-41.", "40" },
+                        { std::regex( "^[0-9]$|^[1-3][0-9]$|^4[0-1]$" ), "End quality must be an integer between 0-41.", "20" }} );
+        parser.option( "FASTQ", "-qb", "-qbinning", "Illumina-style 8-level quality binning (on, off).", false,
+                       {{ std::regex( "^on$|^off$", std::regex::icase ), "Binning must be either \'on\' or \'off\'", "off" }} );
+        //Per-base error model
+        parser.option( "Errors", "-er", "-erates", "Per-base substitution, insertion and deletion rates (0 <= x <= 1, default 0 or 0.01 0.02 0.02 for long reads).", false,
+                       {{ std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Substitution rate should be between 0-1 inclusive." },
+                        { std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Insertion rate should be between 0-1 inclusive." },
+                        { std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Deletion rate should be between 0-1 inclusive." }} );
+        parser.option( "Errors", "-ea", "-eramp", "Per-base error rate at the end of reads relative to their start.", false,
+                       {{ std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Ramp factor must be a positive number.", "1" }} );
+        parser.option( "Errors", "-ep", "-eprofile", "Position dependent error profile file (one relative rate per read position).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Errors", "-em", "-ematrix", "Substitution matrix file (4 rows of 4 weights in A,C,G,T/U order).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Errors", "-eh", "-ehotspots", "Error hotspot file (motif of 1-8 bases and error rate of the base following it per line).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        //Paired reads
+        parser.option( "Paired", "-pe", "-paired", "Paired-end reads with the mean and standard deviation of the fragment size.", false,
+                       {{ std::regex( "[0-9]+" ), "Fragment size mean must be integer." },
+                        { std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Fragment size standard deviation must be a positive number." }} );
+        parser.option( "Paired", "-mp", "-matepair", "Mate-pair reads with the mean and standard deviation of the insert size.", false,
+                       {{ std::regex( "[0-9]+" ), "Insert size mean must be integer." },
+                        { std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Insert size standard deviation must be a positive number." }} );
+        parser.option( "Paired", "-m2", "-mates", "Name of the file for the mate #2 reads (interleaved when not given).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        //Long reads
+        parser.option( "Long reads", "-lr", "-longreads", "Long reads with the mean and standard deviation of their log-normal length.", false,
+                       {{ std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Read length mean must be a positive number." },
+                        { std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Read length standard deviation must be a positive number." }} );
+        parser.option( "Long reads", "-ll", "-llengths", "Empirical read length distribution file (one 'length [weight]' per line).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Long reads", "-lc", "-lchimera", "Rate of chimeric long reads (0 <= x <= 1).", false,
+                       {{ std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Chimera rate should be between 0-1 inclusive.", "0" }} );
+        //Duplicates
+        parser.option( "Duplicates", "-du", "-duplicates", "Rate of duplicate reads sequencing a recent fragment again (0 <= x <= 1).", false,
+                       {{ std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Duplicate rate should be between 0-1 inclusive.", "0" }} );
+        parser.option( "Duplicates", "-dm", "-dmutation", "Per-base substitution rate added to the duplicates (0 <= x <= 1).", false,
+                       {{ std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Mutation rate should be between 0-1 inclusive.", "0" }} );
+        parser.option( "Duplicates", "-dr", "-dreservoir", "Number of recent fragments duplicates are drawn from.", false,
+                       {{ std::regex( "^[1-9][0-9]*$" ), "Reservoir size must be a positive integer.", "1024" }} );
+        //Ground truth
+        parser.option( "Truth", "-tr", "-truth", "Name of the binary ground truth file to create (read origins and errors).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Truth", "-ct", "-covtrack", "Name of the binary per-base coverage track to create (run-length encoded).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Truth", "-bg", "-bedgraph", "Name of the bedGraph of the per-base coverage to create.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        //Target regions
+        parser.option( "Targets", "-tg", "-targets", "BED file of the target regions reads are taken from (capture panel, exome).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Targets", "-to", "-offtarget", "Fraction of the reads taken from outside the target regions (0 <= x < 1).", false,
+                       {{ std::regex( "^0$|^0\\.[0-9]+$" ), "Off-target rate should be between 0-1 (exclusive).", "0" }} );
+        //Coverage bias
+        parser.option( "Coverage bias", "-gc", "-gcbias", "GC bias with the GC fraction of the highest coverage and the spread of the curve.", false,
+                       {{ std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "GC peak should be between 0-1 inclusive." },
+                        { std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "GC spread must be a positive number." }} );
+        parser.option( "Coverage bias", "-od", "-overdisp", "Overdispersion of the coverage (variance of the Gamma window weights).", false,
+                       {{ std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Overdispersion must be a positive number.", "0" }} );
+        parser.option( "Coverage bias", "-bw", "-biaswindow", "Size of the windows the coverage bias is worked out on (bases).", false,
+                       {{ std::regex( "^[1-9][0-9]*$" ), "Window size must be a positive integer.", "1000" }} );
+        //Coverage target
+        parser.option( "Coverage target", "-cv", "-coverage", "Stops once a fraction of the genome has a minimum coverage (the depth -d is the cap).", false,
+                       {{ std::regex( "^[1-9][0-9]*$" ), "Minimum coverage must be an integer between 1-255." },
+                        { std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Covered fraction should be between 0-1 inclusive." }} );
+        //Output order
+        parser.option( "Output order", "-or", "-order", "Order the reads are written in (generated, random, coordinate).", false,
+                       {{ std::regex( "^generated$|^random$|^coordinate$", std::regex::icase ), "Order must be either \'generated\', \'random\' or \'coordinate\'", "generated" }} );
+        parser.option( "Output order", "-mem", "-memory", "Memory for the reads held for sorting before going to disk (bytes, or with a K, M or G suffix).", false,
+                       {{ std::regex( "^[1-9][0-9]*[kKmMgG]?$" ), "Memory size must be a positive integer with an optional K, M or G suffix.", "1G" }} );
+        parser.option( "Output order", "-tmp", "-tmpdir", "Directory of the temporary files (default: next to the sequencer file).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid directory name." }} );
+        parser.option( "Output order", "-di", "-depthindex", "Name of the index of where each depth milestone ends in the output (random order).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Output order", "-ds", "-depthstep", "Depth between two milestones of the depth index.", false,
+                       {{ std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Depth step must be a positive number.", "1" }} );
+        //Several read sets in one pass
+        parser.option( "Read sets", "-sp", "-specs", "File of read set specifications (one line of sequencer options per read set).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Read sets", "-th", "-threads", "Number of read sets generated at the same time (0: one per core).", false,
+                       {{ std::regex( "^[0-9]+$" ), "Number of threads must be a positive integer.", "0" }} );
+        //Extra outputs of the same reads
+        parser.option( "Extra outputs", "-xa", "-xfasta", "Name of a FASTA copy of the reads to create (written in the same pass).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Extra outputs", "-xq", "-xfastq", "Name of a FASTQ copy of the reads to create (FASTQ reads only).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Extra outputs", "-xp", "-xpacked", "Name of a packed copy of the reads to create (2 bits per base).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Extra outputs", "-ca", "-cfasta", "Name of the FASTA file of the error-free reads to create.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Extra outputs", "-cq", "-cfastq", "Name of the FASTQ file of the error-free reads to create (FASTQ reads only).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Extra outputs", "-cp", "-cpacked", "Name of the packed file of the error-free reads to create.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
         //Example block
         parser.addExampleLine( "(a) Just a synthetic genome file of 100,000,000 bytes (100MB)\n"
                                    "    with the RNA letter set:" );
@@ -55,6 +165,32 @@ void genomeMaker::cli::setupOptions( char **argv, const std::string &program_tit
                                    "    of 100 000 bytes and a sequencer file 'my_file.fasta' with reads\n"
                                    "    of 10 characters and a depth of 5:" );
         parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -p my_file -s 100000 -l 10 -d 5" );
+        parser.addExampleLine( "(d) FASTQ sequencer file 'reads.fastq' with 100 long reads, a depth\n"
+                                   "    of 30 and binned qualities decaying from 38 to 25:" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -q reads.fastq -l 100 -d 30 -qd 38 25 -qb on" );
+        parser.addExampleLine( "(e) Paired-end reads of 150 characters from fragments of 400 +/- 50\n"
+                                   "    written to 'reads_1.fastq' and 'reads_2.fastq':" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -q reads_1.fastq -m2 reads_2.fastq -l 150 -d 30 -pe 400 50" );
+        parser.addExampleLine( "(f) Reads from both strands with their ground truth, checked and\n"
+                                   "    exported to SAM afterwards:" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -f reads.fasta -d 10 -st both -tr reads.truth" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " verify -g genome -f reads.fasta -tr reads.truth" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " export -tr reads.truth -o reads.sam -x sam -g genome" );
+        parser.addExampleLine( "(g) Long reads with log-normal lengths of 15 000 +/- 8 000 (up to\n"
+                                   "    200 000) at a depth of 20 with 1% of chimeras:" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -q long.fastq -l 200000 -d 20 -lr 15000 8000 -lc 0.01" );
+        parser.addExampleLine( "(h) Reads from the targets of 'panel.bed' at a depth of 200 with\n"
+                                   "    20% of the reads falling outside of them:" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -q panel.fastq -l 150 -d 200 -tg panel.bed -to 0.2" );
+        parser.addExampleLine( "(i) Reads with a GC bias peaking at 45% GC and overdispersed coverage:" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -f reads.fasta -l 150 -d 30 -gc 0.45 0.1 -od 0.2" );
+        parser.addExampleLine( "(j) All the read sets described in 'runs.txt' (e.g. a line with\n"
+                                   "    '-q short.fastq -l 150 -d 30' and another with '-q long.fastq\n"
+                                   "    -d 10 -lr 15000 8000') from a single pass over the genome:" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -sp runs.txt -th 4" );
+        parser.addExampleLine( "(k) FASTQ reads with a FASTA copy and their error-free twin (FASTA\n"
+                                   "    and packed) rendered in the same pass:" );
+        parser.addExampleLine( "    " + std::string( argv[ 0 ] ) + " -g genome -q reads.fastq -l 150 -d 30 -e 0.1 -xa reads.fasta -ca clean.fasta -cp clean.pk" );
     } catch( std::regex_error e ) {
         std::cerr << "Error: Malformed regular expression for Parser::option(..)." << std::endl;
         throw e;
@@ -106,7 +242,435 @@ void genomeMaker::cli::loadOptionsIntoContainer( const eadlib::cli::Parser &pars
     if( parser.getValueFlags( "-depth" ).at( 0 ) ) {
         options._read_depth = converter.string_to_type<unsigned>( parser.getValues( "-depth" ).at( 0 ) );
     }
+    if( parser.getValueFlags( "-tiling" ).at( 0 ) ) {
+        options._tile_stride = converter.string_to_type<size_t>( parser.getValues( "-tiling" ).at( 0 ) );
+    }
+    if( parser.getValueFlags( "-topup" ).at( 0 ) ) {
+        options._read_depth = converter.string_to_type<unsigned>( parser.getValues( "-topup" ).at( 0 ) );
+        options._top_up     = true;
+    }
     if( parser.getValueFlags( "-error" ).at( 0 ) ) {
         options._error_rate = converter.string_to_type<double>( parser.getValues( "-error" ).at( 0 ) );
     }
-}
\ No newline at end of file
+    if( parser.getValueFlags( "-strand" ).at( 0 ) ) {
+        std::string val = parser.getValues( "-strand" ).at( 0 );
+        std::transform( val.begin(), val.end(), val.begin(), ::tolower );
+        options._both_strands = ( val == "both" );
+    }
+    if( parser.getValueFlags( "-ioblock" ).at( 0 ) ) {
+        options._io_block = toByteSize( parser.getValues( "-ioblock" ).at( 0 ) );
+    }
+    if( parser.getValueFlags( "-seed" ).at( 0 ) ) {
+        options._seed = converter.string_to_type<uint64_t>( parser.getValues( "-seed" ).at( 0 ) );
+    }
+    //Per-base error model
+    if( parser.getValueFlags( "-erates" ).at( 0 ) ) {
+        options._substitution_rate = converter.string_to_type<double>( parser.getValues( "-erates" ).at( 0 ) );
+        options._insertion_rate    = converter.string_to_type<double>( parser.getValues( "-erates" ).at( 1 ) );
+        options._deletion_rate     = converter.string_to_type<double>( parser.getValues( "-erates" ).at( 2 ) );
+    }
+    if( parser.getValueFlags( "-eramp" ).at( 0 ) ) {
+        options._error_ramp = converter.string_to_type<double>( parser.getValues( "-eramp" ).at( 0 ) );
+    }
+    if( parser.getValueFlags( "-eprofile" ).at( 0 ) ) {
+        options._error_profile = parser.getValues( "-eprofile" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-ematrix" ).at( 0 ) ) {
+        options._error_matrix = parser.getValues( "-ematrix" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-ehotspots" ).at( 0 ) ) {
+        options._error_hotspots = parser.getValues( "-ehotspots" ).at( 0 );
+    }
+    //Paired reads
+    if( parser.getValueFlags( "-paired" ).at( 0 ) ) {
+        options._pairing     = FileOptions::Pairing::PAIRED_END;
+        options._insert_mean = converter.string_to_type<double>( parser.getValues( "-paired" ).at( 0 ) );
+        options._insert_sd   = converter.string_to_type<double>( parser.getValues( "-paired" ).at( 1 ) );
+    }
+    if( parser.getValueFlags( "-matepair" ).at( 0 ) ) {
+        if( options._pairing != FileOptions::Pairing::SINGLE ) {
+            std::cerr << "Error: Paired-end and mate-pair options cannot be used together." << std::endl;
+            throw std::invalid_argument( "Both paired-end and mate-pair options given." );
+        }
+        options._pairing     = FileOptions::Pairing::MATE_PAIR;
+        options._insert_mean = converter.string_to_type<double>( parser.getValues( "-matepair" ).at( 0 ) );
+        options._insert_sd   = converter.string_to_type<double>( parser.getValues( "-matepair" ).at( 1 ) );
+    }
+    if( parser.getValueFlags( "-mates" ).at( 0 ) ) {
+        options._mate_file = parser.getValues( "-mates" ).at( 0 );
+    }
+    //Long reads
+    if( parser.getValueFlags( "-longreads" ).at( 0 ) ) {
+        options._long_reads = true;
+        options._long_mean  = converter.string_to_type<double>( parser.getValues( "-longreads" ).at( 0 ) );
+        options._long_sd    = converter.string_to_type<double>( parser.getValues( "-longreads" ).at( 1 ) );
+    }
+    if( parser.getValueFlags( "-llengths" ).at( 0 ) ) {
+        options._long_reads   = true;
+        options._long_lengths = parser.getValues( "-llengths" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-lchimera" ).at( 0 ) ) {
+        options._chimera_rate = converter.string_to_type<double>( parser.getValues( "-lchimera" ).at( 0 ) );
+    }
+    //Duplicates
+    if( parser.getValueFlags( "-duplicates" ).at( 0 ) ) {
+        options._duplicate_rate = converter.string_to_type<double>( parser.getValues( "-duplicates" ).at( 0 ) );
+    }
+    if( parser.getValueFlags( "-dmutation" ).at( 0 ) ) {
+        options._mutation_rate = converter.string_to_type<double>( parser.getValues( "-dmutation" ).at( 0 ) );
+    }
+    if( parser.getValueFlags( "-dreservoir" ).at( 0 ) ) {
+        options._reservoir_size = converter.string_to_type<size_t>( parser.getValues( "-dreservoir" ).at( 0 ) );
+    }
+    if( options._long_reads && !parser.getValueFlags( "-length" ).at( 0 ) ) { //read length is the upper limit in long read mode
+        options._read_length = 1000000;
+    }
+    if( options._long_reads && !parser.getValueFlags( "-erates" ).at( 0 ) ) { //indel dominated errors of long read platforms
+        options._substitution_rate = 0.01;
+        options._insertion_rate    = 0.02;
+        options._deletion_rate     = 0.02;
+    }
+    //FASTQ output
+    if( parser.getValueFlags( "-fastq" ).at( 0 ) ) {
+        options._sequencer_file = parser.getValues( "-fastq" ).at( 0 );
+        options._sequencer_flag = true;
+        options._read_format    = FileOptions::ReadFormat::FASTQ;
+    }
+    if( parser.getValueFlags( "-qprofile" ).at( 0 ) ) {
+        options._quality_profile = parser.getValues( "-qprofile" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-qdecay" ).at( 0 ) ) {
+        options._quality_start = converter.string_to_type<unsigned>( parser.getValues( "-qdecay" ).at( 0 ) );
+        options._quality_end   = converter.string_to_type<unsigned>( parser.getValues( "-qdecay" ).at( 1 ) );
+    }
+    if( parser.getValueFlags( "-qbinning" ).at( 0 ) ) {
+        std::string val = parser.getValues( "-qbinning" ).at( 0 );
+        std::transform( val.begin(), val.end(), val.begin(), ::tolower );
+        options._quality_binning = ( val == "on" );
+    }
+    //Ground truth
+    if( parser.getValueFlags( "-truth" ).at( 0 ) ) {
+        options._truth_file = parser.getValues( "-truth" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-covtrack" ).at( 0 ) ) {
+        options._track_file = parser.getValues( "-covtrack" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-bedgraph" ).at( 0 ) ) {
+        options._bedgraph_file = parser.getValues( "-bedgraph" ).at( 0 );
+    }
+    //Target regions
+    if( parser.getValueFlags( "-targets" ).at( 0 ) ) {
+        options._target_file = parser.getValues( "-targets" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-offtarget" ).at( 0 ) ) {
+        options._off_target_rate = converter.string_to_type<double>( parser.getValues( "-offtarget" ).at( 0 ) );
+    }
+    //Coverage bias
+    if( parser.getValueFlags( "-gcbias" ).at( 0 ) ) {
+        options._gc_bias = true;
+        options._gc_peak = converter.string_to_type<double>( parser.getValues( "-gcbias" ).at( 0 ) );
+        options._gc_sd   = converter.string_to_type<double>( parser.getValues( "-gcbias" ).at( 1 ) );
+    }
+    if( parser.getValueFlags( "-overdisp" ).at( 0 ) ) {
+        options._overdispersion = converter.string_to_type<double>( parser.getValues( "-overdisp" ).at( 0 ) );
+    }
+    if( parser.getValueFlags( "-biaswindow" ).at( 0 ) ) {
+        options._bias_window = converter.string_to_type<size_t>( parser.getValues( "-biaswindow" ).at( 0 ) );
+    }
+    //Coverage target
+    if( parser.getValueFlags( "-coverage" ).at( 0 ) ) {
+        options._min_coverage     = converter.string_to_type<unsigned>( parser.getValues( "-coverage" ).at( 0 ) );
+        options._covered_fraction = converter.string_to_type<double>( parser.getValues( "-coverage" ).at( 1 ) );
+    }
+    //Output order
+    if( parser.getValueFlags( "-order" ).at( 0 ) ) {
+        std::string val = parser.getValues( "-order" ).at( 0 );
+        std::transform( val.begin(), val.end(), val.begin(), ::tolower );
+        if( val == "random" ) {
+            options._read_order = FileOptions::ReadOrder::RANDOM;
+        } else if( val == "coordinate" ) {
+            options._read_order = FileOptions::ReadOrder::COORDINATE;
+        } else {
+            options._read_order = FileOptions::ReadOrder::GENERATED;
+        }
+    }
+    if( parser.getValueFlags( "-memory" ).at( 0 ) ) {
+        options._memory_limit = toByteSize( parser.getValues( "-memory" ).at( 0 ) );
+    }
+    if( parser.getValueFlags( "-tmpdir" ).at( 0 ) ) {
+        options._temp_dir = parser.getValues( "-tmpdir" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-depthindex" ).at( 0 ) ) {
+        options._depth_index = parser.getValues( "-depthindex" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-depthstep" ).at( 0 ) ) {
+        options._depth_step = converter.string_to_type<double>( parser.getValues( "-depthstep" ).at( 0 ) );
+    }
+    //Extra outputs
+    const std::vector<std::pair<std::string, FileOptions::ExtraOutput>> extra_outputs {
+        { "-xfasta",  { "", FileOptions::ExtraFormat::FASTA,  false } },
+        { "-xfastq",  { "", FileOptions::ExtraFormat::FASTQ,  false } },
+        { "-xpacked", { "", FileOptions::ExtraFormat::PACKED, false } },
+        { "-cfasta",  { "", FileOptions::ExtraFormat::FASTA,  true } },
+        { "-cfastq",  { "", FileOptions::ExtraFormat::FASTQ,  true } },
+        { "-cpacked", { "", FileOptions::ExtraFormat::PACKED, true } }
+    };
+    for( const auto &extra_output : extra_outputs ) {
+        if( parser.getValueFlags( extra_output.first ).at( 0 ) ) {
+            options._extra_outputs.emplace_back( extra_output.second );
+            options._extra_outputs.back()._file_name = parser.getValues( extra_output.first ).at( 0 );
+        }
+    }
+    //Read sets
+    if( parser.getValueFlags( "-specs" ).at( 0 ) ) {
+        options._spec_file = parser.getValues( "-specs" ).at( 0 );
+    }
+    if( parser.getValueFlags( "-threads" ).at( 0 ) ) {
+        options._threads = converter.string_to_type<size_t>( parser.getValues( "-threads" ).at( 0 ) );
+    }
+}
+
+/**
+ * Takes the options the reads depend on from the saved ones of an earlier run unless given
+ * Note: a top-up only needs the sequencer file and the new depth. The genome is inherited by
+ *       the read set specifications so it is taken when not set rather than when not given.
+ * @param parser  Parser
+ * @param saved   Options of the earlier run(s)
+ * @param options Option container
+ */
+void genomeMaker::cli::loadTopUpDefaults( const eadlib::cli::Parser &parser, const FileOptions &saved, FileOptions &options ) {
+    if( options._genome_file.empty() ) {
+        options._genome_file = saved._genome_file;
+    }
+    if( !parser.isSet( "-seed" ) ) {
+        options._seed = saved._seed;
+    }
+    if( !parser.isSet( "-length" ) ) {
+        options._read_length = saved._read_length;
+    }
+    if( !parser.isSet( "-tiling" ) ) {
+        options._tile_stride = saved._tile_stride;
+    }
+    if( !parser.isSet( "-error" ) ) {
+        options._error_rate = saved._error_rate;
+    }
+    if( !parser.isSet( "-strand" ) ) {
+        options._both_strands = saved._both_strands;
+    }
+    //Per-base error model
+    if( !parser.isSet( "-erates" ) ) {
+        options._substitution_rate = saved._substitution_rate;
+        options._insertion_rate    = saved._insertion_rate;
+        options._deletion_rate     = saved._deletion_rate;
+    }
+    if( !parser.isSet( "-eramp" ) ) {
+        options._error_ramp = saved._error_ramp;
+    }
+    if( !parser.isSet( "-eprofile" ) ) {
+        options._error_profile = saved._error_profile;
+    }
+    if( !parser.isSet( "-ematrix" ) ) {
+        options._error_matrix = saved._error_matrix;
+    }
+    if( !parser.isSet( "-ehotspots" ) ) {
+        options._error_hotspots = saved._error_hotspots;
+    }
+    //Paired reads
+    if( !parser.isSet( "-paired" ) && !parser.isSet( "-matepair" ) ) {
+        options._pairing     = saved._pairing;
+        options._insert_mean = saved._insert_mean;
+        options._insert_sd   = saved._insert_sd;
+    }
+    if( !parser.isSet( "-mates" ) ) {
+        options._mate_file = saved._mate_file;
+    }
+    //Long reads
+    if( !parser.isSet( "-longreads" ) && !parser.isSet( "-llengths" ) ) {
+        options._long_reads   = saved._long_reads;
+        options._long_mean    = saved._long_mean;
+        options._long_sd      = saved._long_sd;
+        options._long_lengths = saved._long_lengths;
+    }
+    if( !parser.isSet( "-lchimera" ) ) {
+        options._chimera_rate = saved._chimera_rate;
+    }
+    //Duplicates
+    if( !parser.isSet( "-duplicates" ) ) {
+        options._duplicate_rate = saved._duplicate_rate;
+    }
+    if( !parser.isSet( "-dmutation" ) ) {
+        options._mutation_rate = saved._mutation_rate;
+    }
+    if( !parser.isSet( "-dreservoir" ) ) {
+        options._reservoir_size = saved._reservoir_size;
+    }
+    //Ground truth and target regions
+    if( !parser.isSet( "-truth" ) ) {
+        options._truth_file = saved._truth_file;
+    }
+    if( !parser.isSet( "-targets" ) ) {
+        options._target_file = saved._target_file;
+    }
+    if( !parser.isSet( "-offtarget" ) ) {
+        options._off_target_rate = saved._off_target_rate;
+    }
+    //Coverage bias
+    if( !parser.isSet( "-gcbias" ) ) {
+        options._gc_bias = saved._gc_bias;
+        options._gc_peak = saved._gc_peak;
+        options._gc_sd   = saved._gc_sd;
+    }
+    if( !parser.isSet( "-overdisp" ) ) {
+        options._overdispersion = saved._overdispersion;
+    }
+    if( !parser.isSet( "-biaswindow" ) ) {
+        options._bias_window = saved._bias_window;
+    }
+    //Output order and qualities
+    if( !parser.isSet( "-order" ) ) {
+        options._read_order = saved._read_order;
+    }
+    if( !parser.isSet( "-qprofile" ) ) {
+        options._quality_profile = saved._quality_profile;
+    }
+    if( !parser.isSet( "-qdecay" ) ) {
+        options._quality_start = saved._quality_start;
+        options._quality_end   = saved._quality_end;
+    }
+    if( !parser.isSet( "-qbinning" ) ) {
+        options._quality_binning = saved._quality_binning;
+    }
+}
+
+/**
+ * Loads up the cli options of the 'verify' command
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @param parser        Parser
+ */
+void genomeMaker::cli::setupVerifyOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser ) {
+    try {
+        parser.addTitleLine( std::string( "=================" + program_title + "=================" ));
+        parser.addDescriptionLine( "Checks every read of a sequencer file against the genome\n"
+                                       "using the ground truth file written with it." );
+        parser.addDescriptionLine( "\nUsage:" + program_name + " verify -<option> <argument>" );
+        parser.option( "Verify", "-g", "-genome", "Name of the genome file the reads were taken from.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Verify", "-f", "-reads", "Name of the sequencer file to check (FASTA or FASTQ).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Verify", "-m2", "-mates", "Name of the mate #2 file (when the mates are not interleaved).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Verify", "-tr", "-truth", "Name of the ground truth file.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.addExampleLine( "    " + program_name + " verify -g genome -f reads.fasta -tr reads.truth" );
+    } catch( std::regex_error e ) {
+        std::cerr << "Error: Malformed regular expression for Parser::option(..)." << std::endl;
+        throw e;
+    }
+}
+
+/**
+ * Loads up the cli options of the 'export' command
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @param parser        Parser
+ */
+void genomeMaker::cli::setupExportOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser ) {
+    try {
+        parser.addTitleLine( std::string( "=================" + program_title + "=================" ));
+        parser.addDescriptionLine( "Exports a ground truth file to TSV or to SAM alignments." );
+        parser.addDescriptionLine( "\nUsage:" + program_name + " export -<option> <argument>" );
+        parser.option( "Export", "-tr", "-truth", "Name of the ground truth file.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Export", "-o", "-output", "Name of the file to create.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Export", "-x", "-format", "Export format (tsv, sam).", false,
+                       {{ std::regex( "^tsv$|^sam$", std::regex::icase ), "Format must be either \'tsv\' or \'sam\'", "tsv" }} );
+        parser.option( "Export", "-g", "-genome", "Genome file to fill in the SAM read sequences from (optional).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.addExampleLine( "    " + program_name + " export -tr reads.truth -o reads.sam -x sam -g genome" );
+    } catch( std::regex_error e ) {
+        std::cerr << "Error: Malformed regular expression for Parser::option(..)." << std::endl;
+        throw e;
+    }
+}
+/**
+ * Loads up the cli options of the 'subsample' command
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @param parser        Parser
+ */
+void genomeMaker::cli::setupSubsampleOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser ) {
+    try {
+        parser.addTitleLine( std::string( "=================" + program_title + "=================" ));
+        parser.addDescriptionLine( "Keeps a fraction of the reads of an existing FASTA/FASTQ file\n"
+                                       "(either given or worked out from a target depth)." );
+        parser.addDescriptionLine( "\nUsage:" + program_name + " subsample -<option> <argument>" );
+        parser.option( "Subsample", "-f", "-reads", "Name of the sequencer file to subsample (FASTA or FASTQ).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Subsample", "-m2", "-mates", "Name of the mate #2 file (when the mates are not interleaved).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Subsample", "-o", "-output", "Name of the subsampled file to create.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Subsample", "-o2", "-output2", "Name of the subsampled mate #2 file to create.", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Subsample", "-fr", "-fraction", "Fraction of the reads to keep (0 <= x <= 1).", false,
+                       {{ std::regex( "^[0-1]$|^0\\.[0-9]+$" ), "Fraction should be between 0-1 inclusive." }} );
+        parser.option( "Subsample", "-d", "-depth", "Target depth of the subsampled reads (needs -s or -g).", false,
+                       {{ std::regex( "^[0-9]+(\\.[0-9]+)?$" ), "Depth must be a positive number." }} );
+        parser.option( "Subsample", "-s", "-size", "Size of the genome in bytes (for -d).", false,
+                       {{ std::regex( "[0-9]+" ), "Size value must be integer." }} );
+        parser.option( "Subsample", "-g", "-genome", "Genome file the size is taken from (for -d).", false,
+                       {{ std::regex( "^(.*/)?(?:$|(.+?)(?:(\\.[^.]*$)|$))+" ), "Invalid filename." }} );
+        parser.option( "Subsample", "-sd", "-seed", "Seed of the read selection.", false,
+                       {{ std::regex( "^[0-9]+$" ), "Seed must be a positive integer.", "0" }} );
+        parser.option( "Subsample", "-th", "-threads", "Number of threads parsing the files (0: one per core).", false,
+                       {{ std::regex( "^[0-9]+$" ), "Number of threads must be a positive integer.", "0" }} );
+        parser.addExampleLine( "    " + program_name + " subsample -f reads.fastq -o reads_10x.fastq -d 10 -g genome" );
+        parser.addExampleLine( "    " + program_name + " subsample -f r_1.fastq -m2 r_2.fastq -o s_1.fastq -o2 s_2.fastq -fr 0.25" );
+    } catch( std::regex_error e ) {
+        std::cerr << "Error: Malformed regular expression for Parser::option(..)." << std::endl;
+        throw e;
+    }
+}
+
+/**
+ * Loads up the cli options of the 'read' command (the sequencer options plus the read number)
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @param parser        Parser
+ */
+void genomeMaker::cli::setupReadOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser ) {
+    try {
+        std::string command = program_name + " read";
+        char *argv[] = { &command[ 0 ] };
+        setupOptions( argv, program_title, parser );
+        parser.addDescriptionLine( "\n'read' generates a single read of a simulation on its own\n"
+                                       "(same options and seed as the run) with its truth." );
+        parser.option( "Read", "-ix", "-index", "Number of the read to generate (n in its name 'read#n').", false,
+                       {{ std::regex( "^[1-9][0-9]*$" ), "Read number must be a positive integer." }} );
+        parser.addExampleLine( "    " + program_name + " read -g genome -f reads.fasta -d 30 -sd 7 -ix 123456" );
+    } catch( std::regex_error e ) {
+        std::cerr << "Error: Malformed regular expression for Parser::option(..)." << std::endl;
+        throw e;
+    }
+}
+
+/**
+ * Converts a size given in bytes or with a K, M or G suffix (e.g. '64M')
+ * @param value Size string (checked beforehand by the parser)
+ * @return Size in bytes
+ */
+size_t genomeMaker::cli::toByteSize( std::string value ) {
+    auto converter = eadlib::tool::Convert();
+    size_t shift { 0 };
+    switch( ::tolower( value.back() ) ) {
+        case 'k': shift = 10; break;
+        case 'm': shift = 20; break;
+        case 'g': shift = 30; break;
+    }
+    if( shift > 0 ) {
+        value.pop_back();
+    }
+    return converter.string_to_type<size_t>( value ) << shift;
+}
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 #include "eadlib/cli/parser/Parser.h"
 #include "eadlib/tool/Convert.h"
@@ -13,6 +14,12 @@ namespace genomeMaker {
     namespace cli {
         void setupOptions( char **argv, const std::string &program_title, eadlib::cli::Parser &parser );
         void loadOptionsIntoContainer( const eadlib::cli::Parser &parser, FileOptions &options );
+        void loadTopUpDefaults( const eadlib::cli::Parser &parser, const FileOptions &saved, FileOptions &options );
+        void setupVerifyOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser );
+        void setupExportOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser );
+        void setupSubsampleOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser );
+        void setupReadOptions( const std::string &program_name, const std::string &program_title, eadlib::cli::Parser &parser );
+        size_t toByteSize( std::string value );
     }
 }
 
@@ -2,6 +2,7 @@
 #define GENOMEMAKER_FILEOPTION_H
 
 #include <string>
+#include <vector>
 
 namespace genomeMaker {
     struct FileOptions {
@@ -19,7 +20,103 @@ namespace genomeMaker {
         std::string _sequencer_file { "" };
         size_t      _read_length    { 260 };
         unsigned    _read_depth     { 0 };
+        size_t      _tile_stride    { 0 };
         double      _error_rate     { 0 };
+        bool        _both_strands   { false };
+        size_t      _io_block       { 1 << 26 };
+        uint64_t    _seed           { 0 };
+        enum class ReadFormat {
+            FASTA,
+            FASTQ
+        } _read_format { ReadFormat::FASTA };
+
+        //Per-base error model
+        double      _substitution_rate { 0 };
+        double      _insertion_rate    { 0 };
+        double      _deletion_rate     { 0 };
+        double      _error_ramp        { 1 };
+        std::string _error_profile     { "" };
+        std::string _error_matrix      { "" };
+        std::string _error_hotspots    { "" };
+
+        //Paired reads
+        enum class Pairing {
+            SINGLE,
+            PAIRED_END,
+            MATE_PAIR
+        } _pairing { Pairing::SINGLE };
+        double      _insert_mean    { 0 };
+        double      _insert_sd      { 0 };
+        std::string _mate_file      { "" };
+
+        //Long reads
+        bool        _long_reads     { false };
+        double      _long_mean      { 0 };
+        double      _long_sd        { 0 };
+        std::string _long_lengths   { "" };
+        double      _chimera_rate   { 0 };
+
+        //Duplicates (PCR/optical)
+        double      _duplicate_rate { 0 };
+        double      _mutation_rate  { 0 };
+        size_t      _reservoir_size { 1024 };
+
+        //Ground truth of the reads
+        std::string _truth_file     { "" };
+        std::string _track_file     { "" };
+        std::string _bedgraph_file  { "" };
+
+        //Target regions
+        std::string _target_file     { "" };
+        double      _off_target_rate { 0 };
+
+        //Coverage bias
+        bool        _gc_bias         { false };
+        double      _gc_peak         { 0.5 };
+        double      _gc_sd           { 0 };
+        double      _overdispersion  { 0 };
+        size_t      _bias_window     { 1000 };
+
+        //Coverage target (read depth as the cap)
+        unsigned    _min_coverage     { 0 };
+        double      _covered_fraction { 0 };
+
+        //Output order of the reads
+        enum class ReadOrder {
+            GENERATED,
+            RANDOM,
+            COORDINATE
+        } _read_order { ReadOrder::GENERATED };
+        size_t      _memory_limit   { 1 << 30 };
+        std::string _temp_dir       { "" };
+        std::string _depth_index    { "" };
+        double      _depth_step     { 1 };
+
+        //Top-up of the reads of an earlier run (read depth as the new depth)
+        bool        _top_up         { false };
+
+        //Read sets generated in the same genome pass
+        std::string _spec_file      { "" };
+        size_t      _threads        { 0 };
+
+        //Quality model (FASTQ output)
+        std::string _quality_profile { "" };
+        unsigned    _quality_start   { 40 };
+        unsigned    _quality_end     { 20 };
+        bool        _quality_binning { false };
+
+        //Extra outputs of the same reads (written in the same pass)
+        enum class ExtraFormat {
+            FASTA,
+            FASTQ,
+            PACKED
+        };
+        struct ExtraOutput {
+            std::string _file_name;
+            ExtraFormat _format;
+            bool        _clean; //error-free reads
+        };
+        std::vector<ExtraOutput> _extra_outputs;
     };
 }
 
@@ -0,0 +1,83 @@
+#ifndef GENOMEMAKER_READSET_H
+#define GENOMEMAKER_READSET_H
+
+#include <memory>
+
+#include "eadlib/io/FileWriter.h"
+
+#include "FileOptions.h"
+#include "../tools/GenomeWindow.h"
+#include "../tools/ErrorModel.h"
+#include "../tools/ErrorHotspots.h"
+#include "../tools/QualityModel.h"
+#include "../tools/FragmentModel.h"
+#include "../tools/LengthModel.h"
+#include "../tools/TruthWriter.h"
+#include "../tools/TargetRegions.h"
+#include "../tools/CoverageBias.h"
+#include "../tools/CoverageTarget.h"
+#include "../tools/CoverageTrack.h"
+#include "../tools/ReadSorter.h"
+#include "../tools/DepthIndex.h"
+#include "../tools/ReadSink.h"
+#include "../tools/SequencerSim.h"
+#include "../tools/RunState.h"
+
+namespace genomeMaker {
+    //Everything a sequencer simulation writes to or samples from (one per read set specification)
+    struct ReadSet {
+        ReadSet( const FileOptions &options, GenomeWindow &genome ) :
+            _options( options ),
+            _writer( options._sequencer_file ),
+            _mate_writer( options._mate_file ),
+            _truth_file( options._truth_file ),
+            _truth_writer( _truth_file ),
+            _track_file( options._track_file ),
+            _bedgraph_file( options._bedgraph_file ),
+            _error_model( options._substitution_rate, options._insertion_rate, options._deletion_rate ),
+            _quality_model( options._quality_binning ),
+            _fragment_model( options._pairing == FileOptions::Pairing::MATE_PAIR
+                             ? FragmentModel::Library::MATE_PAIR
+                             : FragmentModel::Library::PAIRED_END,
+                             options._insert_mean,
+                             options._insert_sd ),
+            _sorter( _writer, runPrefix( options ), options._memory_limit ),
+            _depth_file( options._depth_index ),
+            _depth_index( _depth_file, options._depth_step ),
+            _sequencer( genome, _writer )
+        {}
+        //Prefix of the sorter's run files (in the temporary directory when given)
+        static std::string runPrefix( const FileOptions &options ) {
+            const std::string &file = options._sequencer_file;
+            if( options._temp_dir.empty() ) {
+                return file + ".run";
+            }
+            const size_t slash = file.find_last_of( '/' );
+            return options._temp_dir + "/" + ( slash == std::string::npos ? file : file.substr( slash + 1 ) ) + ".run";
+        }
+        FileOptions            _options;
+        eadlib::io::FileWriter _writer;
+        eadlib::io::FileWriter _mate_writer;
+        eadlib::io::FileWriter _truth_file;
+        TruthWriter            _truth_writer;
+        eadlib::io::FileWriter _track_file;
+        eadlib::io::FileWriter _bedgraph_file;
+        ErrorModel             _error_model;
+        ErrorHotspots          _error_hotspots;
+        QualityModel           _quality_model;
+        FragmentModel          _fragment_model;
+        LengthModel            _length_model;
+        TargetRegions          _target_regions;
+        CoverageBias           _coverage_bias;
+        CoverageTarget         _coverage_target;
+        CoverageTrack          _coverage_track;
+        ReadSorter             _sorter;
+        eadlib::io::FileWriter _depth_file;
+        DepthIndex             _depth_index;
+        std::vector<std::unique_ptr<ReadSink>> _sinks; //extra outputs (own writer threads)
+        SequencerSim           _sequencer;
+        RunState               _run_state; //state of the earlier run(s) when topping up
+    };
+}
+
+#endif //GENOMEMAKER_READSET_H
@@ -0,0 +1,20 @@
+#ifndef GENOMEMAKER_RENDEREDREADS_H
+#define GENOMEMAKER_RENDEREDREADS_H
+
+#include <string>
+#include <vector>
+
+namespace genomeMaker {
+    //Records rendered once and shared by the sinks of a run, one column per field (read-only once handed over)
+    struct RenderedReads {
+        std::vector<uint64_t> _numbers;    //read number
+        std::vector<uint8_t>  _mates;      //0: single read, 1/2: mate
+        std::vector<size_t>   _ends;       //end of each record in _sequences (and _qualities)
+        std::vector<size_t>   _clean_ends; //end of each record in _clean
+        std::string           _sequences;  //sequences with their errors, back to back (when a sink takes them)
+        std::string           _qualities;  //qualities of the sequences (FASTQ reads)
+        std::string           _clean;      //error-free sequences (when a sink takes them)
+    };
+}
+
+#endif //GENOMEMAKER_RENDEREDREADS_H
@@ -0,0 +1,22 @@
+#ifndef GENOMEMAKER_TRUTHRECORD_H
+#define GENOMEMAKER_TRUTHRECORD_H
+
+#include <vector>
+#include <cstdint>
+
+#include "../tools/ErrorModel.h"
+
+namespace genomeMaker {
+    struct TruthRecord {
+        uint64_t                       _position      { 0 };     //leftmost genome position of the read's template
+        bool                           _reverse       { false }; //read taken from the reverse strand
+        uint8_t                        _mate          { 0 };     //0: single read, 1/2: mate number, 3: chimeric segment
+        uint32_t                       _length        { 0 };     //length of the read
+        uint32_t                       _adapter_bases { 0 };     //template bases read past the fragment (adapter read-through)
+        std::vector<ErrorModel::Error> _errors;                  //errors in read coordinates (in position order)
+        uint64_t                       _read          { 0 };     //read number (0 when the truth file does not store it)
+        uint64_t                       _duplicate     { 0 };     //number of the read whose fragment this one duplicates (0: none)
+    };
+}
+
+#endif //GENOMEMAKER_TRUTHRECORD_H
@@ -1,4 +1,9 @@
 #include <iostream>
+#include <sstream>
+#include <memory>
+#include <set>
+#include <algorithm>
+#include <thread>
 
 #include "eadlib/logger/Logger.h"
 #include "eadlib/cli/parser/Parser.h"
@@ -8,7 +13,18 @@
 #include "containers/FileOptions.h"
 #include "cli/cli.h"
 #include "tools/GenomeCreator.h"
+#include "containers/ReadSet.h"
 #include "tools/SequencerSim.h"
+#include "tools/SequencerPool.h"
+#include "tools/GenomeWindow.h"
+#include "tools/TruthWriter.h"
+#include "tools/TruthReader.h"
+#include "tools/TruthVerifier.h"
+#include "tools/TruthExporter.h"
+#include "tools/RecordParser.h"
+#include "tools/MappedFile.h"
+#include "tools/Subsampler.h"
+#include "tools/RunState.h"
 
 namespace genomeMaker {
     bool checkGenomeOptions( genomeMaker::FileOptions &option_container );
@@ -16,7 +32,20 @@ namespace genomeMaker {
     void printGenomeOptions( const genomeMaker::FileOptions &option_container );
     void printSequencerOptions( const genomeMaker::FileOptions &option_container );
     bool existFileConflicts( const genomeMaker::FileOptions &option_container );
+    bool existReadSetConflicts( const std::vector<genomeMaker::FileOptions> &read_specs );
+    bool loadReadSpecs( const genomeMaker::FileOptions &option_container, const std::string &program_title, std::vector<genomeMaker::FileOptions> &read_specs );
+    bool loadTopUp( const eadlib::cli::Parser &parser, genomeMaker::FileOptions &option_container );
+    bool loadReadSet( genomeMaker::ReadSet &read_set, size_t &read_length );
+    bool startReadSet( genomeMaker::ReadSet &read_set );
+    bool saveRunState( const genomeMaker::ReadSet &read_set );
     std::streampos getFileSize( const std::string &file_name );
+    bool loadQualityModel( const genomeMaker::FileOptions &option_container, const size_t &profile_length, genomeMaker::QualityModel &quality_model );
+    bool loadErrorModel( const genomeMaker::FileOptions &option_container, const size_t &profile_length, genomeMaker::ErrorModel &error_model );
+    bool loadLengthModel( const genomeMaker::FileOptions &option_container, genomeMaker::LengthModel &length_model );
+    int verifyReads( int argc, char *argv[], const std::string &program_name, const std::string &program_title );
+    int exportTruth( int argc, char *argv[], const std::string &program_name, const std::string &program_title );
+    int subsampleReads( int argc, char *argv[], const std::string &program_name, const std::string &program_title );
+    int generateRead( int argc, char *argv[], const std::string &program_name, const std::string &program_title );
 }
 
 /**
@@ -30,16 +59,43 @@ int main( int argc, char *argv[] ) {
     std::string s;
     s = std::string( *argv );
     try {
+        //Commands working on existing files
+        if( argc > 1 && std::string( argv[ 1 ] ) == "verify" ) {
+            return genomeMaker::verifyReads( argc - 1, argv + 1, s, GENOMEMAKER_DESC );
+        }
+        if( argc > 1 && std::string( argv[ 1 ] ) == "export" ) {
+            return genomeMaker::exportTruth( argc - 1, argv + 1, s, GENOMEMAKER_DESC );
+        }
+        if( argc > 1 && std::string( argv[ 1 ] ) == "subsample" ) {
+            return genomeMaker::subsampleReads( argc - 1, argv + 1, s, GENOMEMAKER_DESC );
+        }
+        if( argc > 1 && std::string( argv[ 1 ] ) == "read" ) {
+            return genomeMaker::generateRead( argc - 1, argv + 1, s, GENOMEMAKER_DESC );
+        }
         auto parser = eadlib::cli::Parser();
         genomeMaker::cli::setupOptions( argv, GENOMEMAKER_DESC, parser );
         if( parser.parse( argc, argv ) ) {
             auto option_container = genomeMaker::FileOptions();
             genomeMaker::cli::loadOptionsIntoContainer( parser, option_container );
-            if( !option_container._genome_flag && !option_container._sequencer_flag ) {
+            if( option_container._top_up && option_container._sequencer_flag && !genomeMaker::loadTopUp( parser, option_container ) ) {
+                return -1;
+            }
+            //Read sets (command line one first then any from the specification file)
+            auto read_specs = std::vector<genomeMaker::FileOptions>();
+            if( option_container._sequencer_flag ) {
+                read_specs.emplace_back( option_container );
+            }
+            if( !option_container._spec_file.empty() && !genomeMaker::loadReadSpecs( option_container, GENOMEMAKER_DESC, read_specs ) ) {
+                return -1;
+            }
+            if( option_container._genome_file.empty() && !read_specs.empty() ) { //top-ups take it from their run state
+                option_container._genome_file = read_specs.front()._genome_file;
+            }
+            if( !option_container._genome_flag && read_specs.empty() ) {
                 std::cerr << "Error: Not enough options supplied to do anything." << std::endl;
                 return -1;
             }
-            if( genomeMaker::existFileConflicts( option_container ) ) {
+            if( genomeMaker::existFileConflicts( option_container ) || genomeMaker::existReadSetConflicts( read_specs ) ) {
                 return -1;
             }
 
@@ -75,38 +131,57 @@ int main( int argc, char *argv[] ) {
             //////////////////////////////////
             // Sequencer simulation section //
             //////////////////////////////////
-            if( option_container._sequencer_flag ) {
+            if( !read_specs.empty() ) {
                 std::cout << "===| sequencer simulation |===" << std::endl;
-                if( !genomeMaker::checkSequencerOptions( option_container ) ) {
-                    return -1;
+                for( auto &read_spec : read_specs ) {
+                    if( !genomeMaker::checkSequencerOptions( read_spec ) ) {
+                        return -1;
+                    }
                 }
-                //Error control on opening streams to the genome and new sequencer files
-                eadlib::io::FileReader reader( option_container._genome_file );
-                if( !reader.open() ) {
-                    LOG_ERROR( "[main(..)] FileReader had a problem opening stream to genome file input '", reader.getFileName(), "'." );
+                //Error control on opening the stream to the genome shared by all the read sets
+                //(mapped when tiling so reads are copied straight from the genome into the outputs)
+                const bool tiling = std::any_of( read_specs.begin(), read_specs.end(),
+                                                 []( const genomeMaker::FileOptions &spec ) { return spec._tile_stride > 0; } );
+                eadlib::io::FileReader  reader( option_container._genome_file );
+                genomeMaker::MappedFile genome_file( tiling ? option_container._genome_file : "" );
+                auto genome = option_container._genome_file == "-" //genome piped in on stdin
+                              ? genomeMaker::GenomeWindow( std::cin, "stdin", option_container._io_block )
+                              : tiling
+                                ? genomeMaker::GenomeWindow( genome_file, option_container._io_block )
+                                : genomeMaker::GenomeWindow( reader, option_container._io_block );
+                if( !genome.open() ) {
+                    LOG_ERROR( "[main(..)] FileReader had a problem opening stream to genome file input '", genome.getFileName(), "'." );
                     std::cerr << "Error: FileReader had problem opening stream to genome file input. For more see the log." << std::endl;
                     return -1;
                 }
-                eadlib::io::FileWriter writer( option_container._sequencer_file );
-                if( !writer.open() ) {
-                    LOG_ERROR( "[main(..)] FileWriter had a problem opening stream to sequencer file output '", writer.getFileName(), "'." );
-                    std::cerr << "Error: FileWriter had problem opening stream to sequencer file output. For more see the log." << std::endl;
-                    return -1;
+                const size_t threads = option_container._threads > 0
+                                       ? option_container._threads
+                                       : std::max( std::thread::hardware_concurrency(), 1u );
+                auto pool      = genomeMaker::SequencerPool( genome, threads );
+                auto read_sets = std::vector<std::unique_ptr<genomeMaker::ReadSet>>();
+                for( auto &read_spec : read_specs ) {
+                    //Printing info
+                    genomeMaker::printSequencerOptions( read_spec );
+                    read_sets.emplace_back( new genomeMaker::ReadSet( read_spec, genome ) );
+                    if( !genomeMaker::startReadSet( *read_sets.back() ) ) {
+                        return -1;
+                    }
+                    pool.add( read_sets.back()->_sequencer );
                 }
-                //Creating Randomiser objects
-                auto read_randomiser  = genomeMaker::Randomiser();
-                auto error_randomiser = genomeMaker::Randomiser();
-                //Printing info
-                genomeMaker::printSequencerOptions( option_container );
                 //Simulating sequencer reads...
-                auto sequencer = genomeMaker::SequencerSim( reader,
-                                                            writer,
-                                                            read_randomiser,
-                                                            error_randomiser );
-                sequencer.start( option_container._read_length,
-                                 option_container._read_depth,
-                                 option_container._error_rate );
-                std::cout << "-> Sequencer reads file created." << std::endl;
+                if( read_sets.size() > 1 ) {
+                    std::cout << "-> " << read_sets.size() << " read sets on " << std::min( threads, read_sets.size() ) << " thread(s)." << std::endl;
+                }
+                std::cout << "...Starting..." << std::endl;
+                if( !pool.run() ) {
+                    return -1;
+                }
+                for( const auto &read_set : read_sets ) {
+                    if( !genomeMaker::saveRunState( *read_set ) ) {
+                        return -1;
+                    }
+                }
+                std::cout << "-> Sequencer reads file(s) created." << std::endl;
             }
             std::cout << "-> Finished." << std::endl;
         }
@@ -137,19 +212,121 @@ bool genomeMaker::checkGenomeOptions( genomeMaker::FileOptions &option_container
  */
 bool genomeMaker::checkSequencerOptions( genomeMaker::FileOptions &option_container ) {
     try {
-        if( option_container._read_depth < 1 ) { //No read depth given or 0
+        if( option_container._tile_stride > 0 ) { //depth given by the stride
+            if( option_container._read_depth > 0 ) {
+                std::cout << "-> Both a read depth (-d/-tu) and a tiling stride (-tl) were given. Aborting." << std::endl;
+                return false;
+            }
+            if( !option_container._target_file.empty() || option_container._gc_bias || option_container._overdispersion > 0
+                || option_container._min_coverage > 0 || option_container._genome_file == "-" ) {
+                std::cout << "-> Tiling (-tl) cannot be used with target regions, coverage bias, coverage targets or a streamed genome. Aborting." << std::endl;
+                return false;
+            }
+        } else if( option_container._read_depth < 1 ) { //No read depth given or 0
             std::cout << "-> No read depth was given." << std::endl;
             return false;
         }
-        if( option_container._read_length < 1 || option_container._read_length > 1000 ) {
+        if( option_container._read_length < 1 || option_container._read_length > 1000000 ) {
             std::cout << "-> Invalid read length (" << option_container._read_length << ") given.";
-            std::cout << " Must be between 1-1000 inc. Aborting." << std::endl;
+            std::cout << " Must be between 1-1000000 inc. Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._long_reads && option_container._pairing != FileOptions::Pairing::SINGLE ) {
+            std::cout << "-> Long reads cannot be paired (-pe/-mp). Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._long_reads && !option_container._long_lengths.empty() && option_container._long_mean > 0 ) {
+            std::cout << "-> Both a log-normal (-lr) and an empirical (-ll) length distribution were given. Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._chimera_rate > 0 && !option_container._long_reads ) {
+            std::cout << "-> A chimera rate was given without long reads (-lr/-ll). Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._mutation_rate > 0 && option_container._duplicate_rate <= 0 ) {
+            std::cout << "-> A mutation rate was given without duplicates (-du). Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._off_target_rate > 0 && option_container._target_file.empty() ) {
+            std::cout << "-> An off-target rate was given without target regions (-tg). Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._gc_bias && option_container._gc_sd <= 0 ) {
+            std::cout << "-> Invalid GC bias spread (" << option_container._gc_sd << ") given. Must be above 0. Aborting." << std::endl;
+            return false;
+        }
+        if( ( option_container._gc_bias || option_container._overdispersion > 0 ) && !option_container._target_file.empty() ) {
+            std::cout << "-> A coverage bias (-gc/-od) cannot be used with target regions (-tg). Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._min_coverage > 255 ) {
+            std::cout << "-> Invalid minimum coverage (" << option_container._min_coverage << ") given. Must be between 1-255. Aborting." << std::endl;
             return false;
         }
+        if( option_container._min_coverage > 0 && !option_container._target_file.empty() ) {
+            std::cout << "-> A coverage target (-cv) cannot be used with target regions (-tg). Aborting." << std::endl;
+            return false;
+        }
+        if( !option_container._depth_index.empty() && option_container._read_order != FileOptions::ReadOrder::RANDOM ) {
+            std::cout << "-> A depth index (-di) needs the reads in random order (-or random). Aborting." << std::endl;
+            return false;
+        }
+        if( !option_container._depth_index.empty() && option_container._depth_step <= 0 ) {
+            std::cout << "-> Invalid depth step (" << option_container._depth_step << ") given. Must be above 0. Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._top_up && option_container._read_order == FileOptions::ReadOrder::COORDINATE ) {
+            std::cout << "-> A top-up (-tu) cannot be appended to reads in coordinate order (-or coordinate). Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._top_up && ( !option_container._track_file.empty() || !option_container._bedgraph_file.empty()
+                                          || !option_container._depth_index.empty() || option_container._min_coverage > 0 ) ) {
+            std::cout << "-> A top-up (-tu) cannot be used with coverage tracks, depth indices or coverage targets. Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._top_up && option_container._genome_file == "-" ) {
+            std::cout << "-> A top-up (-tu) needs a genome file (not '-'). Aborting." << std::endl;
+            return false;
+        }
+        if( !option_container._extra_outputs.empty() ) {
+            const bool sorted = option_container._read_order == FileOptions::ReadOrder::RANDOM
+                                || ( option_container._read_order == FileOptions::ReadOrder::COORDINATE
+                                     && option_container._pairing != FileOptions::Pairing::SINGLE );
+            if( sorted || option_container._top_up ) {
+                std::cout << "-> Extra outputs cannot be used with a top-up (-tu) or reads sorted once generated (-or). Aborting." << std::endl;
+                return false;
+            }
+            for( const auto &extra_output : option_container._extra_outputs ) {
+                if( extra_output._format == FileOptions::ExtraFormat::FASTQ && option_container._read_format != FileOptions::ReadFormat::FASTQ ) {
+                    std::cout << "-> FASTQ extra outputs (-xq/-cq) need FASTQ reads (-q). Aborting." << std::endl;
+                    return false;
+                }
+            }
+        }
         if( option_container._error_rate < 0 || option_container._error_rate > 1 ) {
             std::cout << "-> Invalid error rate. Must be between 0-1 inc. Aborting." << std::endl;
             return false;
         }
+        if( option_container._substitution_rate + option_container._insertion_rate + option_container._deletion_rate > 1 ) {
+            std::cout << "-> Invalid per-base error rates. Their sum must be between 0-1 inc. Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._pairing != FileOptions::Pairing::SINGLE && option_container._insert_mean < 1 ) {
+            std::cout << "-> Invalid fragment size (" << option_container._insert_mean << ") given. Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._pairing == FileOptions::Pairing::SINGLE && !option_container._mate_file.empty() ) {
+            std::cout << "-> A mate file was given without paired reads (-pe/-mp). Aborting." << std::endl;
+            return false;
+        }
+        if( option_container._genome_file == "-" ) { //size only known at the end of the stream
+            if( !option_container._target_file.empty() || option_container._gc_bias || option_container._overdispersion > 0
+                || option_container._min_coverage > 0 ) {
+                std::cout << "-> Target regions, coverage bias and coverage targets need a genome file (not '-'). Aborting." << std::endl;
+                return false;
+            }
+            return true;
+        }
         std::streampos genome_file_size = genomeMaker::getFileSize( option_container._genome_file );
         if( genome_file_size < 1 ) {
             std::cerr << "Error: Genome file looks empty. Aborting." << std::endl;
@@ -190,9 +367,108 @@ void genomeMaker::printGenomeOptions( const genomeMaker::FileOptions &option_con
 void genomeMaker::printSequencerOptions( const genomeMaker::FileOptions &option_container ) {
     std::cout << "-> Sequencer file options: " << std::endl;
     std::cout << "\tRead file : " << option_container._sequencer_file << std::endl;
-    std::cout << "\tRead depth: " << option_container._read_depth << std::endl;
-    std::cout << "\tRead size : " << option_container._read_length << std::endl;
+    if( option_container._tile_stride > 0 ) {
+        std::cout << "\tTiling    : every " << option_container._tile_stride << " bases" << std::endl;
+    } else {
+        std::cout << "\tRead depth: " << option_container._read_depth << ( option_container._top_up ? " (top-up)" : "" ) << std::endl;
+    }
+    if( option_container._long_reads ) {
+        if( option_container._long_lengths.empty() ) {
+            std::cout << "\tRead size : " << option_container._long_mean << " +/- " << option_container._long_sd
+                      << " (max " << option_container._read_length << ")" << std::endl;
+        } else {
+            std::cout << "\tRead size : " << option_container._long_lengths << " (max " << option_container._read_length << ")" << std::endl;
+        }
+        if( option_container._chimera_rate > 0 ) {
+            std::cout << "\tChimeras  : " << option_container._chimera_rate << std::endl;
+        }
+    } else {
+        std::cout << "\tRead size : " << option_container._read_length << std::endl;
+    }
     std::cout << "\tError rate: " << option_container._error_rate << std::endl;
+    std::cout << "\tStrand(s) : " << ( option_container._both_strands ? "both" : "forward" ) << std::endl;
+    std::cout << "\tI/O block : " << option_container._io_block << " bytes" << std::endl;
+    if( option_container._read_order != genomeMaker::FileOptions::ReadOrder::GENERATED ) {
+        std::cout << "\tOrder     : "
+                  << ( option_container._read_order == genomeMaker::FileOptions::ReadOrder::RANDOM ? "random" : "coordinate" )
+                  << " (" << option_container._memory_limit << " bytes in memory)" << std::endl;
+    }
+    if( !option_container._depth_index.empty() ) {
+        std::cout << "\tDepth idx : " << option_container._depth_index << " (every " << option_container._depth_step << "x)" << std::endl;
+    }
+    if( option_container._substitution_rate + option_container._insertion_rate + option_container._deletion_rate > 0 ) {
+        std::cout << "\tBase errors: " << option_container._substitution_rate << " sub, "
+                  << option_container._insertion_rate << " ins, "
+                  << option_container._deletion_rate << " del" << std::endl;
+        if( !option_container._error_profile.empty() ) {
+            std::cout << "\tErr profile: " << option_container._error_profile << std::endl;
+        } else if( option_container._error_ramp != 1 ) {
+            std::cout << "\tErr ramp   : x" << option_container._error_ramp << std::endl;
+        }
+    }
+    if( !option_container._error_hotspots.empty() ) {
+        std::cout << "\tHotspots  : " << option_container._error_hotspots << std::endl;
+    }
+    if( option_container._duplicate_rate > 0 ) {
+        std::cout << "\tDuplicates: " << option_container._duplicate_rate << " of the last " << option_container._reservoir_size << " fragments";
+        if( option_container._mutation_rate > 0 ) {
+            std::cout << " (" << option_container._mutation_rate << " mutations)";
+        }
+        std::cout << std::endl;
+    }
+    switch( option_container._pairing ) {
+        case FileOptions::Pairing::SINGLE:
+            break;
+        case FileOptions::Pairing::PAIRED_END:
+            std::cout << "\tPaired-end: " << option_container._insert_mean << " +/- " << option_container._insert_sd << std::endl;
+            break;
+        case FileOptions::Pairing::MATE_PAIR:
+            std::cout << "\tMate-pair : " << option_container._insert_mean << " +/- " << option_container._insert_sd << std::endl;
+            break;
+    }
+    if( !option_container._target_file.empty() ) {
+        std::cout << "\tTargets   : " << option_container._target_file << " (" << option_container._off_target_rate << " off-target)" << std::endl;
+    }
+    if( option_container._gc_bias ) {
+        std::cout << "\tGC bias   : peak " << option_container._gc_peak << " +/- " << option_container._gc_sd
+                  << " (windows of " << option_container._bias_window << ")" << std::endl;
+    }
+    if( option_container._overdispersion > 0 ) {
+        std::cout << "\tOverdisp. : " << option_container._overdispersion << " (windows of " << option_container._bias_window << ")" << std::endl;
+    }
+    if( option_container._min_coverage > 0 ) {
+        std::cout << "\tCoverage  : " << option_container._min_coverage << "x on " << option_container._covered_fraction * 100
+                  << "% of the genome (capped at depth " << option_container._read_depth << ")" << std::endl;
+    }
+    if( option_container._pairing != FileOptions::Pairing::SINGLE ) {
+        std::cout << "\tMate file : " << ( option_container._mate_file.empty() ? "(interleaved)" : option_container._mate_file ) << std::endl;
+    }
+    if( !option_container._truth_file.empty() ) {
+        std::cout << "\tTruth file: " << option_container._truth_file << std::endl;
+    }
+    if( !option_container._track_file.empty() ) {
+        std::cout << "\tCov. track: " << option_container._track_file << std::endl;
+    }
+    if( !option_container._bedgraph_file.empty() ) {
+        std::cout << "\tBedGraph  : " << option_container._bedgraph_file << std::endl;
+    }
+    if( option_container._read_format == FileOptions::ReadFormat::FASTQ ) {
+        std::cout << "\tFormat    : FASTQ" << std::endl;
+        if( option_container._quality_profile.empty() ) {
+            std::cout << "\tQualities : decay " << option_container._quality_start << "->" << option_container._quality_end << std::endl;
+        } else {
+            std::cout << "\tQualities : " << option_container._quality_profile << std::endl;
+        }
+        std::cout << "\tBinning   : " << ( option_container._quality_binning ? "on" : "off" ) << std::endl;
+    } else {
+        std::cout << "\tFormat    : FASTA" << std::endl;
+    }
+    for( const auto &extra_output : option_container._extra_outputs ) {
+        std::cout << "\tExtra out : " << extra_output._file_name << " ("
+                  << ( extra_output._format == FileOptions::ExtraFormat::FASTA ? "FASTA"
+                       : extra_output._format == FileOptions::ExtraFormat::FASTQ ? "FASTQ" : "packed" )
+                  << ( extra_output._clean ? ", error-free" : "" ) << ")" << std::endl;
+    }
 }
 
 /**
@@ -228,18 +504,337 @@ bool genomeMaker::existFileConflicts( const genomeMaker::FileOptions &option_con
                 std::cerr << "Error: Reference genome file doesn't exist. Aborting." << std::endl;
                 return false;
             }
-        } else {
+        } else if( option_container._genome_file != "-" ) { //'-': genome piped in on stdin
             std::cerr << "Error: genome file does not exists. Cannot simulate sequencer on nothing!." << std::endl;
             return true;
         }
-        if( sequencer_file_exists ) {
+        if( sequencer_file_exists && !option_container._top_up ) {
             std::cerr << "Error: sequencer file already exists." << std::endl;
             return true;
         }
     }
+    if( option_container._sequencer_flag && option_container._top_up ) { //reads appended to the ones of the earlier run(s)
+        if( !sequencer_file_exists || access( RunState::fileName( option_container._sequencer_file ).c_str(), F_OK ) == -1 ) {
+            std::cerr << "Error: a top-up needs the sequencer file and its run state ('"
+                      << RunState::fileName( option_container._sequencer_file ) << "')." << std::endl;
+            return true;
+        }
+        return false;
+    }
+    if( option_container._sequencer_flag && !option_container._mate_file.empty() ) {
+        if( access( option_container._mate_file.c_str(), F_OK ) != -1 ) {
+            std::cerr << "Error: mate file already exists." << std::endl;
+            return true;
+        }
+    }
+    if( option_container._sequencer_flag && !option_container._truth_file.empty() ) {
+        if( access( option_container._truth_file.c_str(), F_OK ) != -1 ) {
+            std::cerr << "Error: truth file already exists." << std::endl;
+            return true;
+        }
+    }
+    for( const std::string &file_name : { option_container._track_file, option_container._bedgraph_file, option_container._depth_index } ) {
+        if( option_container._sequencer_flag && !file_name.empty() && access( file_name.c_str(), F_OK ) != -1 ) {
+            std::cerr << "Error: '" << file_name << "' already exists." << std::endl;
+            return true;
+        }
+    }
+    for( const auto &extra_output : option_container._extra_outputs ) {
+        if( option_container._sequencer_flag && access( extra_output._file_name.c_str(), F_OK ) != -1 ) {
+            std::cerr << "Error: '" << extra_output._file_name << "' already exists." << std::endl;
+            return true;
+        }
+    }
     return false;
 }
 
+/**
+ * Checks the read sets for file conflicts and for outputs shared between them
+ * @param read_specs Read set specifications
+ * @return Conflict state
+ */
+bool genomeMaker::existReadSetConflicts( const std::vector<genomeMaker::FileOptions> &read_specs ) {
+    std::set<std::string> outputs;
+    for( const auto &read_spec : read_specs ) {
+        if( existFileConflicts( read_spec ) ) {
+            return true;
+        }
+        if( read_spec._genome_file != read_specs.front()._genome_file ) {
+            std::cerr << "Error: the read sets are not all taken from the same genome." << std::endl;
+            return true;
+        }
+        for( const std::string &file_name : { read_spec._sequencer_file, read_spec._mate_file, read_spec._truth_file,
+                                              read_spec._track_file, read_spec._bedgraph_file, read_spec._depth_index } ) {
+            if( !file_name.empty() && !outputs.insert( file_name ).second ) {
+                std::cerr << "Error: '" << file_name << "' is the output of more than one read set." << std::endl;
+                return true;
+            }
+        }
+        for( const auto &extra_output : read_spec._extra_outputs ) {
+            if( !outputs.insert( extra_output._file_name ).second ) {
+                std::cerr << "Error: '" << extra_output._file_name << "' is given as more than one output." << std::endl;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Loads the read set specifications from the file given in the option container
+ * Each non-empty line that is not a comment ('#') holds the sequencer options of a read set as they
+ * would be given on the command line. The genome, its I/O block and the threads are shared by all
+ * the read sets so they come from the command line.
+ * @param option_container FileOptions container (command line)
+ * @param program_title    Title of the program
+ * @param read_specs       Container for the read set specifications
+ * @return Success
+ */
+bool genomeMaker::loadReadSpecs( const genomeMaker::FileOptions &option_container,
+                                 const std::string &program_title,
+                                 std::vector<genomeMaker::FileOptions> &read_specs ) {
+    eadlib::io::FileReader reader( option_container._spec_file );
+    if( !reader.open() ) {
+        LOG_ERROR( "[genomeMaker::loadReadSpecs( <genomeMaker::FileOptions>, ", program_title, ", <read_specs> )] "
+            "Could not open the read set specification file '", option_container._spec_file, "'." );
+        std::cerr << "Error: could not open the read set specification file." << std::endl;
+        return false;
+    }
+    std::vector<char> line;
+    size_t line_number { 0 };
+    while( !reader.isDone() && reader.readLine( line ) >= 0 ) {
+        line_number++;
+        std::istringstream ss( std::string( line.begin(), line.end() ) );
+        std::vector<std::string> arguments { "genomeMaker" };
+        std::string argument;
+        while( ss >> argument ) {
+            arguments.emplace_back( argument );
+        }
+        if( arguments.size() < 2 || arguments.at( 1 ).front() == '#' ) {
+            continue;
+        }
+        std::vector<char *> argv;
+        for( auto &arg : arguments ) {
+            argv.emplace_back( &arg[ 0 ] );
+        }
+        auto parser    = eadlib::cli::Parser();
+        auto read_spec = genomeMaker::FileOptions();
+        genomeMaker::cli::setupOptions( argv.data(), program_title, parser );
+        if( !parser.parse( static_cast<int>( argv.size() ), argv.data() ) ) {
+            std::cerr << "Error: invalid read set specification on line " << line_number << " of '" << option_container._spec_file << "'." << std::endl;
+            return false;
+        }
+        genomeMaker::cli::loadOptionsIntoContainer( parser, read_spec );
+        if( read_spec._genome_flag || !read_spec._genome_file.empty() || !read_spec._spec_file.empty() ) {
+            std::cerr << "Error: line " << line_number << " of '" << option_container._spec_file
+                      << "' has genome or read set options (only sequencer options are allowed)." << std::endl;
+            return false;
+        }
+        if( !read_spec._sequencer_flag ) {
+            std::cerr << "Error: line " << line_number << " of '" << option_container._spec_file
+                      << "' has no sequencer file to create (-f/-q)." << std::endl;
+            return false;
+        }
+        read_spec._genome_flag = option_container._genome_flag;
+        read_spec._genome_file = option_container._genome_file;
+        read_spec._io_block    = option_container._io_block;
+        read_spec._threads     = option_container._threads;
+        if( read_spec._top_up && !genomeMaker::loadTopUp( parser, read_spec ) ) {
+            return false;
+        }
+        read_specs.emplace_back( read_spec );
+    }
+    if( read_specs.empty() ) {
+        std::cerr << "Error: no read set found in '" << option_container._spec_file << "'." << std::endl;
+        return false;
+    }
+    LOG( "[genomeMaker::loadReadSpecs(..)] Loaded ", read_specs.size(), " read set(s)." );
+    return true;
+}
+
+/**
+ * Loads the options of the earlier run(s) of a top-up from its run state as the defaults of the read set
+ * Note: the options given that differ from the saved ones are listed and the top-up is refused
+ * @param parser           Parser the options were loaded from
+ * @param option_container Options of the read set
+ * @return Success
+ */
+bool genomeMaker::loadTopUp( const eadlib::cli::Parser &parser, genomeMaker::FileOptions &option_container ) {
+    const std::string state_file = RunState::fileName( option_container._sequencer_file );
+    RunState saved_state;
+    auto     saved = option_container;
+    if( !saved_state.load( state_file ) || !saved_state.getParameters( saved ) ) {
+        std::cerr << "Error: could not load the run state '" << state_file << "'. For more see the log." << std::endl;
+        return false;
+    }
+    cli::loadTopUpDefaults( parser, saved, option_container );
+    RunState run_state;
+    run_state.setParameters( option_container );
+    if( !run_state.sameParameters( saved_state ) ) {
+        std::cerr << "Error: a top-up cannot change the options of the earlier run(s) (bar the depth)." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Loads the models of a read set into its sequencer (outputs are left alone)
+ * @param read_set    Read set
+ * @param read_length Output for the longest read length of the set
+ * @return Success
+ */
+bool genomeMaker::loadReadSet( genomeMaker::ReadSet &read_set, size_t &read_length ) {
+    const FileOptions &options   = read_set._options;
+    SequencerSim      &sequencer = read_set._sequencer;
+    read_length = options._read_length;
+    size_t profile_length { options._read_length };
+    if( options._long_reads ) { //profiles span the mean length and hold their last value past it
+        if( !genomeMaker::loadLengthModel( options, read_set._length_model ) ) {
+            return false;
+        }
+        sequencer.setLengthModel( read_set._length_model );
+        sequencer.setChimeraRate( options._chimera_rate );
+        read_length    = read_set._length_model.maxLength();
+        profile_length = static_cast<size_t>( std::round( read_set._length_model.mean() ) );
+    }
+    if( !genomeMaker::loadErrorModel( options, profile_length, read_set._error_model ) ) {
+        return false;
+    }
+    sequencer.setErrorModel( read_set._error_model );
+    if( !options._error_hotspots.empty() ) {
+        if( !read_set._error_hotspots.load( options._error_hotspots ) ) {
+            std::cerr << "Error: could not load the error hotspots from '" << options._error_hotspots << "'. For more see the log." << std::endl;
+            return false;
+        }
+        sequencer.setErrorHotspots( read_set._error_hotspots );
+    }
+    if( options._duplicate_rate > 0 ) {
+        sequencer.setDuplicates( options._duplicate_rate, options._mutation_rate, options._reservoir_size );
+    }
+    sequencer.setStrandSampling( options._both_strands );
+    sequencer.setSeed( options._seed );
+    if( !options._target_file.empty() ) {
+        if( !read_set._target_regions.load( options._target_file ) ) {
+            std::cerr << "Error: could not load the target regions from '" << options._target_file << "'. For more see the log." << std::endl;
+            return false;
+        }
+        sequencer.setTargetRegions( read_set._target_regions, options._off_target_rate );
+    }
+    if( options._gc_bias || options._overdispersion > 0 ) {
+        if( options._gc_bias ) {
+            read_set._coverage_bias.setGCBias( options._gc_peak, options._gc_sd );
+        }
+        read_set._coverage_bias.setOverdispersion( options._overdispersion );
+        read_set._coverage_bias.setWindow( options._bias_window );
+        read_set._coverage_bias.setSeed( options._seed );
+        sequencer.setCoverageBias( read_set._coverage_bias );
+    }
+    if( options._tile_stride > 0 ) {
+        sequencer.setTiling( options._tile_stride );
+    }
+    if( options._min_coverage > 0 ) {
+        sequencer.setCoverageTarget( read_set._coverage_target, options._min_coverage, options._covered_fraction );
+    }
+    if( options._pairing != genomeMaker::FileOptions::Pairing::SINGLE ) {
+        sequencer.setFragmentModel( read_set._fragment_model );
+    }
+    if( options._read_format == genomeMaker::FileOptions::ReadFormat::FASTQ ) {
+        if( !genomeMaker::loadQualityModel( options, profile_length, read_set._quality_model ) ) {
+            return false;
+        }
+        sequencer.setQualityModel( read_set._quality_model );
+    }
+    return true;
+}
+
+/**
+ * Loads the models of a read set, opens its outputs and starts its sequencer
+ * @param read_set Read set
+ * @return Success
+ */
+bool genomeMaker::startReadSet( genomeMaker::ReadSet &read_set ) {
+    const FileOptions &options   = read_set._options;
+    SequencerSim      &sequencer = read_set._sequencer;
+    if( !read_set._writer.open() ) {
+        LOG_ERROR( "[genomeMaker::startReadSet(..)] FileWriter had a problem opening stream to sequencer file output '", read_set._writer.getFileName(), "'." );
+        std::cerr << "Error: FileWriter had problem opening stream to sequencer file output. For more see the log." << std::endl;
+        return false;
+    }
+    size_t read_length { 0 };
+    if( !genomeMaker::loadReadSet( read_set, read_length ) ) {
+        return false;
+    }
+    if( options._top_up ) {
+        const std::string state_file = RunState::fileName( options._sequencer_file );
+        if( !read_set._run_state.load( state_file ) ) {
+            std::cerr << "Error: could not load the run state '" << state_file << "'. For more see the log." << std::endl;
+            return false;
+        }
+        sequencer.setTopUp( read_set._run_state.reads(), read_set._run_state.parts(), read_set._run_state.truthPosition() );
+    }
+    if( !options._truth_file.empty() ) {
+        sequencer.setTruthWriter( read_set._truth_writer );
+    }
+    if( !options._track_file.empty() || !options._bedgraph_file.empty() ) {
+        if( !options._track_file.empty() ) {
+            read_set._coverage_track.setTrackWriter( read_set._track_file );
+        }
+        if( !options._bedgraph_file.empty() ) {
+            read_set._coverage_track.setBedGraphWriter( read_set._bedgraph_file );
+        }
+        sequencer.setCoverageTrack( read_set._coverage_track );
+    }
+    if( options._pairing != genomeMaker::FileOptions::Pairing::SINGLE && !options._mate_file.empty() ) {
+        if( !read_set._mate_writer.open() ) {
+            LOG_ERROR( "[genomeMaker::startReadSet(..)] FileWriter had a problem opening stream to mate file output '", read_set._mate_writer.getFileName(), "'." );
+            std::cerr << "Error: FileWriter had problem opening stream to mate file output. For more see the log." << std::endl;
+            return false;
+        }
+        sequencer.setMateWriter( read_set._mate_writer );
+        read_set._sorter.setMateWriter( read_set._mate_writer );
+    }
+    //Single reads (and chimeras) already come out in the order of their leftmost position
+    const bool sorted = options._read_order == genomeMaker::FileOptions::ReadOrder::COORDINATE
+                        && options._pairing == genomeMaker::FileOptions::Pairing::SINGLE;
+    if( options._read_order != genomeMaker::FileOptions::ReadOrder::GENERATED && !sorted ) {
+        if( !options._truth_file.empty() ) {
+            read_set._sorter.setTruthWriter( read_set._truth_writer );
+        }
+        sequencer.setReadSorter( read_set._sorter,
+                                 options._read_order == genomeMaker::FileOptions::ReadOrder::RANDOM
+                                 ? SequencerSim::SortKey::RANDOM
+                                 : SequencerSim::SortKey::POSITION );
+    }
+    if( !options._depth_index.empty() ) {
+        sequencer.setDepthIndex( read_set._depth_index );
+    }
+    for( const auto &extra_output : options._extra_outputs ) {
+        read_set._sinks.emplace_back( new ReadSink( extra_output._file_name, extra_output._format, extra_output._clean ) );
+        sequencer.addSink( *read_set._sinks.back() );
+    }
+    return sequencer.start( read_length, options._read_depth, options._error_rate );
+}
+
+/**
+ * Saves the run state of a read set next to its sequencer file (what a later top-up carries on from)
+ * @param read_set Read set (sequencer finished)
+ * @return Success
+ */
+bool genomeMaker::saveRunState( const genomeMaker::ReadSet &read_set ) {
+    const std::string state_file = RunState::fileName( read_set._options._sequencer_file );
+    RunState run_state;
+    run_state.setParameters( read_set._options );
+    run_state.setProgress( read_set._sequencer.readsCompleted(),
+                           read_set._run_state.parts() + 1,
+                           read_set._options._read_depth,
+                           read_set._truth_writer.lastPosition() );
+    if( !run_state.save( state_file ) ) {
+        std::cerr << "Error: could not write the run state '" << state_file << "'. For more see the log." << std::endl;
+        return false;
+    }
+    return true;
+}
+
 /**
  * Gets the size of a file
  * @param file_name File name
@@ -255,4 +850,324 @@ std::streampos genomeMaker::getFileSize( const std::string &file_name ) {
     std::streampos cur_end = reader.size();
     reader.close();
     return cur_end;
-}
\ No newline at end of file
+}
+
+/**
+ * Loads the quality model described in the option container
+ * @param option_container FileOptions container
+ * @param profile_length   Read length the decay profile spans
+ * @param quality_model    Quality model to load
+ * @return Success
+ */
+bool genomeMaker::loadQualityModel( const genomeMaker::FileOptions &option_container, const size_t &profile_length, genomeMaker::QualityModel &quality_model ) {
+    if( !option_container._quality_profile.empty() ) {
+        if( !quality_model.loadProfile( option_container._quality_profile ) ) {
+            std::cerr << "Error: Could not load the quality profile '" << option_container._quality_profile << "'. For more see the log." << std::endl;
+            return false;
+        }
+    } else if( !quality_model.createDecayProfile( profile_length,
+                                                  option_container._quality_start,
+                                                  option_container._quality_end ) ) {
+        std::cerr << "Error: Could not create the quality decay profile. For more see the log." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Loads the per-base error model profiles described in the option container
+ * @param option_container FileOptions container
+ * @param profile_length   Read length the error ramp spans
+ * @param error_model      Error model to load
+ * @return Success
+ */
+bool genomeMaker::loadErrorModel( const genomeMaker::FileOptions &option_container, const size_t &profile_length, genomeMaker::ErrorModel &error_model ) {
+    if( !option_container._error_profile.empty() ) {
+        if( !error_model.loadPositionProfile( option_container._error_profile ) ) {
+            std::cerr << "Error: Could not load the error profile '" << option_container._error_profile << "'. For more see the log." << std::endl;
+            return false;
+        }
+    } else {
+        error_model.setPositionRamp( profile_length, option_container._error_ramp );
+    }
+    if( !option_container._error_matrix.empty() && !error_model.loadSubstitutionMatrix( option_container._error_matrix ) ) {
+        std::cerr << "Error: Could not load the substitution matrix '" << option_container._error_matrix << "'. For more see the log." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Loads the long read length model described in the option container
+ * @param option_container FileOptions container
+ * @param length_model     Length model to load
+ * @return Success
+ */
+bool genomeMaker::loadLengthModel( const genomeMaker::FileOptions &option_container, genomeMaker::LengthModel &length_model ) {
+    if( !option_container._long_lengths.empty() ) {
+        if( !length_model.loadDistribution( option_container._long_lengths, option_container._read_length ) ) {
+            std::cerr << "Error: Could not load the read length distribution '" << option_container._long_lengths << "'. For more see the log." << std::endl;
+            return false;
+        }
+    } else if( !length_model.setLogNormal( option_container._long_mean, option_container._long_sd, option_container._read_length ) ) {
+        std::cerr << "Error: Invalid long read length distribution (mean must be between 1 and the read length). For more see the log." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Runs the 'verify' command: checks a sequencer file against the genome using its truth file
+ * @param argc          Number of arguments passed (from the command name)
+ * @param argv          Arguments (from the command name)
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @return Exit code
+ */
+int genomeMaker::verifyReads( int argc, char *argv[], const std::string &program_name, const std::string &program_title ) {
+    auto parser = eadlib::cli::Parser();
+    genomeMaker::cli::setupVerifyOptions( program_name, program_title, parser );
+    if( !parser.parse( argc, argv ) ) {
+        return 0;
+    }
+    if( !parser.getValueFlags( "-genome" ).at( 0 ) || !parser.getValueFlags( "-reads" ).at( 0 ) || !parser.getValueFlags( "-truth" ).at( 0 ) ) {
+        std::cerr << "Error: verify needs a genome (-g), a sequencer file (-f) and a truth file (-tr)." << std::endl;
+        return -1;
+    }
+    genomeMaker::MappedFile  genome( parser.getValues( "-genome" ).at( 0 ) );
+    genomeMaker::MappedFile  reads( parser.getValues( "-reads" ).at( 0 ) );
+    genomeMaker::MappedFile  mates( parser.getValueFlags( "-mates" ).at( 0 ) ? parser.getValues( "-mates" ).at( 0 ) : "" );
+    genomeMaker::TruthReader truth( parser.getValues( "-truth" ).at( 0 ) );
+    if( !genome.open() || !reads.open() || !truth.open() ) {
+        std::cerr << "Error: could not open the genome, sequencer or truth file. For more see the log." << std::endl;
+        return -1;
+    }
+    if( parser.getValueFlags( "-mates" ).at( 0 ) && !mates.open() ) {
+        std::cerr << "Error: could not open the mate file. For more see the log." << std::endl;
+        return -1;
+    }
+    if( truth.genomeSize() > 0 && genome.size() != truth.genomeSize() ) { //0: streamed genome
+        std::cerr << "Error: the genome size (" << genome.size() << ") differs from the one in the truth file ("
+                  << truth.genomeSize() << ")." << std::endl;
+        return -1;
+    }
+    std::cout << "|=========[ " << program_title << " ]=========|\n" << std::endl;
+    std::cout << "===| read verification |===" << std::endl;
+    genomeMaker::RecordParser read_parser( reads.data(), reads.size() );
+    genomeMaker::RecordParser mate_parser( mates.data(), mates.size() );
+    genomeMaker::TruthVerifier verifier( genome, truth );
+    bool verified = verifier.verify( read_parser, mates.isOpen() ? &mate_parser : nullptr );
+    std::cout << "-> Reads checked.: " << verifier.checked() << std::endl;
+    std::cout << "-> Mismatches....: " << verifier.mismatches() << std::endl;
+    std::cout << ( verified ? "-> All reads match their truth records." : "-> Verification failed." ) << std::endl;
+    return verified ? 0 : -1;
+}
+
+/**
+ * Runs the 'export' command: converts a truth file to TSV or SAM
+ * @param argc          Number of arguments passed (from the command name)
+ * @param argv          Arguments (from the command name)
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @return Exit code
+ */
+int genomeMaker::exportTruth( int argc, char *argv[], const std::string &program_name, const std::string &program_title ) {
+    auto parser = eadlib::cli::Parser();
+    genomeMaker::cli::setupExportOptions( program_name, program_title, parser );
+    if( !parser.parse( argc, argv ) ) {
+        return 0;
+    }
+    if( !parser.getValueFlags( "-truth" ).at( 0 ) || !parser.getValueFlags( "-output" ).at( 0 ) ) {
+        std::cerr << "Error: export needs a truth file (-tr) and an output file (-o)." << std::endl;
+        return -1;
+    }
+    const std::string output_file = parser.getValues( "-output" ).at( 0 );
+    if( access( output_file.c_str(), F_OK ) != -1 ) {
+        std::cerr << "Error: output file already exists." << std::endl;
+        return -1;
+    }
+    std::string format = parser.getValueFlags( "-format" ).at( 0 ) ? parser.getValues( "-format" ).at( 0 ) : "tsv";
+    std::transform( format.begin(), format.end(), format.begin(), ::tolower );
+    genomeMaker::TruthReader truth( parser.getValues( "-truth" ).at( 0 ) );
+    if( !truth.open() ) {
+        std::cerr << "Error: could not open the truth file. For more see the log." << std::endl;
+        return -1;
+    }
+    genomeMaker::MappedFile genome( parser.getValueFlags( "-genome" ).at( 0 ) ? parser.getValues( "-genome" ).at( 0 ) : "" );
+    if( parser.getValueFlags( "-genome" ).at( 0 ) && !genome.open() ) {
+        std::cerr << "Error: could not open the genome file. For more see the log." << std::endl;
+        return -1;
+    }
+    eadlib::io::FileWriter writer( output_file );
+    genomeMaker::TruthExporter exporter( truth, writer, genome.isOpen() ? &genome : nullptr );
+    if( !exporter.exportTo( format == "sam" ? genomeMaker::TruthExporter::Format::SAM : genomeMaker::TruthExporter::Format::TSV ) ) {
+        std::cerr << "Error: could not export the truth file. For more see the log." << std::endl;
+        return -1;
+    }
+    std::cout << "-> Exported " << exporter.records() << " records to '" << output_file << "'." << std::endl;
+    return 0;
+}
+
+/**
+ * Runs the 'subsample' command: keeps a fraction of the reads of an existing sequencer file
+ * Note: with a target depth the bases are counted in a first pass to work out the fraction
+ * @param argc          Number of arguments passed (from the command name)
+ * @param argv          Arguments (from the command name)
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @return Exit code
+ */
+int genomeMaker::subsampleReads( int argc, char *argv[], const std::string &program_name, const std::string &program_title ) {
+    auto parser    = eadlib::cli::Parser();
+    auto converter = eadlib::tool::Convert();
+    genomeMaker::cli::setupSubsampleOptions( program_name, program_title, parser );
+    if( !parser.parse( argc, argv ) ) {
+        return 0;
+    }
+    if( !parser.getValueFlags( "-reads" ).at( 0 ) || !parser.getValueFlags( "-output" ).at( 0 ) ) {
+        std::cerr << "Error: subsample needs a sequencer file (-f) and an output file (-o)." << std::endl;
+        return -1;
+    }
+    const bool by_fraction = parser.getValueFlags( "-fraction" ).at( 0 );
+    const bool by_depth    = parser.getValueFlags( "-depth" ).at( 0 );
+    if( by_fraction == by_depth ) {
+        std::cerr << "Error: subsample needs either a fraction (-fr) or a target depth (-d)." << std::endl;
+        return -1;
+    }
+    if( by_depth && !parser.getValueFlags( "-size" ).at( 0 ) && !parser.getValueFlags( "-genome" ).at( 0 ) ) {
+        std::cerr << "Error: a target depth (-d) needs the genome size (-s) or the genome file (-g)." << std::endl;
+        return -1;
+    }
+    if( parser.getValueFlags( "-mates" ).at( 0 ) != parser.getValueFlags( "-output2" ).at( 0 ) ) {
+        std::cerr << "Error: a mate file (-m2) needs its own output file (-o2) and vice versa." << std::endl;
+        return -1;
+    }
+    const std::string output_file = parser.getValues( "-output" ).at( 0 );
+    const std::string mate_output = parser.getValueFlags( "-output2" ).at( 0 ) ? parser.getValues( "-output2" ).at( 0 ) : "";
+    if( access( output_file.c_str(), F_OK ) != -1 || ( !mate_output.empty() && access( mate_output.c_str(), F_OK ) != -1 ) ) {
+        std::cerr << "Error: output file already exists." << std::endl;
+        return -1;
+    }
+    genomeMaker::MappedFile reads( parser.getValues( "-reads" ).at( 0 ) );
+    genomeMaker::MappedFile mates( parser.getValueFlags( "-mates" ).at( 0 ) ? parser.getValues( "-mates" ).at( 0 ) : "" );
+    if( !reads.open() || ( parser.getValueFlags( "-mates" ).at( 0 ) && !mates.open() ) ) {
+        std::cerr << "Error: could not open the sequencer file(s). For more see the log." << std::endl;
+        return -1;
+    }
+    const size_t threads = parser.getValueFlags( "-threads" ).at( 0 ) && converter.string_to_type<size_t>( parser.getValues( "-threads" ).at( 0 ) ) > 0
+                           ? converter.string_to_type<size_t>( parser.getValues( "-threads" ).at( 0 ) )
+                           : std::max( std::thread::hardware_concurrency(), 1u );
+    const uint64_t seed = converter.string_to_type<uint64_t>( parser.getValues( "-seed" ).at( 0 ) );
+    std::cout << "|=========[ " << program_title << " ]=========|\n" << std::endl;
+    std::cout << "===| read subsampling |===" << std::endl;
+    double fraction { 0 };
+    if( by_fraction ) {
+        fraction = converter.string_to_type<double>( parser.getValues( "-fraction" ).at( 0 ) );
+    } else {
+        uint64_t genome_size { 0 };
+        try {
+            genome_size = parser.getValueFlags( "-size" ).at( 0 )
+                          ? converter.string_to_type<uint64_t>( parser.getValues( "-size" ).at( 0 ) )
+                          : static_cast<uint64_t>( genomeMaker::getFileSize( parser.getValues( "-genome" ).at( 0 ) ) );
+        } catch( std::runtime_error e ) {
+            std::cerr << "Error: could not get the size of the genome file." << std::endl;
+            return -1;
+        }
+        auto counter = genomeMaker::Subsampler( 1, seed, threads );
+        uint64_t records { 0 }, bases { 0 }, mate_records { 0 }, mate_bases { 0 };
+        if( !counter.countBases( reads, records, bases ) || ( mates.isOpen() && !counter.countBases( mates, mate_records, mate_bases ) ) ) {
+            std::cerr << "Error: could not parse the sequencer file(s). For more see the log." << std::endl;
+            return -1;
+        }
+        const double depth = static_cast<double>( bases + mate_bases ) / static_cast<double>( std::max( genome_size, (uint64_t) 1 ) );
+        fraction = depth > 0 ? std::min( converter.string_to_type<double>( parser.getValues( "-depth" ).at( 0 ) ) / depth, 1. ) : 1;
+        std::cout << "-> Reads found...: " << records + mate_records << " (" << bases + mate_bases << " bases, depth " << depth << ")" << std::endl;
+        if( fraction >= 1 ) {
+            std::cout << "-> The reads are already below the target depth: keeping them all." << std::endl;
+        }
+    }
+    std::cout << "-> Fraction kept.: " << fraction << std::endl;
+    auto subsampler = genomeMaker::Subsampler( fraction, seed, threads );
+    eadlib::io::FileWriter writer( output_file );
+    eadlib::io::FileWriter mate_writer( mate_output );
+    if( !writer.open() || ( mates.isOpen() && !mate_writer.open() ) ) {
+        std::cerr << "Error: could not create the output file(s). For more see the log." << std::endl;
+        return -1;
+    }
+    if( !subsampler.subsample( reads, writer ) || ( mates.isOpen() && !subsampler.subsample( mates, mate_writer ) ) ) {
+        std::cerr << "Error: could not subsample the sequencer file(s). For more see the log." << std::endl;
+        return -1;
+    }
+    std::cout << "-> Reads kept....: " << subsampler.kept() << "/" << subsampler.seen() << std::endl;
+    return 0;
+}
+
+/**
+ * Runs the 'read' command: generates a single read of a simulation on its own
+ * Note: the read comes out as it does in the sequencer file of a run with the same options
+ *       (and seed). Its truth (origin, strand, errors) follows as '#' lines.
+ * @param argc          Number of arguments passed (from the command name)
+ * @param argv          Arguments (from the command name)
+ * @param program_name  Name of the program executable
+ * @param program_title Title of the program
+ * @return Exit code
+ */
+int genomeMaker::generateRead( int argc, char *argv[], const std::string &program_name, const std::string &program_title ) {
+    auto parser    = eadlib::cli::Parser();
+    auto converter = eadlib::tool::Convert();
+    genomeMaker::cli::setupReadOptions( program_name, program_title, parser );
+    if( !parser.parse( argc, argv ) ) {
+        return 0;
+    }
+    auto option_container = genomeMaker::FileOptions();
+    genomeMaker::cli::loadOptionsIntoContainer( parser, option_container );
+    if( option_container._genome_file.empty() || !parser.getValueFlags( "-index" ).at( 0 ) ) {
+        std::cerr << "Error: read needs a genome (-g) and the number of the read (-ix)." << std::endl;
+        return -1;
+    }
+    if( !genomeMaker::checkSequencerOptions( option_container ) ) {
+        return -1;
+    }
+    if( option_container._min_coverage > 0 ) { //read numbers depend on how the layers merge
+        std::cerr << "Error: reads of a coverage target run (-cv) cannot be generated on their own." << std::endl;
+        return -1;
+    }
+    if( option_container._duplicate_rate > 0 ) { //duplicates come from the fragments of the reads before
+        std::cerr << "Error: reads of a run with duplicates (-du) cannot be generated on their own." << std::endl;
+        return -1;
+    }
+    const uint64_t number = converter.string_to_type<uint64_t>( parser.getValues( "-index" ).at( 0 ) );
+    genomeMaker::MappedFile genome_file( option_container._genome_file );
+    auto genome = genomeMaker::GenomeWindow( genome_file, option_container._io_block );
+    if( !genome.open() ) {
+        std::cerr << "Error: could not open the genome file. For more see the log." << std::endl;
+        return -1;
+    }
+    auto   read_set    = std::unique_ptr<genomeMaker::ReadSet>( new genomeMaker::ReadSet( option_container, genome ) );
+    size_t read_length { 0 };
+    if( !genomeMaker::loadReadSet( *read_set, read_length )
+        || !read_set->_sequencer.prepare( read_length, option_container._read_depth, option_container._error_rate ) ) {
+        return -1;
+    }
+    if( number < 1 || number > read_set->_sequencer.readCount() ) {
+        std::cerr << "Error: read #" << number << " is not in the simulation (1-" << read_set->_sequencer.readCount() << ")." << std::endl;
+        return -1;
+    }
+    std::string record;
+    std::vector<genomeMaker::TruthRecord> truth;
+    if( !read_set->_sequencer.sequenceRead( number, record, truth ) ) {
+        std::cerr << "Error: could not generate read #" << number << ". For more see the log." << std::endl;
+        return -1;
+    }
+    record.append( "#segment\tposition\tstrand\tmate\tlength\tadapter\terrors\n" );
+    for( size_t i = 0; i < truth.size(); i++ ) {
+        record.append( "#" ).append( std::to_string( i + 1 ) ).append( "\t" ).append( std::to_string( truth[ i ]._position ) );
+        record.append( truth[ i ]._reverse ? "\t-\t" : "\t+\t" ).append( std::to_string( truth[ i ]._mate ) );
+        record.append( "\t" ).append( std::to_string( truth[ i ]._length ) );
+        record.append( "\t" ).append( std::to_string( truth[ i ]._adapter_bases ) ).append( "\t" );
+        genomeMaker::TruthExporter::appendErrors( truth[ i ]._errors, record );
+        record.push_back( '\n' );
+    }
+    std::cout << record;
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "BernoulliStream.h"
+
+/**
+ * Constructor
+ * Note: successes are placed by geometric skip-ahead so memory is constant and the cost
+ *       is proportional to the number of successes. Workers can each use their own stream
+ *       (different seed) without any coordination. The countdowns are drawn on demand so
+ *       restarting the stream does not waste a draw on a success that is never reached.
+ * @param probability Probability of success of each trial (0-1)
+ * @param seed        Seed of the stream
+ */
+genomeMaker::BernoulliStream::BernoulliStream( const double &probability, const uint64_t &seed ) :
+    _probability( probability < 0 ? 0 : ( probability > 1 ? 1 : probability ) ),
+    _countdown( 0 ),
+    _drawn( false ),
+    _rng( seed )
+{
+    if( _probability > 0 && _probability < 1 ) {
+        _geometric = std::geometric_distribution<uint64_t>( _probability );
+    }
+}
+
+/**
+ * Destructor
+ */
+genomeMaker::BernoulliStream::~BernoulliStream() {}
+
+/**
+ * Restarts the stream on the random stream of a key
+ * Note: as the skip-ahead is memoryless, restarting it per item (e.g. per read) keeps the
+ *       trials independent whilst making each item depend on its own key only.
+ * @param key Key of the random stream (see CounterRng::key(..))
+ */
+void genomeMaker::BernoulliStream::reseed( const uint64_t &key ) {
+    _rng.seed( key );
+    _geometric.reset();
+    _drawn = false;
+}
+
+/**
+ * Gets the outcome of the next trial in the stream
+ * @return Success state
+ */
+bool genomeMaker::BernoulliStream::next() {
+    if( !_drawn ) {
+        _countdown = draw();
+        _drawn     = true;
+    }
+    if( _countdown > 0 ) {
+        _countdown--;
+        return false;
+    }
+    _drawn = false;
+    return true;
+}
+
+/**
+ * Gets the number of failed trials before the next success and moves the stream past that success
+ * @return Number of failed trials
+ */
+uint64_t genomeMaker::BernoulliStream::gap() {
+    if( !_drawn ) {
+        return draw();
+    }
+    _drawn = false;
+    return _countdown;
+}
+
+/**
+ * Gets the exact expected number of successes over a number of trials
+ * @param trials Number of trials
+ * @return Expected number of successes
+ */
+double genomeMaker::BernoulliStream::expected( const uint64_t &trials ) const {
+    return _probability * static_cast<double>( trials );
+}
+
+/**
+ * Gets the probability of success of each trial
+ * @return Probability
+ */
+double genomeMaker::BernoulliStream::probability() const {
+    return _probability;
+}
+
+/**
+ * Draws the number of failures before the next success
+ * @return Number of failures
+ */
+uint64_t genomeMaker::BernoulliStream::draw() {
+    if( _probability <= 0 ) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    if( _probability >= 1 ) {
+        return 0;
+    }
+    return _geometric( _rng );
+}
@@ -0,0 +1,31 @@
+#ifndef GENOMEMAKER_BERNOULLISTREAM_H
+#define GENOMEMAKER_BERNOULLISTREAM_H
+
+#include <random>
+#include <limits>
+
+#include "CounterRng.h"
+
+namespace genomeMaker {
+    class BernoulliStream {
+      public:
+        BernoulliStream( const double &probability, const uint64_t &seed = 0 );
+        ~BernoulliStream();
+        void reseed( const uint64_t &key );
+        bool next();
+        uint64_t gap();
+        double expected( const uint64_t &trials ) const;
+        double probability() const;
+
+      private:
+        uint64_t draw();
+        //Private variables
+        double                                _probability;
+        uint64_t                              _countdown; //trials left before the next success
+        bool                                  _drawn;     //countdown is drawn (drawn on demand)
+        CounterRng                            _rng;
+        std::geometric_distribution<uint64_t> _geometric;
+    };
+}
+
+#endif //GENOMEMAKER_BERNOULLISTREAM_H
@@ -0,0 +1,115 @@
+#include "CounterRng.h"
+
+/**
+ * Constructor
+ * Note: the n-th output only depends on the key and n so a stream can be (re)started anywhere
+ *       in O(1). This is what lets any read be generated on its own from its index.
+ * @param key Key of the stream
+ */
+genomeMaker::CounterRng::CounterRng( const uint64_t &key ) :
+    _key( key ),
+    _counter( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::CounterRng::~CounterRng() {}
+
+/**
+ * Restarts the generator on the stream of a key
+ * @param key     Key of the stream
+ * @param counter Number of outputs of the stream to skip (carries on from there)
+ */
+void genomeMaker::CounterRng::seed( const uint64_t &key, const uint64_t &counter ) {
+    _key     = key;
+    _counter = counter;
+}
+
+/**
+ * Gets the number of outputs drawn from the stream so far
+ * @return Counter
+ */
+uint64_t genomeMaker::CounterRng::counter() const {
+    return _counter;
+}
+
+/**
+ * Gets the next 64bit output of the stream
+ * @return Random value
+ */
+genomeMaker::CounterRng::result_type genomeMaker::CounterRng::operator()() {
+    return mix( _key + ++_counter * 0x9E3779B97F4A7C15ULL );
+}
+
+/**
+ * Gets the next outputs of the stream in one go (same values as as many calls to operator())
+ * @param output Output
+ * @param count  Number of outputs
+ */
+void genomeMaker::CounterRng::draw( uint64_t *output, const size_t &count ) {
+    for( size_t i = 0; i < count; i++ ) {
+        output[ i ] = mix( _key + ( _counter + 1 + i ) * 0x9E3779B97F4A7C15ULL );
+    }
+    _counter += count;
+}
+
+/**
+ * Derives the key of a stream from a seed, an index (e.g. read number) and a stream number
+ * @param seed   Seed of the run
+ * @param index  Index of the item the stream is for
+ * @param stream Stream number (to keep different uses of the same index apart)
+ * @return Key
+ */
+uint64_t genomeMaker::CounterRng::key( const uint64_t &seed, const uint64_t &index, const uint64_t &stream ) {
+    return mix( mix( seed ^ ( stream * 0xD1B54A32D192ED03ULL ) ) + index );
+}
+
+/**
+ * Derives the keys of the streams of a run of items in one go (see key(..))
+ * Note: items are independent so the loop is left to the compiler to unroll and vectorise
+ * @param seeds   Seed of each item
+ * @param indices Index of each item
+ * @param count   Number of items
+ * @param stream  Stream number
+ * @param output  Output for the key of each item
+ */
+void genomeMaker::CounterRng::keys( const uint64_t *seeds,
+                                    const uint64_t *indices,
+                                    const size_t &count,
+                                    const uint64_t &stream,
+                                    uint64_t *output ) {
+    const uint64_t salt = stream * 0xD1B54A32D192ED03ULL;
+    for( size_t i = 0; i < count; i++ ) {
+        output[ i ] = mix( mix( seeds[ i ] ^ salt ) + indices[ i ] );
+    }
+}
+
+/**
+ * Draws the first outputs of the streams of several keys in one go
+ * Note: the output is column major, column d holding the (d + 1)-th output of each key's stream
+ * @param keys   Key of each stream
+ * @param count  Number of streams
+ * @param draws  Number of outputs per stream
+ * @param output Output (count * draws values)
+ */
+void genomeMaker::CounterRng::fill( const uint64_t *keys, const size_t &count, const size_t &draws, uint64_t *output ) {
+    for( size_t d = 0; d < draws; d++ ) {
+        const uint64_t step   = ( d + 1 ) * 0x9E3779B97F4A7C15ULL;
+        uint64_t      *column = output + d * count;
+        for( size_t i = 0; i < count; i++ ) {
+            column[ i ] = mix( keys[ i ] + step );
+        }
+    }
+}
+
+/**
+ * Mixes the bits of a value (splitmix64 finaliser)
+ * @param value Value
+ * @return Mixed value
+ */
+uint64_t genomeMaker::CounterRng::mix( uint64_t value ) {
+    value  = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    value  = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBULL;
+    return value ^ ( value >> 31 );
+}
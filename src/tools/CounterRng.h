@@ -0,0 +1,31 @@
+#ifndef GENOMEMAKER_COUNTERRNG_H
+#define GENOMEMAKER_COUNTERRNG_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace genomeMaker {
+    class CounterRng {
+      public:
+        typedef uint64_t result_type;
+        CounterRng( const uint64_t &key = 0 );
+        ~CounterRng();
+        void seed( const uint64_t &key, const uint64_t &counter = 0 );
+        uint64_t counter() const;
+        result_type operator()();
+        void draw( uint64_t *output, const size_t &count );
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return UINT64_MAX; }
+        static uint64_t key( const uint64_t &seed, const uint64_t &index, const uint64_t &stream );
+        static void keys( const uint64_t *seeds, const uint64_t *indices, const size_t &count, const uint64_t &stream, uint64_t *output );
+        static void fill( const uint64_t *keys, const size_t &count, const size_t &draws, uint64_t *output );
+
+      private:
+        static uint64_t mix( uint64_t value );
+        //Private variables
+        uint64_t _key;
+        uint64_t _counter;
+    };
+}
+
+#endif //GENOMEMAKER_COUNTERRNG_H
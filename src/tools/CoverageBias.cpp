@@ -0,0 +1,198 @@
+#include "CoverageBias.h"
+
+const uint64_t genomeMaker::CoverageBias::_WINDOW_STREAM;
+
+/**
+ * Constructor
+ */
+genomeMaker::CoverageBias::CoverageBias() :
+    _gc_bias( false ),
+    _gc_peak( 0.5 ),
+    _gc_sd( 1 ),
+    _dispersion( 0 ),
+    _window( 1000 ),
+    _range( 0 ),
+    _cursor( 0 ),
+    _last( 0 ),
+    _seed( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::CoverageBias::~CoverageBias() {}
+
+/**
+ * Sets a GC bias where the relative coverage of a window follows a gaussian curve of its GC content
+ * @param peak GC fraction with the highest coverage (0 to 1)
+ * @param sd   Standard deviation of the curve (GC fraction)
+ */
+void genomeMaker::CoverageBias::setGCBias( const double &peak, const double &sd ) {
+    _gc_bias = sd > 0;
+    _gc_peak = peak;
+    _gc_sd   = sd;
+}
+
+/**
+ * Sets the overdispersion of the coverage (Gamma-Poisson)
+ * Note: window weights are drawn from a Gamma distribution of mean 1 and variance 'dispersion'
+ *       so the number of reads per window follows a negative binomial instead of a Poisson.
+ * @param dispersion Variance of the window weights (0 for none)
+ */
+void genomeMaker::CoverageBias::setOverdispersion( const double &dispersion ) {
+    _dispersion = std::max( dispersion, 0. );
+}
+
+/**
+ * Sets the size of the windows the weights are worked out on
+ * @param window Window size (bases)
+ */
+void genomeMaker::CoverageBias::setWindow( const size_t &window ) {
+    _window = std::max( window, (size_t) 1 );
+}
+
+/**
+ * Sets the seed the overdispersion weights are drawn from
+ * Note: each window's weight comes from its own stream keyed on the seed and the window so
+ *       replicates with different seeds get independent coverage dips
+ * @param seed Seed of the run
+ */
+void genomeMaker::CoverageBias::setSeed( const uint64_t &seed ) {
+    _seed = seed;
+}
+
+/**
+ * Builds the window weights over the range read starts are drawn from
+ * Note: the genome is scanned once keeping a running GC count (prefix sum) that gets cut at
+ *       each window boundary. Only the prefix sums of the weights are kept.
+ * @param genome_file Genome file name
+ * @param range       Size of the range read starts are drawn from [0, range)
+ * @param io_block    Size of the blocks read from the genome file
+ * @return Success
+ */
+bool genomeMaker::CoverageBias::build( const std::string &genome_file, const uint64_t &range, const size_t &io_block ) {
+    if( range < 1 ) {
+        LOG_ERROR( "[genomeMaker::CoverageBias::build( ", genome_file, ", ", range, ", ", io_block, " )] Empty range." );
+        return false;
+    }
+    const size_t windows = static_cast<size_t>( ( range + _window - 1 ) / _window );
+    std::vector<uint64_t> gc_before( windows + 1, 0 ); //GC count before each window boundary
+    uint64_t scanned { 0 };
+    if( _gc_bias ) {
+        eadlib::io::FileReader reader( genome_file );
+        if( !reader.open() ) {
+            LOG_ERROR( "[genomeMaker::CoverageBias::build( ", genome_file, ", ", range, ", ", io_block, " )] Could not open the genome file." );
+            return false;
+        }
+        bool is_gc[ 256 ] = { false };
+        is_gc[ (unsigned char) 'G' ] = is_gc[ (unsigned char) 'C' ] = true;
+        is_gc[ (unsigned char) 'g' ] = is_gc[ (unsigned char) 'c' ] = true;
+        std::vector<char> block;
+        uint64_t position { 0 }, gc { 0 };
+        size_t   boundary { 1 };
+        while( boundary <= windows && !reader.isDone() ) {
+            const std::streamsize read = reader.read( block, std::max( io_block, (size_t) 1 ) );
+            if( read < 1 ) {
+                break;
+            }
+            for( std::streamsize i = 0; i < read; i++ ) {
+                gc += is_gc[ (unsigned char) block[ i ] ];
+                if( ++position == boundary * _window && boundary <= windows ) {
+                    gc_before[ boundary++ ] = gc;
+                }
+            }
+        }
+        for( ; boundary <= windows; boundary++ ) { //last window runs to the end of the genome
+            gc_before[ boundary ] = gc;
+        }
+        scanned = position;
+    }
+    //Converting to weights
+    std::gamma_distribution<double> gamma( _dispersion > 0 ? 1 / _dispersion : 1, _dispersion > 0 ? _dispersion : 1 );
+    _cumulative.resize( windows );
+    _cumulative.shrink_to_fit();
+    double total { 0 };
+    for( size_t w = 0; w < windows; w++ ) {
+        const uint64_t begin  = w * _window;
+        const uint64_t length = std::min( static_cast<uint64_t>( _window ), range - begin );
+        double weight = static_cast<double>( length );
+        if( _gc_bias ) {
+            const uint64_t bases = std::min( static_cast<uint64_t>( _window ), scanned > begin ? scanned - begin : 1 );
+            weight *= gcWeight( gc_before[ w + 1 ] - gc_before[ w ], bases );
+        }
+        if( _dispersion > 0 ) {
+            CounterRng rng( CounterRng::key( _seed, w, _WINDOW_STREAM ) );
+            gamma.reset();
+            weight *= gamma( rng );
+        }
+        total += weight;
+        _cumulative[ w ] = total;
+    }
+    if( total <= 0 ) {
+        LOG_ERROR( "[genomeMaker::CoverageBias::build( ", genome_file, ", ", range, ", ", io_block, " )] All the window weights are 0." );
+        return false;
+    }
+    _range  = range;
+    _cursor = 0;
+    _last   = 0;
+    LOG( "[genomeMaker::CoverageBias::build( ", genome_file, ", ", range, ", ", io_block, " )] ", windows, " windows of ", _window, " bases." );
+    return true;
+}
+
+/**
+ * Maps a uniform on [0,1) to a read start
+ * Note: ascending uniforms (as drawn by StartStream) walk the windows along so each position
+ *       costs O(1) on average whatever the number of windows. Going back falls back to a
+ *       binary search. Positions are uniform inside a window.
+ * @param u Uniform
+ * @return Read start
+ */
+uint64_t genomeMaker::CoverageBias::map( const double &u ) {
+    const double target = u * _cumulative.back();
+    if( u < _last ) {
+        _cursor = static_cast<size_t>( std::upper_bound( _cumulative.begin(), _cumulative.end(), target ) - _cumulative.begin() );
+    }
+    _last = u;
+    while( _cursor + 1 < _cumulative.size() && _cumulative[ _cursor ] <= target ) {
+        _cursor++;
+    }
+    _cursor = std::min( _cursor, _cumulative.size() - 1 );
+    const double   before = _cursor > 0 ? _cumulative[ _cursor - 1 ] : 0;
+    const double   mass   = _cumulative[ _cursor ] - before;
+    const uint64_t begin  = _cursor * _window;
+    const uint64_t length = std::min( static_cast<uint64_t>( _window ), _range - begin );
+    const uint64_t offset = mass > 0 ? static_cast<uint64_t>( ( target - before ) / mass * static_cast<double>( length ) ) : 0;
+    return begin + std::min( offset, length - 1 );
+}
+
+/**
+ * Gets the weight of a window (relative to the total)
+ * @param window Window index
+ * @return Weight (0 when out of range)
+ */
+double genomeMaker::CoverageBias::weight( const size_t &window ) const {
+    if( window >= _cumulative.size() ) {
+        return 0;
+    }
+    const double before = window > 0 ? _cumulative[ window - 1 ] : 0;
+    return ( _cumulative[ window ] - before ) / _cumulative.back();
+}
+
+/**
+ * Gets the number of windows
+ * @return Number of windows
+ */
+size_t genomeMaker::CoverageBias::windows() const {
+    return _cumulative.size();
+}
+
+/**
+ * Gets the relative coverage of a window from its GC content
+ * @param gc     Number of G/C in the window
+ * @param length Length of the window
+ * @return Weight (1 at the peak)
+ */
+double genomeMaker::CoverageBias::gcWeight( const uint64_t &gc, const uint64_t &length ) const {
+    const double z = ( static_cast<double>( gc ) / static_cast<double>( length ) - _gc_peak ) / _gc_sd;
+    return std::exp( -0.5 * z * z );
+}
@@ -0,0 +1,46 @@
+#ifndef GENOMEMAKER_COVERAGEBIAS_H
+#define GENOMEMAKER_COVERAGEBIAS_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileReader.h"
+
+#include "CounterRng.h"
+
+namespace genomeMaker {
+    class CoverageBias {
+      public:
+        CoverageBias();
+        ~CoverageBias();
+        void setGCBias( const double &peak, const double &sd );
+        void setOverdispersion( const double &dispersion );
+        void setWindow( const size_t &window );
+        void setSeed( const uint64_t &seed );
+        bool build( const std::string &genome_file, const uint64_t &range, const size_t &io_block );
+        uint64_t map( const double &u );
+        size_t windows() const;
+        double weight( const size_t &window ) const;
+
+      private:
+        double gcWeight( const uint64_t &gc, const uint64_t &length ) const;
+        //Private variables
+        static const uint64_t _WINDOW_STREAM = 8; //random stream of each window's weight (see CounterRng::key(..))
+        bool                _gc_bias;
+        double              _gc_peak;
+        double              _gc_sd;
+        double              _dispersion; //variance of the Gamma distributed window weights
+        size_t              _window;
+        uint64_t            _range;
+        std::vector<double> _cumulative; //prefix sums of the window weights
+        size_t              _cursor;     //window the last mapped position fell in
+        double              _last;       //last mapped uniform
+        uint64_t            _seed;
+    };
+}
+
+#endif //GENOMEMAKER_COVERAGEBIAS_H
@@ -0,0 +1,154 @@
+#include "CoverageTarget.h"
+
+const uint64_t genomeMaker::CoverageTarget::_BLOCK_SIZE;
+
+/**
+ * Constructor
+ */
+genomeMaker::CoverageTarget::CoverageTarget() :
+    _blocks( 0 ),
+    _top_bit( 0 ),
+    _min_coverage( 0 ),
+    _genome_size( 0 ),
+    _target( 0 ),
+    _covered( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::CoverageTarget::~CoverageTarget() {}
+
+/**
+ * Builds the coverage tracking over a genome
+ * Note: one byte per genome position plus a Fenwick tree over blocks of positions counting the
+ *       ones still short of the minimum coverage. Blocks with none left are skipped when reads
+ *       are added so the work per read shrinks as the genome gets covered.
+ * @param genome_size  Size of the genome
+ * @param min_coverage Minimum coverage wanted (1-255)
+ * @param fraction     Fraction of the genome positions that need the minimum coverage (0 to 1)
+ * @return Success
+ */
+bool genomeMaker::CoverageTarget::build( const uint64_t &genome_size, const unsigned &min_coverage, const double &fraction ) {
+    if( min_coverage < 1 || min_coverage > 255 || fraction < 0 || fraction > 1 || genome_size < 1 ) {
+        LOG_ERROR( "[genomeMaker::CoverageTarget::build( ", genome_size, ", ", min_coverage, ", ", fraction, " )] Invalid target." );
+        return false;
+    }
+    _min_coverage = static_cast<uint8_t>( min_coverage );
+    _genome_size  = genome_size;
+    _target       = static_cast<uint64_t>( std::ceil( fraction * static_cast<double>( genome_size ) ) );
+    _covered      = 0;
+    _counters.assign( genome_size, 0 );
+    _blocks = static_cast<size_t>( ( genome_size + _BLOCK_SIZE - 1 ) / _BLOCK_SIZE );
+    _fenwick.assign( _blocks + 1, 0 );
+    for( size_t i = 1; i <= _blocks; i++ ) { //linear build
+        const uint64_t begin = ( i - 1 ) * _BLOCK_SIZE;
+        _fenwick[ i ] += static_cast<uint32_t>( std::min( _BLOCK_SIZE, genome_size - begin ) );
+        const size_t parent = i + ( i & ( ~i + 1 ) );
+        if( parent <= _blocks ) {
+            _fenwick[ parent ] += _fenwick[ i ];
+        }
+    }
+    _top_bit = 1;
+    while( _top_bit * 2 <= _blocks ) {
+        _top_bit *= 2;
+    }
+    LOG( "[genomeMaker::CoverageTarget::build(..)] ", _target, "/", genome_size, " positions need a coverage of ", min_coverage, "." );
+    return true;
+}
+
+/**
+ * Adds the coverage of a read
+ * @param begin First genome position covered
+ * @param end   Genome position after the last one covered
+ */
+void genomeMaker::CoverageTarget::add( const uint64_t &begin, const uint64_t &end ) {
+    const uint64_t last = std::min( end, _genome_size );
+    if( begin >= last ) {
+        return;
+    }
+    size_t block = nextUncovered( static_cast<size_t>( begin / _BLOCK_SIZE ) );
+    while( block < _blocks && block * _BLOCK_SIZE < last ) {
+        const uint64_t from = std::max( begin, block * _BLOCK_SIZE );
+        const uint64_t to   = std::min( last, ( block + 1 ) * _BLOCK_SIZE );
+        uint32_t reached { 0 };
+        for( uint64_t i = from; i < to; i++ ) {
+            if( _counters[ i ] < _min_coverage && ++_counters[ i ] == _min_coverage ) {
+                reached++;
+            }
+        }
+        if( reached > 0 ) {
+            removeUncovered( block, reached );
+            _covered += reached;
+        }
+        block = nextUncovered( block + 1 );
+    }
+}
+
+/**
+ * Checks if enough of the genome has the minimum coverage
+ * @return Target met state
+ */
+bool genomeMaker::CoverageTarget::isMet() const {
+    return _covered >= _target;
+}
+
+/**
+ * Gets the number of genome positions with the minimum coverage
+ * @return Number of positions
+ */
+uint64_t genomeMaker::CoverageTarget::coveredBases() const {
+    return _covered;
+}
+
+/**
+ * Gets the fraction of the genome with the minimum coverage
+ * @return Fraction (0 to 1)
+ */
+double genomeMaker::CoverageTarget::coveredFraction() const {
+    return _genome_size > 0 ? static_cast<double>( _covered ) / static_cast<double>( _genome_size ) : 0;
+}
+
+/**
+ * Gets the minimum coverage wanted
+ * @return Coverage
+ */
+unsigned genomeMaker::CoverageTarget::minCoverage() const {
+    return _min_coverage;
+}
+
+/**
+ * Finds the first block from a given one that still has positions short of the minimum coverage
+ * Note: Fenwick descent for the first prefix sum going past the one before the block
+ * @param block Block index (0-based)
+ * @return Block index (number of blocks when there are none)
+ */
+size_t genomeMaker::CoverageTarget::nextUncovered( const size_t &block ) const {
+    if( block >= _blocks ) {
+        return _blocks;
+    }
+    uint64_t before { 0 }; //uncovered positions in the blocks before
+    for( size_t i = block; i > 0; i -= i & ( ~i + 1 ) ) {
+        before += _fenwick[ i ];
+    }
+    size_t   position { 0 };
+    uint64_t sum      { 0 };
+    for( size_t step = _top_bit; step > 0; step >>= 1 ) {
+        if( position + step <= _blocks && sum + _fenwick[ position + step ] <= before ) {
+            position += step;
+            sum      += _fenwick[ position ];
+        }
+    }
+    return position; //0-based index of the block taking the sum past 'before'
+}
+
+/**
+ * Removes positions that reached the minimum coverage from the count of a block
+ * @param block Block index (0-based)
+ * @param count Number of positions
+ */
+void genomeMaker::CoverageTarget::removeUncovered( const size_t &block, const uint32_t &count ) {
+    for( size_t i = block + 1; i <= _blocks; i += i & ( ~i + 1 ) ) {
+        _fenwick[ i ] -= count;
+    }
+}
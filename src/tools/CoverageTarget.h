@@ -0,0 +1,39 @@
+#ifndef GENOMEMAKER_COVERAGETARGET_H
+#define GENOMEMAKER_COVERAGETARGET_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include "eadlib/logger/Logger.h"
+
+namespace genomeMaker {
+    class CoverageTarget {
+      public:
+        CoverageTarget();
+        ~CoverageTarget();
+        bool build( const uint64_t &genome_size, const unsigned &min_coverage, const double &fraction );
+        void add( const uint64_t &begin, const uint64_t &end );
+        bool isMet() const;
+        uint64_t coveredBases() const;
+        double coveredFraction() const;
+        unsigned minCoverage() const;
+
+      private:
+        size_t nextUncovered( const size_t &block ) const;
+        void removeUncovered( const size_t &block, const uint32_t &count );
+        //Private variables
+        static const uint64_t _BLOCK_SIZE = 256; //genome positions per block of the Fenwick tree
+        std::vector<uint8_t>  _counters;  //coverage of each position (saturating at the minimum)
+        std::vector<uint32_t> _fenwick;   //Fenwick tree of the uncovered positions per block (1-based)
+        size_t                _blocks;
+        size_t                _top_bit;   //highest power of 2 <= number of blocks
+        uint8_t               _min_coverage;
+        uint64_t              _genome_size;
+        uint64_t              _target;    //positions that need the minimum coverage
+        uint64_t              _covered;   //positions with the minimum coverage
+    };
+}
+
+#endif //GENOMEMAKER_COVERAGETARGET_H
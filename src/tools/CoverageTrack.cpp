@@ -0,0 +1,197 @@
+#include "CoverageTrack.h"
+
+const std::string genomeMaker::CoverageTrack::_MAGIC = std::string( "GMCOVER\1", 8 );
+
+/**
+ * Constructor
+ * Track file layout:
+ *   header: magic, varint genome name length, genome name
+ *   run   : varint run length, varint coverage (runs cover the genome from its start, in order)
+ * Note: read starts come in ascending order so the coverage is final behind the start of the
+ *       last read drawn. Only the coverage changes (+1 at the start, -1 after the end of each
+ *       segment) of the reads still ahead of it are held, in a heap, and runs are written out
+ *       as the reads go along.
+ */
+genomeMaker::CoverageTrack::CoverageTrack() :
+    _track_writer( nullptr ),
+    _bedgraph_writer( nullptr ),
+    _position( 0 ),
+    _coverage( 0 ),
+    _run_begin( 0 ),
+    _run_coverage( 0 ),
+    _runs( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::CoverageTrack::~CoverageTrack() {}
+
+/**
+ * Sets the writer of the binary run-length encoded track
+ * @param track_writer EADlib File Writer
+ */
+void genomeMaker::CoverageTrack::setTrackWriter( eadlib::io::FileWriter &track_writer ) {
+    _track_writer = &track_writer;
+}
+
+/**
+ * Sets the writer of the bedGraph track
+ * @param bedgraph_writer EADlib File Writer
+ */
+void genomeMaker::CoverageTrack::setBedGraphWriter( eadlib::io::FileWriter &bedgraph_writer ) {
+    _bedgraph_writer = &bedgraph_writer;
+}
+
+/**
+ * Opens the track(s) and writes the header of the binary one
+ * @param genome_name Name of the genome (used as the contig name)
+ * @return Success
+ */
+bool genomeMaker::CoverageTrack::open( const std::string &genome_name ) {
+    for( eadlib::io::FileWriter *writer : { _track_writer, _bedgraph_writer } ) {
+        if( writer && !writer->isOpen() && !writer->open() ) {
+            LOG_ERROR( "[genomeMaker::CoverageTrack::open( ", genome_name, " )] Could not open the coverage track '", writer->getFileName(), "'." );
+            return false;
+        }
+    }
+    _genome_name  = genome_name;
+    _events       = decltype( _events )();
+    _position     = 0;
+    _coverage     = 0;
+    _run_begin    = 0;
+    _run_coverage = 0;
+    _runs         = 0;
+    if( _track_writer ) {
+        _track_buffer.append( _MAGIC );
+        appendVarInt( genome_name.size() );
+        _track_buffer.append( genome_name );
+    }
+    return flush( true );
+}
+
+/**
+ * Adds the coverage of a read segment
+ * Note: the segment cannot start before the position given last to advance(..)
+ * @param begin First genome position covered
+ * @param end   Genome position after the last one covered
+ */
+void genomeMaker::CoverageTrack::add( const uint64_t &begin, const uint64_t &end ) {
+    if( begin >= end ) {
+        return;
+    }
+    _events.emplace( begin, 1 );
+    _events.emplace( end, -1 );
+}
+
+/**
+ * Writes out the coverage up to a genome position
+ * @param position Genome position no segment added from now on starts before
+ * @return Success
+ */
+bool genomeMaker::CoverageTrack::advance( const uint64_t &position ) {
+    while( !_events.empty() && _events.top().first < position ) {
+        const Event event = _events.top();
+        _events.pop();
+        if( event.first > _position ) {
+            extendRun( event.first );
+        }
+        _coverage += event.second;
+    }
+    return flush( false );
+}
+
+/**
+ * Writes out the rest of the coverage
+ * @param genome_size Size of the genome (positions after the last read have no coverage)
+ * @return Success
+ */
+bool genomeMaker::CoverageTrack::finish( const uint64_t &genome_size ) {
+    advance( std::numeric_limits<uint64_t>::max() );
+    if( genome_size > _position ) {
+        extendRun( genome_size );
+    }
+    if( _position > _run_begin ) {
+        writeRun();
+    }
+    if( !flush( true ) ) {
+        return false;
+    }
+    LOG( "[genomeMaker::CoverageTrack::finish( ", genome_size, " )] Coverage runs: ", _runs );
+    return true;
+}
+
+/**
+ * Gets the number of runs written
+ * @return Number of runs
+ */
+uint64_t genomeMaker::CoverageTrack::runs() const {
+    return _runs;
+}
+
+/**
+ * Extends the coverage at the current position up to a genome position
+ * Note: the run being extended is written out first when the coverage changes
+ * @param end Genome position after the last one with the current coverage
+ */
+void genomeMaker::CoverageTrack::extendRun( const uint64_t &end ) {
+    if( _coverage != _run_coverage ) {
+        if( _position > _run_begin ) {
+            writeRun();
+        }
+        _run_begin    = _position;
+        _run_coverage = _coverage;
+    }
+    _position = end;
+}
+
+/**
+ * Writes the run being extended to the buffer(s)
+ */
+void genomeMaker::CoverageTrack::writeRun() {
+    if( _track_writer ) {
+        appendVarInt( _position - _run_begin );
+        appendVarInt( _run_coverage );
+    }
+    if( _bedgraph_writer ) {
+        _bedgraph_buffer.append( _genome_name ).append( "\t" ).append( std::to_string( _run_begin ) );
+        _bedgraph_buffer.append( "\t" ).append( std::to_string( _position ) );
+        _bedgraph_buffer.append( "\t" ).append( std::to_string( _run_coverage ) ).append( "\n" );
+    }
+    _runs++;
+}
+
+/**
+ * Writes the buffered runs to the file(s)
+ * @param force Flag to write whatever the size of the buffers
+ * @return Success
+ */
+bool genomeMaker::CoverageTrack::flush( const bool &force ) {
+    if( _track_writer && !_track_buffer.empty() && ( force || _track_buffer.size() >= _OUTPUT_BUFFER_SIZE ) ) {
+        if( !_track_writer->write( _track_buffer ) ) {
+            LOG_ERROR( "[genomeMaker::CoverageTrack::flush(..)] Could not write to coverage track '", _track_writer->getFileName(), "'." );
+            return false;
+        }
+        _track_buffer.clear();
+    }
+    if( _bedgraph_writer && !_bedgraph_buffer.empty() && ( force || _bedgraph_buffer.size() >= _OUTPUT_BUFFER_SIZE ) ) {
+        if( !_bedgraph_writer->write( _bedgraph_buffer ) ) {
+            LOG_ERROR( "[genomeMaker::CoverageTrack::flush(..)] Could not write to bedGraph '", _bedgraph_writer->getFileName(), "'." );
+            return false;
+        }
+        _bedgraph_buffer.clear();
+    }
+    return true;
+}
+
+/**
+ * Appends a LEB128 variable length integer to the track buffer
+ * @param value Value
+ */
+void genomeMaker::CoverageTrack::appendVarInt( uint64_t value ) {
+    while( value >= 0x80 ) {
+        _track_buffer.push_back( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+    }
+    _track_buffer.push_back( static_cast<char>( value ) );
+}
@@ -0,0 +1,49 @@
+#ifndef GENOMEMAKER_COVERAGETRACK_H
+#define GENOMEMAKER_COVERAGETRACK_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <functional>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileWriter.h"
+
+namespace genomeMaker {
+    class CoverageTrack {
+      public:
+        CoverageTrack();
+        ~CoverageTrack();
+        void setTrackWriter( eadlib::io::FileWriter &track_writer );
+        void setBedGraphWriter( eadlib::io::FileWriter &bedgraph_writer );
+        bool open( const std::string &genome_name );
+        void add( const uint64_t &begin, const uint64_t &end );
+        bool advance( const uint64_t &position );
+        bool finish( const uint64_t &genome_size );
+        uint64_t runs() const;
+        static const std::string _MAGIC;
+
+      private:
+        void extendRun( const uint64_t &end );
+        void writeRun();
+        bool flush( const bool &force );
+        void appendVarInt( uint64_t value );
+        //Private variables
+        typedef std::pair<uint64_t, int32_t> Event; //genome position, coverage change
+        static const size_t _OUTPUT_BUFFER_SIZE = 1 << 20;
+        eadlib::io::FileWriter *_track_writer;
+        eadlib::io::FileWriter *_bedgraph_writer;
+        std::string             _genome_name;
+        std::string             _track_buffer;
+        std::string             _bedgraph_buffer;
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> _events; //coverage changes not yet reached
+        uint64_t                _position;     //genome position the coverage is known up to
+        uint32_t                _coverage;     //coverage at the position
+        uint64_t                _run_begin;    //start of the run being extended
+        uint32_t                _run_coverage; //coverage of the run being extended
+        uint64_t                _runs;
+    };
+}
+
+#endif //GENOMEMAKER_COVERAGETRACK_H
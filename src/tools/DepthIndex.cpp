@@ -0,0 +1,115 @@
+#include "DepthIndex.h"
+
+/**
+ * Constructor
+ * Index layout (TSV): depth, reads, bases, sequencer file bytes, mate file bytes
+ * Note: with the reads in a uniformly random order any prefix of the output is a uniform sample
+ *       so each row gives where the output can be cut for that depth. A row is added every time
+ *       the bases of the reads so far reach the next multiple of the step and a last one gives
+ *       the whole output (when it is not a milestone already).
+ * @param writer Writer of the index file
+ * @param step   Depth between two milestones
+ */
+genomeMaker::DepthIndex::DepthIndex( eadlib::io::FileWriter &writer, const double &step ) :
+    _writer( writer ),
+    _step( step ),
+    _genome_size( 0 ),
+    _reads( 0 ),
+    _bases( 0 ),
+    _record_end( 0 ),
+    _mate_end( 0 ),
+    _next_bases( 0 ),
+    _row_reads( 0 ),
+    _milestones( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::DepthIndex::~DepthIndex() {}
+
+/**
+ * Opens the index file and writes its header
+ * @param genome_size Size of the genome the depths are worked out on
+ * @return Success
+ */
+bool genomeMaker::DepthIndex::open( const uint64_t &genome_size ) {
+    if( genome_size < 1 || _step <= 0 ) {
+        LOG_ERROR( "[genomeMaker::DepthIndex::open( ", genome_size, " )] Invalid genome size or depth step (", _step, ")." );
+        return false;
+    }
+    if( !_writer.isOpen() && !_writer.open() ) {
+        LOG_ERROR( "[genomeMaker::DepthIndex::open( ", genome_size, " )] Could not open the depth index '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _genome_size = genome_size;
+    _reads       = 0;
+    _bases       = 0;
+    _record_end  = 0;
+    _mate_end    = 0;
+    _milestones  = 0;
+    _row_reads   = 0;
+    _next_bases  = static_cast<uint64_t>( std::ceil( _step * static_cast<double>( genome_size ) ) );
+    _buffer.append( "#depth\treads\tbases\tbytes\tmate_bytes\n" );
+    return true;
+}
+
+/**
+ * Adds a read written to the output(s)
+ * @param bases      Bases of the read (mates included)
+ * @param record_end Sequencer file size once the read is written
+ * @param mate_end   Mate file size once the read is written
+ */
+void genomeMaker::DepthIndex::add( const uint64_t &bases, const uint64_t &record_end, const uint64_t &mate_end ) {
+    _reads++;
+    _bases     += bases;
+    _record_end = record_end;
+    _mate_end   = mate_end;
+    while( _bases >= _next_bases ) {
+        _milestones++;
+        appendRow( _step * static_cast<double>( _milestones ) );
+        _next_bases = static_cast<uint64_t>( std::ceil( _step * static_cast<double>( _milestones + 1 ) * static_cast<double>( _genome_size ) ) );
+    }
+}
+
+/**
+ * Writes the row of the whole output and the index to its file
+ * @return Success
+ */
+bool genomeMaker::DepthIndex::finish() {
+    if( _milestones == 0 || _row_reads != _reads ) {
+        appendRow( static_cast<double>( _bases ) / static_cast<double>( _genome_size ) );
+    }
+    if( !_writer.write( _buffer ) ) {
+        LOG_ERROR( "[genomeMaker::DepthIndex::finish()] Could not write to the depth index '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _buffer.clear();
+    LOG( "[genomeMaker::DepthIndex::finish()] Depth milestones: ", _milestones, " (every ", _step, "x)" );
+    return true;
+}
+
+/**
+ * Gets the number of milestones reached
+ * @return Number of milestones
+ */
+size_t genomeMaker::DepthIndex::milestones() const {
+    return _milestones;
+}
+
+/**
+ * Appends the row of a depth with the reads added so far
+ * @param depth Depth
+ */
+void genomeMaker::DepthIndex::appendRow( const double &depth ) {
+    std::string value = std::to_string( depth );
+    value.erase( value.find_last_not_of( '0' ) + 1 );
+    if( value.back() == '.' ) {
+        value.pop_back();
+    }
+    _buffer.append( value ).append( "\t" ).append( std::to_string( _reads ) );
+    _buffer.append( "\t" ).append( std::to_string( _bases ) );
+    _buffer.append( "\t" ).append( std::to_string( _record_end ) );
+    _buffer.append( "\t" ).append( std::to_string( _mate_end ) ).append( "\n" );
+    _row_reads = _reads;
+}
@@ -0,0 +1,37 @@
+#ifndef GENOMEMAKER_DEPTHINDEX_H
+#define GENOMEMAKER_DEPTHINDEX_H
+
+#include <string>
+#include <cmath>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileWriter.h"
+
+namespace genomeMaker {
+    class DepthIndex {
+      public:
+        DepthIndex( eadlib::io::FileWriter &writer, const double &step );
+        ~DepthIndex();
+        bool open( const uint64_t &genome_size );
+        void add( const uint64_t &bases, const uint64_t &record_end, const uint64_t &mate_end );
+        bool finish();
+        size_t milestones() const;
+
+      private:
+        void appendRow( const double &depth );
+        //Private variables
+        eadlib::io::FileWriter &_writer;
+        double                  _step;
+        uint64_t                _genome_size;
+        std::string             _buffer;
+        uint64_t                _reads;
+        uint64_t                _bases;
+        uint64_t                _record_end; //sequencer file offset after the last read added
+        uint64_t                _mate_end;   //mate file offset after the last read added
+        uint64_t                _next_bases; //bases of the next milestone
+        uint64_t                _row_reads;  //reads of the last row
+        size_t                  _milestones;
+    };
+}
+
+#endif //GENOMEMAKER_DEPTHINDEX_H
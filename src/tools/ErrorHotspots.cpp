@@ -0,0 +1,247 @@
+#include "ErrorHotspots.h"
+
+#if defined( __SSSE3__ )
+#include <tmmintrin.h>
+#endif
+
+const size_t genomeMaker::ErrorHotspots::_MAX_MOTIF;
+
+/**
+ * Constructor
+ * Note: a hotspot raises the error rate of the base following a motif (e.g. GGC or a long
+ *       homopolymer). Each motif length has a direct lookup table on the 2-bit hash of that
+ *       many bases. Positions are first filtered on the 4 bases before them against the
+ *       contexts the motifs end with (16 positions at a time with SSSE3 shuffles), so only
+ *       the few positions left get their context hashed and looked up.
+ */
+genomeMaker::ErrorHotspots::ErrorHotspots() :
+    _thresholds( 1, 0 ),
+    _motifs( 0 ),
+    _codes( codes() )
+{
+    _suffixes.fill( 0 );
+    _buckets.fill( 0 );
+}
+
+/**
+ * Destructor
+ */
+genomeMaker::ErrorHotspots::~ErrorHotspots() {}
+
+/**
+ * Loads the hotspot table from a file
+ * Line format: motif (1-8 bases) then the error rate of the base following it (0-1).
+ * Lines starting with '#' are ignored.
+ * @param file_name Name of the hotspot file
+ * @return Success
+ */
+bool genomeMaker::ErrorHotspots::load( const std::string &file_name ) {
+    eadlib::io::FileReader reader( file_name );
+    if( !reader.open() ) {
+        LOG_ERROR( "[genomeMaker::ErrorHotspots::load( ", file_name, " )] Could not open the hotspot file." );
+        return false;
+    }
+    std::vector<Table>    tables;
+    std::vector<uint32_t> thresholds( 1, 0 );
+    std::vector<uint32_t> hashes;  //hash of each motif
+    std::vector<size_t>   lengths; //length of each motif
+    std::vector<char>     line;
+    size_t line_number { 0 };
+    while( !reader.isDone() && reader.readLine( line ) >= 0 ) {
+        line_number++;
+        if( line.empty() || line.front() == '#' ) {
+            continue;
+        }
+        std::stringstream ss( std::string( line.begin(), line.end() ) );
+        std::string motif;
+        double      rate { 0 };
+        if( !( ss >> motif ) ) {
+            continue;
+        }
+        if( !( ss >> rate ) || rate < 0 || rate > 1 || motif.empty() || motif.size() > _MAX_MOTIF ) {
+            LOG_ERROR( "[genomeMaker::ErrorHotspots::load( ", file_name, " )] Invalid motif or rate on line ", line_number,
+                       " (motifs of 1-", _MAX_MOTIF, " bases, rates of 0-1)." );
+            return false;
+        }
+        uint32_t hash { 0 };
+        for( const char &c : motif ) {
+            const int8_t code = _codes[ static_cast<uint8_t>( c ) ];
+            if( code < 0 ) {
+                LOG_ERROR( "[genomeMaker::ErrorHotspots::load( ", file_name, " )] Motif '", motif, "' on line ", line_number, " is not made of A, C, G, T/U." );
+                return false;
+            }
+            hash = ( hash << 2 ) | static_cast<uint32_t>( code );
+        }
+        auto table = std::find_if( tables.begin(), tables.end(), [&]( const Table &t ) { return t._length == motif.size(); } );
+        if( table == tables.end() ) {
+            const uint32_t mask = static_cast<uint32_t>( ( uint64_t( 1 ) << ( 2 * motif.size() ) ) - 1 );
+            tables.push_back( Table { motif.size(), mask, std::vector<uint16_t>( size_t( mask ) + 1, 0 ) } );
+            table = std::prev( tables.end() );
+        }
+        if( table->_entries[ hash ] != 0 ) {
+            LOG_ERROR( "[genomeMaker::ErrorHotspots::load( ", file_name, " )] Motif '", motif, "' on line ", line_number, " is given more than once." );
+            return false;
+        }
+        if( thresholds.size() > std::numeric_limits<uint16_t>::max() ) {
+            LOG_ERROR( "[genomeMaker::ErrorHotspots::load( ", file_name, " )] Too many motifs." );
+            return false;
+        }
+        table->_entries[ hash ] = static_cast<uint16_t>( thresholds.size() );
+        thresholds.emplace_back( static_cast<uint32_t>( std::min( rate * 4294967296.0, 4294967295.0 ) ) );
+        hashes.emplace_back( hash );
+        lengths.emplace_back( motif.size() );
+    }
+    if( tables.empty() ) {
+        LOG_ERROR( "[genomeMaker::ErrorHotspots::load( ", file_name, " )] No motif found." );
+        return false;
+    }
+    std::sort( tables.begin(), tables.end(), []( const Table &a, const Table &b ) { return a._length < b._length; } );
+    _tables     = std::move( tables );
+    _thresholds = std::move( thresholds );
+    _motifs     = hashes.size();
+    _suffixes.fill( 0 );
+    _buckets.fill( 0 );
+    for( size_t i = 0; i < hashes.size(); i++ ) { //last bases are in the low bits (motifs under 4 bases end any context)
+        const uint32_t mask = lengths[ i ] < 4 ? ( uint32_t( 1 ) << ( 2 * lengths[ i ] ) ) - 1 : 0xFF;
+        for( uint32_t context = 0; context < _suffixes.size(); context++ ) {
+            if( ( context & mask ) == ( hashes[ i ] & mask ) ) {
+                _suffixes[ context ] = 1;
+                _buckets[ context & 0xF ] |= static_cast<uint8_t>( 1 << ( ( context >> 4 ) & 7 ) );
+            }
+        }
+    }
+    LOG( "[genomeMaker::ErrorHotspots::load( ", file_name, " )] Loaded ", _motifs, " motif(s) of ", _tables.size(), " length(s)." );
+    return true;
+}
+
+/**
+ * Checks if any hotspot is loaded
+ * @return Active state
+ */
+bool genomeMaker::ErrorHotspots::isActive() const {
+    return _motifs > 0;
+}
+
+/**
+ * Restarts the random stream for a new read
+ * @param key Key of the read's random stream (see CounterRng::key(..))
+ */
+void genomeMaker::ErrorHotspots::reseed( const uint64_t &key ) {
+    _rng.seed( key );
+}
+
+/**
+ * Substitutes bases of a rendered read following a hotspot motif
+ * Note: the context is taken from the read as it was rendered (substitutions are only made once
+ *       the whole read is gone through). When motifs of several lengths end at the same place
+ *       the highest rate is used.
+ * @param sequence    Read sequence (modified in place)
+ * @param length      Length of the read
+ * @param letters     Letter set (4 letters)
+ * @param error_model Error model picking the substituted letters
+ * @param positions   Output for the positions substituted (appended to)
+ * @return Number of substitutions
+ */
+size_t genomeMaker::ErrorHotspots::inject( char *sequence,
+                                           const size_t &length,
+                                           const std::string &letters,
+                                           ErrorModel &error_model,
+                                           std::vector<uint32_t> &positions ) {
+    const size_t first = positions.size();
+    auto check = [&]( const size_t &i ) {
+        const uint32_t limit = threshold( sequence, i );
+        if( limit > 0 && _codes[ static_cast<uint8_t>( sequence[ i ] ) ] >= 0 && ( _rng() & 0xFFFFFFFF ) < limit ) {
+            positions.push_back( static_cast<uint32_t>( i ) );
+        }
+    };
+    size_t i { 1 };
+    for( ; i < 4 && i < length; i++ ) { //contexts shorter than the filter's
+        check( i );
+    }
+#if defined( __SSSE3__ )
+    //Codes are ((c >> 1) ^ (c >> 2)) & 3 on A, C, G, T/U. Anything else gets a code too: the
+    //filter lets it through and the context lookup rules it out. Contexts are split in 2 pairs
+    //of bases, the first pair picks 1 of 8 bucket bits and the last one the buckets it ends.
+    const __m128i buckets  = _mm_loadu_si128( reinterpret_cast<const __m128i *>( _buckets.data() ) );
+    const __m128i bits     = _mm_setr_epi8( 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128 );
+    const __m128i low_bits = _mm_set1_epi8( 3 );
+    const __m128i zero     = _mm_setzero_si128();
+    auto encode = [&]( const char *block ) {
+        const __m128i letters = _mm_loadu_si128( reinterpret_cast<const __m128i *>( block ) );
+        return _mm_and_si128( _mm_xor_si128( _mm_srli_epi16( letters, 1 ), _mm_srli_epi16( letters, 2 ) ), low_bits );
+    };
+    for( ; i + 16 <= length; i += 16 ) {
+        const __m128i high = _mm_or_si128( _mm_slli_epi16( encode( sequence + i - 4 ), 2 ), encode( sequence + i - 3 ) );
+        const __m128i low  = _mm_or_si128( _mm_slli_epi16( encode( sequence + i - 2 ), 2 ), encode( sequence + i - 1 ) );
+        const __m128i hits = _mm_and_si128( _mm_shuffle_epi8( buckets, low ), _mm_shuffle_epi8( bits, high ) );
+        unsigned mask = ~static_cast<unsigned>( _mm_movemask_epi8( _mm_cmpeq_epi8( hits, zero ) ) ) & 0xFFFF;
+        while( mask ) {
+            check( i + static_cast<size_t>( __builtin_ctz( mask ) ) );
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for( ; i < length; i++ ) {
+        uint32_t context { 0 };
+        for( size_t b = i - 4; b < i; b++ ) {
+            context = ( context << 2 ) | ( static_cast<uint32_t>( _codes[ static_cast<uint8_t>( sequence[ b ] ) ] ) & 3 );
+        }
+        if( _suffixes[ context ] ) {
+            check( i );
+        }
+    }
+    for( size_t e = first; e < positions.size(); e++ ) {
+        sequence[ positions[ e ] ] = error_model.substitute( sequence[ positions[ e ] ], letters );
+    }
+    return positions.size() - first;
+}
+
+/**
+ * Gets the highest error threshold of the motifs ending right before a read position
+ * @param sequence Read sequence
+ * @param position Read position
+ * @return Error threshold (0: no motif)
+ */
+uint32_t genomeMaker::ErrorHotspots::threshold( const char *sequence, const size_t &position ) const {
+    uint32_t highest { 0 };
+    uint32_t hash    { 0 }; //last bases in the low bits
+    size_t   bases   { 0 };
+    auto     table   = _tables.begin();
+    while( table != _tables.end() && bases < position ) {
+        const int8_t code = _codes[ static_cast<uint8_t>( sequence[ position - 1 - bases ] ) ];
+        if( code < 0 ) {
+            break;
+        }
+        hash |= static_cast<uint32_t>( code ) << ( 2 * bases );
+        bases++;
+        if( table->_length == bases ) {
+            highest = std::max( highest, _thresholds[ table->_entries[ hash ] ] );
+            ++table;
+        }
+    }
+    return highest;
+}
+
+/**
+ * Gets the number of motifs loaded
+ * @return Number of motifs
+ */
+size_t genomeMaker::ErrorHotspots::motifs() const {
+    return _motifs;
+}
+
+/**
+ * Builds the 2-bit codes of the letters
+ * @return Code of each char (A:0, C:1, G:2, T/U:3, -1 for anything else)
+ */
+std::array<int8_t, 256> genomeMaker::ErrorHotspots::codes() {
+    std::array<int8_t, 256> codes;
+    codes.fill( -1 );
+    const std::string bases[ 4 ] = { "Aa", "Cc", "Gg", "TtUu" };
+    for( size_t code = 0; code < 4; code++ ) {
+        for( const char &c : bases[ code ] ) {
+            codes[ static_cast<uint8_t>( c ) ] = static_cast<int8_t>( code );
+        }
+    }
+    return codes;
+}
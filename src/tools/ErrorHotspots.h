@@ -0,0 +1,53 @@
+#ifndef GENOMEMAKER_ERRORHOTSPOTS_H
+#define GENOMEMAKER_ERRORHOTSPOTS_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileReader.h"
+
+#include "CounterRng.h"
+#include "ErrorModel.h"
+
+namespace genomeMaker {
+    class ErrorHotspots {
+      public:
+        ErrorHotspots();
+        ~ErrorHotspots();
+        bool load( const std::string &file_name );
+        bool isActive() const;
+        void reseed( const uint64_t &key );
+        size_t inject( char *sequence,
+                       const size_t &length,
+                       const std::string &letters,
+                       ErrorModel &error_model,
+                       std::vector<uint32_t> &positions );
+        size_t motifs() const;
+        static const size_t _MAX_MOTIF = 8; //bases (4^8 entries in the largest table)
+
+      private:
+        //Motifs of one length: entry of each 2-bit hash of that many bases (0: no hotspot)
+        struct Table {
+            size_t                _length;
+            uint32_t              _mask;
+            std::vector<uint16_t> _entries;
+        };
+        uint32_t threshold( const char *sequence, const size_t &position ) const;
+        static std::array<int8_t, 256> codes();
+        //Private variables
+        std::vector<Table>        _tables;     //by motif length
+        std::vector<uint32_t>     _thresholds; //error threshold (on 32 random bits) of each entry
+        std::array<uint8_t, 256>  _suffixes;   //contexts of 4 bases (2-bit codes, last base lowest) some motif ends with
+        std::array<uint8_t, 16>   _buckets;    //buckets (bits) of the first 2 bases of the contexts ending with each 2 bases
+        size_t                    _motifs;
+        CounterRng                _rng;
+        std::array<int8_t, 256>   _codes;      //2-bit code of each letter (-1: not a base)
+    };
+}
+
+#endif //GENOMEMAKER_ERRORHOTSPOTS_H
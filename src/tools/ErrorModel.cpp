@@ -0,0 +1,371 @@
+#include "ErrorModel.h"
+
+/**
+ * Constructor
+ * Note: the rates are per base and averaged over the read positions
+ * @param substitution_rate Substitution rate (0-1)
+ * @param insertion_rate    Insertion rate (0-1)
+ * @param deletion_rate     Deletion rate (0-1)
+ */
+genomeMaker::ErrorModel::ErrorModel( const double &substitution_rate, const double &insertion_rate, const double &deletion_rate ) :
+    _substitution_rate( substitution_rate ),
+    _insertion_rate( insertion_rate ),
+    _deletion_rate( deletion_rate ),
+    _total_rate( substitution_rate + insertion_rate + deletion_rate ),
+    _position_profile( { 1 } ),
+    _max_multiplier( 1 ),
+    _candidates( 0 ),
+    _skip( 0 ),
+    _uniform( 0, 1 )
+{
+    for( size_t from = 0; from < _substitution_matrix.size(); from++ ) {
+        double cumulative { 0 };
+        for( size_t to = 0; to < _substitution_matrix[ from ].size(); to++ ) {
+            cumulative += ( from == to ? 0 : 1 );
+            _substitution_matrix[ from ][ to ] = cumulative;
+        }
+    }
+    normaliseProfile();
+}
+
+/**
+ * Destructor
+ */
+genomeMaker::ErrorModel::~ErrorModel() {}
+
+/**
+ * Loads a position dependent error profile
+ * Each non-empty line that is not a comment ('#') holds the relative error rate of a read position.
+ * Reads longer than the profile reuse the last position.
+ * @param file_name Profile file name
+ * @return Success
+ */
+bool genomeMaker::ErrorModel::loadPositionProfile( const std::string &file_name ) {
+    eadlib::io::FileReader reader( file_name );
+    if( !reader.open() ) {
+        LOG_ERROR( "[genomeMaker::ErrorModel::loadPositionProfile( ", file_name, " )] Could not open the error profile file." );
+        return false;
+    }
+    std::vector<double> profile;
+    std::vector<char>   line;
+    while( !reader.isDone() && reader.readLine( line ) >= 0 ) {
+        if( line.empty() || line.front() == '#' ) {
+            continue;
+        }
+        std::stringstream ss( std::string( line.begin(), line.end() ) );
+        double value { 0 };
+        if( !( ss >> value ) || value < 0 ) {
+            LOG_ERROR( "[genomeMaker::ErrorModel::loadPositionProfile( ", file_name, " )] "
+                "Invalid value on position ", profile.size(), "." );
+            return false;
+        }
+        profile.emplace_back( value );
+    }
+    if( profile.empty() || std::accumulate( profile.begin(), profile.end(), 0.0 ) <= 0 ) {
+        LOG_ERROR( "[genomeMaker::ErrorModel::loadPositionProfile( ", file_name, " )] Profile is empty." );
+        return false;
+    }
+    _position_profile = profile;
+    normaliseProfile();
+    return true;
+}
+
+/**
+ * Sets a linear position dependent error profile
+ * @param read_length Length of the reads
+ * @param end_factor  Error rate at the end of a read relative to its start
+ */
+void genomeMaker::ErrorModel::setPositionRamp( const size_t &read_length, const double &end_factor ) {
+    _position_profile.resize( std::max( read_length, (size_t) 1 ) );
+    for( size_t i = 0; i < _position_profile.size(); i++ ) {
+        double x = read_length > 1 ? static_cast<double>( i ) / ( read_length - 1 ) : 0;
+        _position_profile[ i ] = 1 + ( end_factor - 1 ) * x;
+    }
+    normaliseProfile();
+}
+
+/**
+ * Loads a substitution matrix
+ * The file holds 4 lines (origin letter in A, C, G, T/U order) of 4 weights for the replacement letter.
+ * Weights on the diagonal are ignored.
+ * @param file_name Matrix file name
+ * @return Success
+ */
+bool genomeMaker::ErrorModel::loadSubstitutionMatrix( const std::string &file_name ) {
+    eadlib::io::FileReader reader( file_name );
+    if( !reader.open() ) {
+        LOG_ERROR( "[genomeMaker::ErrorModel::loadSubstitutionMatrix( ", file_name, " )] Could not open the substitution matrix file." );
+        return false;
+    }
+    std::array<std::array<double, 4>, 4> matrix;
+    std::vector<char> line;
+    size_t from { 0 };
+    while( !reader.isDone() && reader.readLine( line ) >= 0 ) {
+        if( line.empty() || line.front() == '#' ) {
+            continue;
+        }
+        if( from >= matrix.size() ) {
+            LOG_ERROR( "[genomeMaker::ErrorModel::loadSubstitutionMatrix( ", file_name, " )] More than 4 rows found." );
+            return false;
+        }
+        std::stringstream ss( std::string( line.begin(), line.end() ) );
+        double cumulative { 0 };
+        for( size_t to = 0; to < matrix[ from ].size(); to++ ) {
+            double weight { 0 };
+            if( !( ss >> weight ) || weight < 0 ) {
+                LOG_ERROR( "[genomeMaker::ErrorModel::loadSubstitutionMatrix( ", file_name, " )] Invalid weight in row ", from, "." );
+                return false;
+            }
+            cumulative += ( from == to ? 0 : weight );
+            matrix[ from ][ to ] = cumulative;
+        }
+        if( cumulative <= 0 ) {
+            LOG_ERROR( "[genomeMaker::ErrorModel::loadSubstitutionMatrix( ", file_name, " )] Row ", from, " has no substitution weights." );
+            return false;
+        }
+        from++;
+    }
+    if( from != matrix.size() ) {
+        LOG_ERROR( "[genomeMaker::ErrorModel::loadSubstitutionMatrix( ", file_name, " )] Expected 4 rows, found ", from, "." );
+        return false;
+    }
+    _substitution_matrix = matrix;
+    return true;
+}
+
+/**
+ * Checks if the model injects any per-base errors
+ * @return Active state
+ */
+bool genomeMaker::ErrorModel::isActive() const {
+    return _total_rate > 0;
+}
+
+/**
+ * Restarts the random streams of the model for a new read
+ * Note: the errors of a read then only depend on its key
+ * @param key Key of the read's random stream (see CounterRng::key(..))
+ */
+void genomeMaker::ErrorModel::reseed( const uint64_t &key ) {
+    _rng.seed( key );
+    _uniform.reset();
+    _candidates.reseed( _rng() );
+    _skip = _candidates.gap();
+}
+
+/**
+ * Restarts the random stream of the model where a read left it
+ * Note: lets a read sampled ahead (batch) be rendered once other reads were sampled in between
+ * @param key   Key of the read's random stream (as given to reseed(..))
+ * @param draws Draws of the stream used so far by the read (see draws())
+ */
+void genomeMaker::ErrorModel::resume( const uint64_t &key, const uint64_t &draws ) {
+    _rng.seed( key, draws );
+    _uniform.reset();
+}
+
+/**
+ * Gets the number of draws of the random stream used since the last reseed
+ * @return Number of draws
+ */
+uint64_t genomeMaker::ErrorModel::draws() const {
+    return _rng.counter();
+}
+
+/**
+ * Samples the errors of the next read in the stream
+ * Note: candidate positions are drawn by geometric skip-ahead at the maximum rate and
+ *       thinned by the position profile so the cost scales with the number of errors.
+ * @param read_length Length of the read
+ * @param errors      Container to append the errors to (in position order)
+ */
+void genomeMaker::ErrorModel::sampleErrors( const size_t &read_length, std::vector<Error> &errors ) {
+    if( !isActive() ) {
+        return;
+    }
+    const size_t last { _position_profile.size() - 1 };
+    uint64_t position { _skip };
+    while( position < read_length ) {
+        const double multiplier = _position_profile[ position < last ? position : last ];
+        if( multiplier >= _max_multiplier || _uniform( _rng ) * _max_multiplier < multiplier ) {
+            const double u = _uniform( _rng ) * _total_rate;
+            Type type = u < _substitution_rate ? Type::SUBSTITUTION
+                                               : ( u < _substitution_rate + _insertion_rate ? Type::INSERTION
+                                                                                            : Type::DELETION );
+            errors.push_back( { static_cast<uint32_t>( position ), type, 0 } );
+        }
+        position += 1 + _candidates.gap();
+    }
+    _skip = position - read_length;
+}
+
+/**
+ * Adds a substitution at a position of the read (if there is no error there already)
+ * @param position Position in the read
+ * @param errors   Errors of the read (in position order)
+ */
+void genomeMaker::ErrorModel::addSubstitution( const uint32_t &position, std::vector<Error> &errors ) const {
+    auto it = std::lower_bound( errors.begin(), errors.end(), position,
+                                []( const Error &error, const uint32_t &pos ) { return error._position < pos; } );
+    if( it == errors.end() || it->_position != position ) {
+        errors.insert( it, { position, Type::SUBSTITUTION, 0 } );
+    }
+}
+
+/**
+ * Merges a substitution made on a rendered read into its errors
+ * Note: an error already substituting or inserting the base is updated in place (a substitution
+ *       reverting to the template base is dropped) and a substitution on a base following a
+ *       deletion is added after it
+ * @param position      Position in the read
+ * @param base          Base now at the position
+ * @param read_template Template the read was rendered from
+ * @param template_size Size of the template
+ * @param errors        Errors of the read (in position order)
+ */
+void genomeMaker::ErrorModel::mergeSubstitution( const uint32_t &position,
+                                                 const char &base,
+                                                 const char *read_template,
+                                                 const size_t &template_size,
+                                                 std::vector<Error> &errors ) const {
+    size_t t { position };
+    auto   it = errors.begin();
+    for( ; it != errors.end() && it->_position <= position; ++it ) {
+        if( it->_type == Type::DELETION ) {
+            t++;
+        } else if( it->_type == Type::INSERTION && it->_position < position ) {
+            t--;
+        }
+    }
+    if( it != errors.begin() && std::prev( it )->_position == position && std::prev( it )->_type != Type::DELETION ) {
+        auto previous = std::prev( it );
+        if( previous->_type == Type::SUBSTITUTION && t < template_size && read_template[ t ] == base ) {
+            errors.erase( previous );
+        } else {
+            previous->_base = base;
+        }
+    } else {
+        errors.insert( it, { position, Type::SUBSTITUTION, base } );
+    }
+}
+
+/**
+ * Calculates the length of template needed to render a read with its errors
+ * @param read_length Length of the read
+ * @param errors      Errors of the read
+ * @return Template length
+ */
+size_t genomeMaker::ErrorModel::templateLength( const size_t &read_length, const std::vector<Error> &errors ) {
+    size_t length { read_length };
+    for( const Error &error : errors ) {
+        if( error._type == Type::DELETION ) {
+            length++;
+        } else if( error._type == Type::INSERTION ) {
+            length--;
+        }
+    }
+    return length;
+}
+
+/**
+ * Renders a read from its template and errors straight into an output
+ * Note: deletions that would leave the template short of a full length read are dropped
+ * @param read_template   Template sequence
+ * @param template_length Length of the template
+ * @param read_length     Length of the read
+ * @param letters         Letter set of the genome
+ * @param errors          Errors of the read (updated with the bases used, dropped errors removed)
+ * @param output          Output the read is appended to
+ * @return Length of the rendered read
+ */
+size_t genomeMaker::ErrorModel::apply( const char *read_template,
+                                       const size_t &template_length,
+                                       const size_t &read_length,
+                                       const std::string &letters,
+                                       std::vector<Error> &errors,
+                                       std::string &output ) {
+    if( errors.empty() ) {
+        const size_t length = std::min( read_length, template_length );
+        output.append( read_template, length );
+        return length;
+    }
+    size_t n { 0 }; //bases rendered
+    size_t t { 0 }; //template bases used
+    auto   it = errors.begin();
+    while( n < read_length ) {
+        if( it != errors.end() && it->_position == n ) {
+            if( it->_type == Type::INSERTION ) {
+                it->_base = letters[ static_cast<size_t>( _uniform( _rng ) * letters.size() ) % letters.size() ];
+                output.push_back( it->_base );
+                n++;
+                ++it;
+                continue;
+            }
+            if( it->_type == Type::DELETION ) {
+                if( template_length - t <= read_length - n ) {
+                    it = errors.erase( it );
+                    continue;
+                }
+                it->_base = read_template[ t++ ];
+            }
+            if( t >= template_length ) {
+                break;
+            }
+            if( it->_type == Type::SUBSTITUTION ) {
+                it->_base = substitute( read_template[ t++ ], letters );
+                output.push_back( it->_base );
+            } else {
+                output.push_back( read_template[ t++ ] );
+            }
+            n++;
+            ++it;
+        } else { //template bases up to the next error in one go
+            const size_t next = ( it != errors.end() && it->_position > n ) ? std::min<size_t>( it->_position, read_length ) : read_length;
+            const size_t run  = std::min( next - n, template_length - t );
+            if( run == 0 ) {
+                break;
+            }
+            output.append( read_template + t, run );
+            n += run;
+            t += run;
+        }
+    }
+    errors.erase( it, errors.end() );
+    return n;
+}
+
+/**
+ * Picks a substitute for a base using the substitution matrix
+ * @param base    Original base
+ * @param letters Letter set of the genome
+ * @return Substitute base (never the same as the original)
+ */
+char genomeMaker::ErrorModel::substitute( const char &base, const std::string &letters ) {
+    const size_t from = letters.find( base );
+    if( from == std::string::npos || from >= _substitution_matrix.size() ) {
+        return letters[ static_cast<size_t>( _uniform( _rng ) * letters.size() ) % letters.size() ];
+    }
+    const std::array<double, 4> &row = _substitution_matrix[ from ];
+    const double u = _uniform( _rng ) * row.back();
+    for( size_t to = 0; to < row.size(); to++ ) {
+        if( to != from && u < row[ to ] ) {
+            return letters[ to ];
+        }
+    }
+    return letters[ ( from + 1 ) % letters.size() ];
+}
+
+/**
+ * Normalises the position profile to a mean of 1 and resets the skip-ahead sampler
+ */
+void genomeMaker::ErrorModel::normaliseProfile() {
+    const double mean = std::accumulate( _position_profile.begin(), _position_profile.end(), 0.0 ) / _position_profile.size();
+    if( mean > 0 ) {
+        for( double &multiplier : _position_profile ) {
+            multiplier /= mean;
+        }
+    }
+    _max_multiplier = *std::max_element( _position_profile.begin(), _position_profile.end() );
+    _candidates     = BernoulliStream( std::min( _total_rate * _max_multiplier, 1.0 ) );
+    _skip           = _candidates.gap();
+}
@@ -0,0 +1,70 @@
+#ifndef GENOMEMAKER_ERRORMODEL_H
+#define GENOMEMAKER_ERRORMODEL_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <random>
+#include <sstream>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileReader.h"
+
+#include "BernoulliStream.h"
+#include "CounterRng.h"
+
+namespace genomeMaker {
+    class ErrorModel {
+      public:
+        enum class Type : uint8_t {
+            SUBSTITUTION,
+            INSERTION,
+            DELETION
+        };
+        struct Error {
+            uint32_t _position; //position in the read
+            Type     _type;
+            char     _base;     //substituted/inserted base or deleted template base
+        };
+        ErrorModel( const double &substitution_rate, const double &insertion_rate, const double &deletion_rate );
+        ~ErrorModel();
+        bool loadPositionProfile( const std::string &file_name );
+        void setPositionRamp( const size_t &read_length, const double &end_factor );
+        bool loadSubstitutionMatrix( const std::string &file_name );
+        bool isActive() const;
+        void reseed( const uint64_t &key );
+        void resume( const uint64_t &key, const uint64_t &draws );
+        uint64_t draws() const;
+        void sampleErrors( const size_t &read_length, std::vector<Error> &errors );
+        void addSubstitution( const uint32_t &position, std::vector<Error> &errors ) const;
+        void mergeSubstitution( const uint32_t &position, const char &base, const char *read_template, const size_t &template_size, std::vector<Error> &errors ) const;
+        static size_t templateLength( const size_t &read_length, const std::vector<Error> &errors );
+        size_t apply( const char *read_template,
+                      const size_t &template_length,
+                      const size_t &read_length,
+                      const std::string &letters,
+                      std::vector<Error> &errors,
+                      std::string &output );
+        char substitute( const char &base, const std::string &letters );
+
+      private:
+        void normaliseProfile();
+        //Private variables
+        double                                     _substitution_rate;
+        double                                     _insertion_rate;
+        double                                     _deletion_rate;
+        double                                     _total_rate;
+        std::vector<double>                        _position_profile; //rate multiplier per read position
+        double                                     _max_multiplier;
+        std::array<std::array<double, 4>, 4>       _substitution_matrix; //cumulative weights per origin letter
+        BernoulliStream                            _candidates; //candidate error positions at the maximum rate
+        uint64_t                                   _skip;       //bases left until the next candidate error
+        CounterRng                                 _rng;
+        std::uniform_real_distribution<double>     _uniform;
+    };
+}
+
+#endif //GENOMEMAKER_ERRORMODEL_H
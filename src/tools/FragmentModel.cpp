@@ -0,0 +1,132 @@
+#include "FragmentModel.h"
+
+const std::string genomeMaker::FragmentModel::_ADAPTER_1 = "AGATCGGAAGAGCACACGTCTGAACTCCAGTCAC";
+const std::string genomeMaker::FragmentModel::_ADAPTER_2 = "AGATCGGAAGAGCGTCGTGTAGGGAAAGAGTGT";
+
+/**
+ * Constructor
+ * Note: insert sizes are drawn from a normal distribution truncated to [1, mean + 4sd]
+ * @param library     Library type
+ * @param insert_mean Mean insert (fragment) size
+ * @param insert_sd   Standard deviation of the insert size
+ */
+genomeMaker::FragmentModel::FragmentModel( const Library &library, const double &insert_mean, const double &insert_sd ) :
+    _library( library ),
+    _max_length( static_cast<size_t>( std::ceil( insert_mean + 4 * insert_sd ) ) ),
+    _distribution( insert_mean, insert_sd )
+{
+    if( _max_length < 1 ) {
+        _max_length = 1;
+    }
+}
+
+/**
+ * Destructor
+ */
+genomeMaker::FragmentModel::~FragmentModel() {}
+
+/**
+ * Restarts the random stream of the model for a new read pair
+ * @param key Key of the pair's random stream (see CounterRng::key(..))
+ */
+void genomeMaker::FragmentModel::reseed( const uint64_t &key ) {
+    _rng.seed( key );
+    _distribution.reset();
+}
+
+/**
+ * Samples the length of a fragment
+ * @return Fragment length
+ */
+size_t genomeMaker::FragmentModel::sampleLength() {
+    if( _distribution.stddev() <= 0 ) {
+        return _max_length;
+    }
+    double length { 0 };
+    do {
+        length = std::round( _distribution( _rng ) );
+    } while( length < 1 || length > _max_length );
+    return static_cast<size_t>( length );
+}
+
+/**
+ * Gets the maximum length a fragment can have
+ * @return Maximum fragment length
+ */
+size_t genomeMaker::FragmentModel::maxLength() const {
+    return _max_length;
+}
+
+/**
+ * Creates the pair of mate reads from a fragment
+ * Note: when a fragment is shorter than the mates they read-through into the adapters
+ * @param fragment    Fragment sequence (forward strand)
+ * @param mate_length Length of the mates (read length plus any template consumed by deletions)
+ * @param letters     Letter set of the genome
+ * @param mate1       Mate #1 output
+ * @param mate2       Mate #2 output
+ */
+void genomeMaker::FragmentModel::createMates( const std::string &fragment,
+                                              const size_t &mate_length,
+                                              const std::string &letters,
+                                              std::string &mate1,
+                                              std::string &mate2 ) const {
+    const bool   rna    = letters.find( 'U' ) != std::string::npos;
+    const size_t length = std::min( mate_length, fragment.size() );
+    switch( _library ) {
+        case Library::PAIRED_END: //R1 -> | <- R2
+            mate1.assign( fragment, 0, length );
+            mate2.assign( fragment, fragment.size() - length, length );
+            sequence::reverseComplement( mate2, rna );
+            break;
+        case Library::MATE_PAIR: //<- R1 | R2 ->
+            mate1.assign( fragment, 0, length );
+            sequence::reverseComplement( mate1, rna );
+            mate2.assign( fragment, fragment.size() - length, length );
+            break;
+    }
+    mate1.append( adapter( 1, mate_length - mate1.size(), rna ) );
+    mate2.append( adapter( 2, mate_length - mate2.size(), rna ) );
+}
+
+/**
+ * Gets where the mate templates start on a fragment
+ * @param fragment_length Length of the fragment
+ * @param mate_length     Length of the mate templates
+ * @param anchor1         Anchor of mate #1
+ * @param anchor2         Anchor of mate #2
+ */
+void genomeMaker::FragmentModel::mateAnchors( const size_t &fragment_length,
+                                              const size_t &mate_length,
+                                              MateAnchor &anchor1,
+                                              MateAnchor &anchor2 ) const {
+    const size_t length = std::min( mate_length, fragment_length );
+    switch( _library ) {
+        case Library::PAIRED_END:
+            anchor1 = { 0, false, length };
+            anchor2 = { fragment_length - 1, true, length };
+            break;
+        case Library::MATE_PAIR:
+            anchor1 = { length - 1, true, length };
+            anchor2 = { fragment_length - length, false, length };
+            break;
+    }
+}
+
+/**
+ * Gets the read-through sequence of a mate (adapter then poly-A)
+ * @param mate   Mate number (1 or 2)
+ * @param length Number of bases
+ * @param rna    RNA letter set flag
+ * @return Read-through sequence
+ */
+std::string genomeMaker::FragmentModel::adapter( const unsigned &mate, const size_t &length, const bool &rna ) {
+    const std::string &adapter = mate == 2 ? _ADAPTER_2 : _ADAPTER_1;
+    std::string sequence;
+    sequence.reserve( length );
+    for( size_t i = 0; i < length; i++ ) {
+        char c = i < adapter.size() ? adapter[ i ] : 'A';
+        sequence.push_back( ( rna && c == 'T' ) ? 'U' : c );
+    }
+    return sequence;
+}
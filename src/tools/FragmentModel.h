@@ -0,0 +1,53 @@
+#ifndef GENOMEMAKER_FRAGMENTMODEL_H
+#define GENOMEMAKER_FRAGMENTMODEL_H
+
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "eadlib/logger/Logger.h"
+
+#include "ReverseComplement.h"
+#include "CounterRng.h"
+
+namespace genomeMaker {
+    class FragmentModel {
+      public:
+        enum class Library {
+            PAIRED_END, //Mates facing inwards (FR)
+            MATE_PAIR   //Mates facing outwards (RF)
+        };
+        struct MateAnchor {
+            size_t _offset;  //fragment position of the mate's first template base
+            bool   _reverse; //template runs towards the start of the fragment
+            size_t _length;  //fragment bases in the template (the rest is adapter)
+        };
+        FragmentModel( const Library &library, const double &insert_mean, const double &insert_sd );
+        ~FragmentModel();
+        void reseed( const uint64_t &key );
+        size_t sampleLength();
+        size_t maxLength() const;
+        void createMates( const std::string &fragment,
+                          const size_t &mate_length,
+                          const std::string &letters,
+                          std::string &mate1,
+                          std::string &mate2 ) const;
+        void mateAnchors( const size_t &fragment_length,
+                          const size_t &mate_length,
+                          MateAnchor &anchor1,
+                          MateAnchor &anchor2 ) const;
+        static std::string adapter( const unsigned &mate, const size_t &length, const bool &rna );
+
+      private:
+        //Private variables
+        static const std::string _ADAPTER_1; //Read-through adapter for mate #1
+        static const std::string _ADAPTER_2; //Read-through adapter for mate #2
+        Library                          _library;
+        size_t                           _max_length;
+        CounterRng                       _rng;
+        std::normal_distribution<double> _distribution;
+    };
+}
+
+#endif //GENOMEMAKER_FRAGMENTMODEL_H
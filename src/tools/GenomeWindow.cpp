@@ -0,0 +1,241 @@
+#include "GenomeWindow.h"
+
+/**
+ * Constructor
+ * @param reader   EADlib File Reader on the genome
+ * @param io_block Size of the blocks read from the genome file
+ */
+genomeMaker::GenomeWindow::GenomeWindow( eadlib::io::FileReader &reader, const size_t &io_block ) :
+    _reader( &reader ),
+    _mapped( nullptr ),
+    _stream( nullptr ),
+    _stream_done( false ),
+    _io_block( std::max( io_block, (size_t) 1 ) ),
+    _genome_size( 0 ),
+    _begin( 0 )
+{}
+
+/**
+ * Constructor
+ * Note: the window is the whole of the memory mapped genome so any position can be got at
+ *       and advancing it does nothing.
+ * @param file     Memory mapped genome file
+ * @param io_block Size of the block the letter set is detected from
+ */
+genomeMaker::GenomeWindow::GenomeWindow( genomeMaker::MappedFile &file, const size_t &io_block ) :
+    _reader( nullptr ),
+    _mapped( &file ),
+    _stream( nullptr ),
+    _stream_done( false ),
+    _io_block( std::max( io_block, (size_t) 1 ) ),
+    _genome_size( 0 ),
+    _begin( 0 )
+{}
+
+/**
+ * Constructor
+ * Note: the genome is read from the stream block by block just like a genome file but its
+ *       size is only known (genomeSize()) once the end of the stream has been reached.
+ * @param stream   Input stream of the genome (e.g. std::cin)
+ * @param name     Name given to the genome (contig name of the truth records)
+ * @param io_block Size of the blocks read from the stream
+ */
+genomeMaker::GenomeWindow::GenomeWindow( std::istream &stream, const std::string &name, const size_t &io_block ) :
+    _reader( nullptr ),
+    _mapped( nullptr ),
+    _stream( &stream ),
+    _stream_name( name ),
+    _stream_done( false ),
+    _io_block( std::max( io_block, (size_t) 1 ) ),
+    _genome_size( 0 ),
+    _begin( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::GenomeWindow::~GenomeWindow() {}
+
+/**
+ * Opens the genome and reads its first block into the window
+ * @return Success
+ */
+bool genomeMaker::GenomeWindow::open() {
+    if( _mapped ) {
+        if( !_mapped->isOpen() && !_mapped->open() ) {
+            LOG_ERROR( "[genomeMaker::GenomeWindow::open()] Could not map the genome file '", _mapped->getFileName(), "'." );
+            return false;
+        }
+        _genome_size = _mapped->size();
+        return _genome_size > 0;
+    }
+    if( _stream ) {
+        _genome_size = 0;
+        _window.clear();
+        _begin = 0;
+        if( !advance( 0 ) || end() < 1 ) {
+            LOG_ERROR( "[genomeMaker::GenomeWindow::open()] Nothing to read from the genome stream '", _stream_name, "'." );
+            return false;
+        }
+        return true;
+    }
+    if( !_reader->isOpen() && !_reader->open() ) {
+        LOG_ERROR( "[genomeMaker::GenomeWindow::open()] Could not open the genome file '", _reader->getFileName(), "'." );
+        return false;
+    }
+    _genome_size = _reader->size() > 0 ? (uint64_t) _reader->size() : 0;
+    _window.clear();
+    _begin = 0;
+    return _genome_size > 0 && advance( 0 );
+}
+
+/**
+ * Moves the window along the genome by one block
+ * Note: what comes before the 'from' position is dropped before reading the next block so only
+ *       the part still needed by pending reads gets carried over. Blocks wholly before 'from'
+ *       are skipped.
+ * @param from Genome position of the first character still needed
+ * @return Success (false when there is nothing left to read)
+ */
+bool genomeMaker::GenomeWindow::advance( const uint64_t &from ) {
+    if( _mapped ) {
+        return true;
+    }
+    if( from > _begin ) {
+        const size_t drop = static_cast<size_t>( std::min( from - _begin, static_cast<uint64_t>( _window.size() ) ) );
+        _window.erase( _window.begin(), _window.begin() + drop );
+        _begin += drop;
+    }
+    do {
+        std::streamsize read = readBlock();
+        if( read < 1 && _stream_done ) { //stream ended on a block boundary
+            return true;
+        }
+        if( read < 1 ) {
+            LOG_ERROR( "[genomeMaker::GenomeWindow::advance( ", from, " )] "
+                "Could not read the genome past position ", end(), "." );
+            return false;
+        }
+        if( _window.empty() && _begin + read <= from ) {
+            _begin += read;
+        } else {
+            _window.insert( _window.end(), _block.begin(), _block.begin() + read );
+        }
+    } while( _window.empty() && !isComplete() );
+    return true;
+}
+
+/**
+ * Gets a pointer to a genome position held in the window
+ * @param position Genome position (between begin() and end())
+ * @return Pointer to the character
+ */
+const char * genomeMaker::GenomeWindow::at( const uint64_t &position ) const {
+    if( _mapped ) {
+        return _mapped->data() + position;
+    }
+    return _window.data() + ( position - _begin );
+}
+
+/**
+ * Gets the genome position of the first character in the window
+ * @return Genome position
+ */
+uint64_t genomeMaker::GenomeWindow::begin() const {
+    return _begin;
+}
+
+/**
+ * Gets the genome position after the last character in the window
+ * @return Genome position
+ */
+uint64_t genomeMaker::GenomeWindow::end() const {
+    if( _mapped ) {
+        return _genome_size;
+    }
+    return _begin + _window.size();
+}
+
+/**
+ * Gets the size of the genome
+ * @return Number of characters
+ */
+uint64_t genomeMaker::GenomeWindow::genomeSize() const {
+    return _genome_size;
+}
+
+/**
+ * Checks if the window reaches the end of the genome
+ * @return Complete state
+ */
+bool genomeMaker::GenomeWindow::isComplete() const {
+    if( _stream ) {
+        return _stream_done;
+    }
+    return end() >= _genome_size;
+}
+
+/**
+ * Checks if the genome comes from a stream (size unknown until complete)
+ * @return Streamed state
+ */
+bool genomeMaker::GenomeWindow::isStreamed() const {
+    return _stream != nullptr;
+}
+
+/**
+ * Detects the letter set of the genome from the window
+ * @return Letter set
+ */
+std::string genomeMaker::GenomeWindow::detectLetterSet() const {
+    if( _mapped ) { //same first block as a streamed genome
+        const char *first = _mapped->data();
+        const char *last  = first + std::min( _genome_size, static_cast<uint64_t>( _io_block ) );
+        return std::find( first, last, 'U' ) != last ? "ACGU" : "ACGT";
+    }
+    if( std::find( _window.begin(), _window.end(), 'U' ) != _window.end() ) {
+        return "ACGU";
+    }
+    return "ACGT";
+}
+
+/**
+ * Gets the file name of the genome
+ * @return File name
+ */
+std::string genomeMaker::GenomeWindow::getFileName() const {
+    if( _stream ) {
+        return _stream_name;
+    }
+    return _mapped ? _mapped->getFileName() : _reader->getFileName();
+}
+
+/**
+ * Gets the size of the blocks read from the genome file
+ * @return Block size
+ */
+size_t genomeMaker::GenomeWindow::ioBlock() const {
+    return _io_block;
+}
+
+/**
+ * Reads the next block of the genome file or stream
+ * Note: the genome size is set when the end of a stream is reached
+ * @return Number of characters read
+ */
+std::streamsize genomeMaker::GenomeWindow::readBlock() {
+    if( !_stream ) {
+        return _reader->isDone() ? 0 : _reader->read( _block, _io_block );
+    }
+    if( _stream_done ) {
+        return 0;
+    }
+    _block.resize( _io_block );
+    _stream->read( _block.data(), static_cast<std::streamsize>( _io_block ) );
+    const std::streamsize read = _stream->gcount();
+    if( read < static_cast<std::streamsize>( _io_block ) ) {
+        _stream_done = true;
+        _genome_size = end() + static_cast<uint64_t>( read );
+    }
+    return read;
+}
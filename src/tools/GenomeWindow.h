@@ -0,0 +1,49 @@
+#ifndef GENOMEMAKER_GENOMEWINDOW_H
+#define GENOMEMAKER_GENOMEWINDOW_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <istream>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileReader.h"
+
+#include "MappedFile.h"
+
+namespace genomeMaker {
+    class GenomeWindow {
+      public:
+        GenomeWindow( eadlib::io::FileReader &reader, const size_t &io_block );
+        GenomeWindow( genomeMaker::MappedFile &file, const size_t &io_block );
+        GenomeWindow( std::istream &stream, const std::string &name, const size_t &io_block );
+        ~GenomeWindow();
+        bool open();
+        bool advance( const uint64_t &from );
+        const char * at( const uint64_t &position ) const;
+        uint64_t begin() const;
+        uint64_t end() const;
+        uint64_t genomeSize() const;
+        bool isComplete() const;
+        bool isStreamed() const;
+        std::string detectLetterSet() const;
+        std::string getFileName() const;
+        size_t ioBlock() const;
+
+      private:
+        std::streamsize readBlock();
+        //Private variables
+        eadlib::io::FileReader *_reader;
+        MappedFile             *_mapped; //whole genome mapped in memory (random access)
+        std::istream           *_stream; //genome of unknown size coming from a pipe
+        std::string             _stream_name;
+        bool                    _stream_done;
+        size_t                  _io_block;
+        uint64_t                _genome_size;
+        uint64_t                _begin;  //genome position of the window's first character
+        std::vector<char>       _window; //section of the genome reads are currently taken from
+        std::vector<char>       _block;  //block read from the genome file
+    };
+}
+
+#endif //GENOMEMAKER_GENOMEWINDOW_H
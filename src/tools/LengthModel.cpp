@@ -0,0 +1,138 @@
+#include "LengthModel.h"
+
+/**
+ * Constructor
+ */
+genomeMaker::LengthModel::LengthModel() :
+    _empirical( false ),
+    _max_length( 1 ),
+    _mean( 1 ),
+    _uniform( 0, 1 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::LengthModel::~LengthModel() {}
+
+/**
+ * Sets a log-normal read length distribution
+ * Note: lengths are truncated to [1, min( max_length, e^(mu + 4sigma) )]
+ * @param mean       Mean read length
+ * @param sd         Standard deviation of the read length
+ * @param max_length Hard limit on the read length
+ * @return Success
+ */
+bool genomeMaker::LengthModel::setLogNormal( const double &mean, const double &sd, const size_t &max_length ) {
+    if( mean < 1 || sd < 0 || mean > max_length ) {
+        LOG_ERROR( "[genomeMaker::LengthModel::setLogNormal( ", mean, ", ", sd, ", ", max_length, " )] Invalid parameters." );
+        return false;
+    }
+    const double sigma = std::sqrt( std::log( 1 + ( sd * sd ) / ( mean * mean ) ) );
+    const double mu    = std::log( mean ) - sigma * sigma / 2;
+    _log_normal = std::lognormal_distribution<double>( mu, sigma );
+    _max_length = static_cast<size_t>( std::min( std::ceil( std::exp( mu + 4 * sigma ) ), static_cast<double>( max_length ) ) );
+    _mean       = mean;
+    _empirical  = false;
+    return true;
+}
+
+/**
+ * Loads an empirical read length distribution
+ * Each non-empty line that is not a comment ('#') holds a read length optionally followed by its count
+ * (or weight) so a plain list of observed read lengths can be used as is.
+ * @param file_name  Distribution file name
+ * @param max_length Hard limit on the read length
+ * @return Success
+ */
+bool genomeMaker::LengthModel::loadDistribution( const std::string &file_name, const size_t &max_length ) {
+    eadlib::io::FileReader reader( file_name );
+    if( !reader.open() ) {
+        LOG_ERROR( "[genomeMaker::LengthModel::loadDistribution( ", file_name, " )] Could not open the length distribution file." );
+        return false;
+    }
+    std::vector<size_t> lengths;
+    std::vector<double> cumulative;
+    std::vector<char>   line;
+    double total { 0 }, sum { 0 };
+    size_t line_number { 0 };
+    while( !reader.isDone() && reader.readLine( line ) >= 0 ) {
+        line_number++;
+        if( line.empty() || line.front() == '#' ) {
+            continue;
+        }
+        std::stringstream ss( std::string( line.begin(), line.end() ) );
+        double length { 0 }, weight { 1 };
+        if( !( ss >> length ) || length < 1 || length > max_length ) {
+            LOG_ERROR( "[genomeMaker::LengthModel::loadDistribution( ", file_name, " )] "
+                "Invalid length on line ", line_number, " (expected 1-", max_length, ")." );
+            return false;
+        }
+        if( ss >> weight && weight < 0 ) {
+            LOG_ERROR( "[genomeMaker::LengthModel::loadDistribution( ", file_name, " )] Negative weight on line ", line_number, "." );
+            return false;
+        }
+        total += weight;
+        sum   += weight * length;
+        lengths.emplace_back( static_cast<size_t>( length ) );
+        cumulative.emplace_back( total );
+    }
+    if( lengths.empty() || total <= 0 ) {
+        LOG_ERROR( "[genomeMaker::LengthModel::loadDistribution( ", file_name, " )] No read lengths found." );
+        return false;
+    }
+    _lengths    = lengths;
+    _cumulative = cumulative;
+    _max_length = *std::max_element( lengths.begin(), lengths.end() );
+    _mean       = sum / total;
+    _empirical  = true;
+    LOG( "[genomeMaker::LengthModel::loadDistribution( ", file_name, " )] Loaded ", lengths.size(), " lengths (mean ", _mean, ")." );
+    return true;
+}
+
+/**
+ * Restarts the random stream of the model for a new read
+ * @param key Key of the read's random stream (see CounterRng::key(..))
+ */
+void genomeMaker::LengthModel::reseed( const uint64_t &key ) {
+    _rng.seed( key );
+    _log_normal.reset();
+    _uniform.reset();
+}
+
+/**
+ * Samples the length of a read
+ * Note: empirical lengths are found by binary search on the cumulative weights
+ * @return Read length
+ */
+size_t genomeMaker::LengthModel::sample() {
+    if( _empirical ) {
+        const double u = _uniform( _rng ) * _cumulative.back();
+        auto it = std::upper_bound( _cumulative.begin(), _cumulative.end(), u );
+        return _lengths[ std::min( static_cast<size_t>( it - _cumulative.begin() ), _lengths.size() - 1 ) ];
+    }
+    if( _log_normal.s() <= 0 ) {
+        return static_cast<size_t>( std::round( _mean ) );
+    }
+    double length { 0 };
+    do {
+        length = std::round( _log_normal( _rng ) );
+    } while( length < 1 || length > _max_length );
+    return static_cast<size_t>( length );
+}
+
+/**
+ * Gets the mean read length
+ * @return Mean length
+ */
+double genomeMaker::LengthModel::mean() const {
+    return _mean;
+}
+
+/**
+ * Gets the maximum length a read can have
+ * @return Maximum read length
+ */
+size_t genomeMaker::LengthModel::maxLength() const {
+    return _max_length;
+}
@@ -0,0 +1,41 @@
+#ifndef GENOMEMAKER_LENGTHMODEL_H
+#define GENOMEMAKER_LENGTHMODEL_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileReader.h"
+
+#include "CounterRng.h"
+
+namespace genomeMaker {
+    class LengthModel {
+      public:
+        LengthModel();
+        ~LengthModel();
+        bool setLogNormal( const double &mean, const double &sd, const size_t &max_length );
+        bool loadDistribution( const std::string &file_name, const size_t &max_length );
+        void reseed( const uint64_t &key );
+        size_t sample();
+        double mean() const;
+        size_t maxLength() const;
+
+      private:
+        //Private variables
+        bool                                   _empirical;
+        size_t                                 _max_length;
+        double                                 _mean;
+        std::vector<size_t>                    _lengths;    //empirical read lengths
+        std::vector<double>                    _cumulative; //cumulative weights of the empirical lengths
+        std::lognormal_distribution<double>    _log_normal;
+        std::uniform_real_distribution<double> _uniform;
+        CounterRng                             _rng;
+    };
+}
+
+#endif //GENOMEMAKER_LENGTHMODEL_H
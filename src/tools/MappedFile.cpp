@@ -0,0 +1,101 @@
+#include "MappedFile.h"
+
+/**
+ * Constructor
+ * @param file_name File name
+ */
+genomeMaker::MappedFile::MappedFile( const std::string &file_name ) :
+    _file_name( file_name ),
+    _descriptor( -1 ),
+    _data( nullptr ),
+    _size( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * Maps the file read-only into memory
+ * Note: pages are loaded by the OS on access and read ahead sequentially
+ * @return Success
+ */
+bool genomeMaker::MappedFile::open() {
+    if( isOpen() ) {
+        LOG_ERROR( "[genomeMaker::MappedFile::open()] File '", _file_name, "' is already mapped." );
+        return false;
+    }
+    _descriptor = ::open( _file_name.c_str(), O_RDONLY );
+    if( _descriptor < 0 ) {
+        LOG_ERROR( "[genomeMaker::MappedFile::open()] Could not open '", _file_name, "': ", strerror( errno ) );
+        return false;
+    }
+    struct stat info;
+    if( fstat( _descriptor, &info ) != 0 || !S_ISREG( info.st_mode ) ) {
+        LOG_ERROR( "[genomeMaker::MappedFile::open()] '", _file_name, "' is not a regular file." );
+        close();
+        return false;
+    }
+    _size = static_cast<uint64_t>( info.st_size );
+    if( _size > 0 ) {
+        void *address = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, _descriptor, 0 );
+        if( address == MAP_FAILED ) {
+            LOG_ERROR( "[genomeMaker::MappedFile::open()] Could not map '", _file_name, "': ", strerror( errno ) );
+            close();
+            return false;
+        }
+        _data = static_cast<char *>( address );
+        madvise( _data, _size, MADV_SEQUENTIAL );
+    }
+    return true;
+}
+
+/**
+ * Unmaps the file
+ */
+void genomeMaker::MappedFile::close() {
+    if( _data ) {
+        munmap( _data, _size );
+        _data = nullptr;
+    }
+    if( _descriptor >= 0 ) {
+        ::close( _descriptor );
+        _descriptor = -1;
+    }
+    _size = 0;
+}
+
+/**
+ * Checks the mapped state of the file
+ * @return Mapped state
+ */
+bool genomeMaker::MappedFile::isOpen() const {
+    return _descriptor >= 0;
+}
+
+/**
+ * Gets the content of the file
+ * @return Pointer to the first byte (nullptr when empty or not mapped)
+ */
+const char * genomeMaker::MappedFile::data() const {
+    return _data;
+}
+
+/**
+ * Gets the size of the file
+ * @return Size in bytes
+ */
+uint64_t genomeMaker::MappedFile::size() const {
+    return _size;
+}
+
+/**
+ * Gets the file name
+ * @return File name
+ */
+std::string genomeMaker::MappedFile::getFileName() const {
+    return _file_name;
+}
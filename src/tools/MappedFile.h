@@ -0,0 +1,35 @@
+#ifndef GENOMEMAKER_MAPPEDFILE_H
+#define GENOMEMAKER_MAPPEDFILE_H
+
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eadlib/logger/Logger.h"
+
+namespace genomeMaker {
+    class MappedFile {
+      public:
+        MappedFile( const std::string &file_name );
+        MappedFile( const MappedFile &file ) = delete;
+        ~MappedFile();
+        bool open();
+        void close();
+        bool isOpen() const;
+        const char * data() const;
+        uint64_t size() const;
+        std::string getFileName() const;
+
+      private:
+        std::string _file_name;
+        int         _descriptor;
+        char       *_data;
+        uint64_t    _size;
+    };
+}
+
+#endif //GENOMEMAKER_MAPPEDFILE_H
@@ -0,0 +1,225 @@
+#include "QualityModel.h"
+
+/**
+ * Constructor
+ * @param binning Illumina-style 8-level quality binning flag
+ */
+genomeMaker::QualityModel::QualityModel( const bool &binning ) :
+    _binning( binning )
+{
+    for( size_t c = 0; c < _error_thresholds.size(); c++ ) {
+        if( c < _PHRED_OFFSET ) {
+            _error_thresholds[ c ] = 0;
+        } else {
+            double p = std::pow( 10.0, -static_cast<double>( c - _PHRED_OFFSET ) / 10.0 );
+            _error_thresholds[ c ] = static_cast<uint32_t>( std::min( p * 4294967296.0, 4294967295.0 ) );
+        }
+        _candidates.emplace_back( _error_thresholds[ c ] / 4294967296.0 );
+    }
+}
+
+/**
+ * Destructor
+ */
+genomeMaker::QualityModel::~QualityModel() {}
+
+/**
+ * Loads an empirical quality profile
+ * Each non-empty line that is not a comment ('#') is a read position and holds the
+ * whitespace separated counts (or frequencies) of the quality scores Q0, Q1, Q2, ...
+ * Reads longer than the profile reuse the last position.
+ * @param file_name Profile file name
+ * @return Success
+ */
+bool genomeMaker::QualityModel::loadProfile( const std::string &file_name ) {
+    eadlib::io::FileReader reader( file_name );
+    if( !reader.open() ) {
+        LOG_ERROR( "[genomeMaker::QualityModel::loadProfile( ", file_name, " )] Could not open the quality profile file." );
+        return false;
+    }
+    _tables.clear();
+    std::vector<char> line;
+    size_t line_number { 0 };
+    while( !reader.isDone() && reader.readLine( line ) >= 0 ) {
+        line_number++;
+        if( line.empty() || line.front() == '#' ) {
+            continue;
+        }
+        std::stringstream ss( std::string( line.begin(), line.end() ) );
+        std::vector<double> histogram;
+        double value { 0 };
+        while( ss >> value ) {
+            if( value < 0 ) {
+                LOG_ERROR( "[genomeMaker::QualityModel::loadProfile( ", file_name, " )] Negative count on line ", line_number, "." );
+                return false;
+            }
+            histogram.emplace_back( value );
+        }
+        if( histogram.empty() || histogram.size() > 94 ) {
+            LOG_ERROR( "[genomeMaker::QualityModel::loadProfile( ", file_name, " )] "
+                "Line ", line_number, " has ", histogram.size(), " quality columns (expected 1-94)." );
+            return false;
+        }
+        if( std::accumulate( histogram.begin(), histogram.end(), 0.0 ) <= 0 ) {
+            LOG_ERROR( "[genomeMaker::QualityModel::loadProfile( ", file_name, " )] Line ", line_number, " has no counts." );
+            return false;
+        }
+        _tables.emplace_back();
+        buildTable( histogram, _tables.back() );
+    }
+    if( _tables.empty() ) {
+        LOG_ERROR( "[genomeMaker::QualityModel::loadProfile( ", file_name, " )] No read positions found in the profile." );
+        return false;
+    }
+    LOG( "[genomeMaker::QualityModel::loadProfile( ", file_name, " )] Loaded ", _tables.size(), " read positions." );
+    return true;
+}
+
+/**
+ * Creates a parametric quality profile where the mean quality decays along the read
+ * @param read_length Length of the reads
+ * @param q_start     Mean quality at the start of a read
+ * @param q_end       Mean quality at the end of a read
+ * @return Success
+ */
+bool genomeMaker::QualityModel::createDecayProfile( const size_t &read_length, const unsigned &q_start, const unsigned &q_end ) {
+    if( read_length < 1 || q_start > _MAX_QUALITY || q_end > _MAX_QUALITY ) {
+        LOG_ERROR( "[genomeMaker::QualityModel::createDecayProfile( ", read_length, ", ", q_start, ", ", q_end, " )] "
+            "Invalid parameters (qualities must be between 0-", (unsigned) _MAX_QUALITY, ")." );
+        return false;
+    }
+    const double sd { 3.0 };
+    _tables.clear();
+    _tables.resize( read_length );
+    std::vector<double> histogram( _MAX_QUALITY + 1, 0 );
+    for( size_t pos = 0; pos < read_length; pos++ ) {
+        double x    = read_length > 1 ? static_cast<double>( pos ) / ( read_length - 1 ) : 0;
+        double mean = q_end + ( static_cast<double>( q_start ) - q_end ) * ( 1 - x * x );
+        for( size_t q = 0; q < histogram.size(); q++ ) {
+            histogram[ q ] = std::exp( -( q - mean ) * ( q - mean ) / ( 2 * sd * sd ) );
+        }
+        buildTable( histogram, _tables[ pos ] );
+    }
+    return true;
+}
+
+/**
+ * Restarts the random stream of the model for a new read
+ * @param key Key of the read's random stream (see CounterRng::key(..))
+ */
+void genomeMaker::QualityModel::reseed( const uint64_t &key ) {
+    _rng.seed( key );
+}
+
+/**
+ * Generates the quality string of a read (phred+33)
+ * Note: each 64bit random draw feeds 8 table lookups. The draws of the read are made in one go.
+ * @param qualities Quality output
+ * @param length    Length of the read
+ */
+void genomeMaker::QualityModel::generate( char *qualities, const size_t &length ) {
+    const size_t last   { _tables.size() - 1 };
+    const size_t direct { std::min( length, last ) & ~static_cast<size_t>( 7 ) }; //whole draws on positions with their own table
+    _draws.resize( ( length + 7 ) / 8 );
+    _rng.draw( _draws.data(), _draws.size() );
+    const LookupTable_t *tables = _tables.data(); //locals as the char output could alias the members
+    const uint64_t      *draws  = _draws.data();
+    size_t i { 0 };
+    for( ; i < direct; i += 8 ) {
+        const uint64_t bits = draws[ i / 8 ];
+        for( size_t b = 0; b < 8; b++ ) {
+            qualities[ i + b ] = tables[ i + b ][ ( bits >> ( 8 * b ) ) & 0xFF ];
+        }
+    }
+    for( ; i < length; i++ ) {
+        qualities[ i ] = tables[ i < last ? i : last ][ ( draws[ i / 8 ] >> ( 8 * ( i & 7 ) ) ) & 0xFF ];
+    }
+}
+
+/**
+ * Injects substitution errors in a read with the probability implied by each base's quality score
+ * Note: candidate positions are drawn by geometric skip-ahead at the error probability of the lowest
+ *       quality of the read then thinned down to each base's own probability so the random draws
+ *       are proportional to the errors rather than to the bases
+ * @param sequence  Read sequence
+ * @param qualities Read qualities (phred+33)
+ * @param length    Length of the read
+ * @param letters   Letter set to draw substitutions from
+ * @param positions Container to append the positions of the errors to (optional)
+ * @return Number of errors injected
+ */
+size_t genomeMaker::QualityModel::injectErrors( char *sequence,
+                                                const char *qualities,
+                                                const size_t &length,
+                                                const std::string &letters,
+                                                std::vector<uint32_t> *positions ) {
+    if( length == 0 ) {
+        return 0;
+    }
+    const auto     lowest  = static_cast<uint8_t>( *std::min_element( qualities, qualities + length ) );
+    const uint64_t highest = _error_thresholds[ lowest ];
+    if( highest == 0 ) {
+        return 0;
+    }
+    BernoulliStream &candidates = _candidates[ lowest ];
+    candidates.reseed( _rng() );
+    size_t errors { 0 };
+    for( uint64_t i = candidates.gap(); i < length; i += 1 + candidates.gap() ) {
+        const uint64_t threshold = _error_thresholds[ static_cast<uint8_t>( qualities[ i ] ) ];
+        if( threshold < highest && ( _rng() & 0xFFFFFFFF ) * highest >= threshold << 32 ) {
+            continue;
+        }
+        size_t index = letters.find( sequence[ i ] );
+        if( index != std::string::npos ) {
+            sequence[ i ] = letters[ ( index + 1 + _rng() % ( letters.size() - 1 ) ) % letters.size() ];
+            errors++;
+            if( positions ) {
+                positions->push_back( static_cast<uint32_t>( i ) );
+            }
+        }
+    }
+    return errors;
+}
+
+/**
+ * Gets the number of read positions described by the profile
+ * @return Number of positions
+ */
+size_t genomeMaker::QualityModel::positions() const {
+    return _tables.size();
+}
+
+/**
+ * Builds an inverse-CDF lookup table from a quality score histogram
+ * @param histogram Counts for each quality score
+ * @param table     Lookup table to fill (random byte -> phred char)
+ */
+void genomeMaker::QualityModel::buildTable( const std::vector<double> &histogram, LookupTable_t &table ) const {
+    const double total = std::accumulate( histogram.begin(), histogram.end(), 0.0 );
+    double cumulative { 0 };
+    size_t q          { 0 };
+    for( size_t b = 0; b < table.size(); b++ ) {
+        const double u = ( b + 0.5 ) / table.size() * total;
+        while( q < histogram.size() - 1 && cumulative + histogram[ q ] < u ) {
+            cumulative += histogram[ q ];
+            q++;
+        }
+        table[ b ] = static_cast<uint8_t>( binQuality( static_cast<uint8_t>( q ) ) + _PHRED_OFFSET );
+    }
+}
+
+/**
+ * Bins a quality score into the Illumina 8-level scheme (when binning is enabled)
+ * @param q Quality score
+ * @return Binned quality score
+ */
+uint8_t genomeMaker::QualityModel::binQuality( const uint8_t &q ) const {
+    if( !_binning || q < 2 ) return q;
+    if( q < 10 ) return 6;
+    if( q < 20 ) return 15;
+    if( q < 25 ) return 22;
+    if( q < 30 ) return 27;
+    if( q < 35 ) return 33;
+    if( q < 40 ) return 37;
+    return 40;
+}
@@ -0,0 +1,50 @@
+#ifndef GENOMEMAKER_QUALITYMODEL_H
+#define GENOMEMAKER_QUALITYMODEL_H
+
+#include <array>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <algorithm>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileReader.h"
+
+#include "CounterRng.h"
+#include "BernoulliStream.h"
+
+namespace genomeMaker {
+    class QualityModel {
+      public:
+        QualityModel( const bool &binning );
+        ~QualityModel();
+        bool loadProfile( const std::string &file_name );
+        bool createDecayProfile( const size_t &read_length, const unsigned &q_start, const unsigned &q_end );
+        void reseed( const uint64_t &key );
+        void generate( char *qualities, const size_t &length );
+        size_t injectErrors( char *sequence,
+                             const char *qualities,
+                             const size_t &length,
+                             const std::string &letters,
+                             std::vector<uint32_t> *positions = nullptr );
+        size_t positions() const;
+
+      private:
+        typedef std::array<uint8_t, 256> LookupTable_t;
+        void buildTable( const std::vector<double> &histogram, LookupTable_t &table ) const;
+        uint8_t binQuality( const uint8_t &q ) const;
+        //Private variables
+        static const uint8_t _PHRED_OFFSET = 33;
+        static const uint8_t _MAX_QUALITY  = 41;
+        bool                       _binning;
+        std::vector<LookupTable_t> _tables;           //per read position: random byte -> phred char
+        std::array<uint32_t, 256>  _error_thresholds; //per phred char: P(error) * 2^32
+        std::vector<BernoulliStream> _candidates;     //per phred char: candidate error positions at its P(error)
+        std::vector<uint64_t>      _draws;            //random draws of a quality string
+        CounterRng                 _rng;
+    };
+}
+
+#endif //GENOMEMAKER_QUALITYMODEL_H
@@ -0,0 +1,276 @@
+#include "ReadSink.h"
+
+const std::string genomeMaker::ReadSink::_MAGIC = std::string( "GMREADS\1", 8 );
+const size_t genomeMaker::ReadSink::_LINE_SIZE;
+const size_t genomeMaker::ReadSink::_QUEUE_SIZE;
+
+/**
+ * Constructor
+ * Note: a sink is an extra output of the reads of a run. The records are rendered once by the
+ *       sequencer and the batches are shared by all its sinks, each formatting and writing them
+ *       on its own thread. Mates are interleaved.
+ * Packed file layout:
+ *   header: magic, varint flags (bit 0: error-free reads), 4 letters
+ *   record: varint of ( read number << 2 | mate ), varint length, 2-bit letter index of each base
+ *           (4 per byte, first base in the low bits), varint count of the bases not in the letter set,
+ *           per such base: varint position delta and the base
+ * @param file_name Name of the file to create
+ * @param format    Format of the records
+ * @param clean     Error-free reads flag
+ */
+genomeMaker::ReadSink::ReadSink( const std::string &file_name, const FileOptions::ExtraFormat &format, const bool &clean ) :
+    _writer( file_name ),
+    _format( format ),
+    _clean( clean ),
+    _done( false ),
+    _failed( false ),
+    _records( 0 )
+{
+    _codes.fill( -1 );
+}
+
+/**
+ * Destructor
+ * Note: the writer thread is stopped when the sink is not finished (run aborted)
+ */
+genomeMaker::ReadSink::~ReadSink() {
+    if( _thread.joinable() ) {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _done = true;
+            _queue.clear();
+        }
+        _queued.notify_one();
+        _thread.join();
+    }
+}
+
+/**
+ * Opens the file and starts the writer thread
+ * @param letters Letter set of the genome (4 letters)
+ * @return Success
+ */
+bool genomeMaker::ReadSink::open( const std::string &letters ) {
+    if( letters.size() != 4 ) {
+        LOG_ERROR( "[genomeMaker::ReadSink::open( ", letters, " )] Letter set is not 4 letters." );
+        return false;
+    }
+    if( !_writer.isOpen() && !_writer.open() ) {
+        LOG_ERROR( "[genomeMaker::ReadSink::open( ", letters, " )] Could not create the file '", _writer.getFileName(), "'." );
+        return false;
+    }
+    for( size_t i = 0; i < letters.size(); i++ ) {
+        _codes[ static_cast<uint8_t>( letters[ i ] ) ] = static_cast<int8_t>( i );
+    }
+    if( _format == FileOptions::ExtraFormat::PACKED ) {
+        _buffer.append( _MAGIC );
+        appendVarInt( _clean ? 1 : 0 );
+        _buffer.append( letters );
+        if( !_writer.write( _buffer ) ) {
+            LOG_ERROR( "[genomeMaker::ReadSink::open( ", letters, " )] Could not write to '", _writer.getFileName(), "'." );
+            return false;
+        }
+        _buffer.clear();
+    }
+    _thread = std::thread( &ReadSink::run, this );
+    return true;
+}
+
+/**
+ * Hands a batch of records over to the writer thread
+ * Note: waits while the thread is behind by more than a couple of batches so memory stays bounded
+ * @param reads Batch of rendered records
+ * @return Success (false once a write has failed)
+ */
+bool genomeMaker::ReadSink::add( const std::shared_ptr<const RenderedReads> &reads ) {
+    {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _taken.wait( lock, [&]() { return _queue.size() < _QUEUE_SIZE || _failed; } );
+        if( _failed ) {
+            return false;
+        }
+        _queue.push_back( reads );
+    }
+    _queued.notify_one();
+    return true;
+}
+
+/**
+ * Writes the batches left and stops the writer thread
+ * @return Success
+ */
+bool genomeMaker::ReadSink::finish() {
+    if( _thread.joinable() ) {
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _done = true;
+        }
+        _queued.notify_one();
+        _thread.join();
+    }
+    if( _failed || !_writer.flush() ) {
+        LOG_ERROR( "[genomeMaker::ReadSink::finish()] Problem occurred whilst writing to '", _writer.getFileName(), "'." );
+        return false;
+    }
+    LOG( "[genomeMaker::ReadSink::finish()] Extra output '", _writer.getFileName(), "': ", _records, " records." );
+    return true;
+}
+
+/**
+ * Gets the format of the records
+ * @return Format
+ */
+genomeMaker::FileOptions::ExtraFormat genomeMaker::ReadSink::format() const {
+    return _format;
+}
+
+/**
+ * Checks if the sink takes the error-free reads
+ * @return Error-free reads flag
+ */
+bool genomeMaker::ReadSink::isClean() const {
+    return _clean;
+}
+
+/**
+ * Gets the number of records written
+ * @return Number of records
+ */
+uint64_t genomeMaker::ReadSink::records() const {
+    return _records;
+}
+
+/**
+ * Gets the file name of the sink
+ * @return File name
+ */
+std::string genomeMaker::ReadSink::getFileName() {
+    return _writer.getFileName();
+}
+
+/**
+ * Writer thread: formats and writes the batches in the order they were handed over
+ * Note: a batch stays in the queue until written so it counts towards the limit of add(..)
+ */
+void genomeMaker::ReadSink::run() {
+    while( true ) {
+        std::shared_ptr<const RenderedReads> reads;
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _queued.wait( lock, [&]() { return !_queue.empty() || _done; } );
+            if( _queue.empty() ) {
+                return;
+            }
+            reads = _queue.front();
+        }
+        _buffer.clear();
+        if( _format == FileOptions::ExtraFormat::PACKED ) {
+            formatPacked( *reads );
+        } else {
+            formatText( *reads );
+        }
+        const bool written = _writer.write( _buffer );
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _queue.pop_front();
+            if( !written ) {
+                _failed = true;
+            }
+        }
+        _taken.notify_one();
+        if( !written ) {
+            LOG_ERROR( "[genomeMaker::ReadSink::run()] Could not write to '", _writer.getFileName(), "'." );
+            return;
+        }
+    }
+}
+
+/**
+ * Formats a batch into FASTA/FASTQ records (as in the sequencer file)
+ * Note: error-free reads take the qualities of their read with errors, cut or padded with the
+ *       last quality when indels made the lengths differ
+ * @param reads Batch of rendered records
+ */
+void genomeMaker::ReadSink::formatText( const RenderedReads &reads ) {
+    const bool                 fastq  = _format == FileOptions::ExtraFormat::FASTQ;
+    const std::string         &source = _clean ? reads._clean : reads._sequences;
+    const std::vector<size_t> &ends   = _clean ? reads._clean_ends : reads._ends;
+    for( size_t r = 0; r < reads._numbers.size(); r++ ) {
+        const size_t begin   = r > 0 ? ends[ r - 1 ] : 0;
+        const size_t quality = r > 0 ? reads._ends[ r - 1 ] : 0;
+        const size_t length  = ends[ r ] - begin;
+        _buffer.append( fastq ? "@read#" : ">read#" ).append( std::to_string( reads._numbers[ r ] ) );
+        if( reads._mates[ r ] > 0 ) {
+            _buffer.append( reads._mates[ r ] == 1 ? "/1" : "/2" );
+        }
+        _buffer.push_back( '\n' );
+        if( fastq ) {
+            const size_t qualities = reads._ends[ r ] - quality;
+            _buffer.append( source, begin, length ).append( "\n+\n" );
+            _buffer.append( reads._qualities, quality, std::min( length, qualities ) );
+            if( length > qualities ) {
+                _buffer.append( length - qualities, qualities > 0 ? reads._qualities[ quality + qualities - 1 ] : '!' );
+            }
+            _buffer.push_back( '\n' );
+        } else {
+            for( size_t line = 0; line < length; line += _LINE_SIZE ) {
+                if( line > 0 ) {
+                    _buffer.push_back( '\n' );
+                }
+                _buffer.append( source, begin + line, std::min( _LINE_SIZE, length - line ) );
+            }
+            _buffer.append( "\n\n" );
+        }
+    }
+    _records += reads._numbers.size();
+}
+
+/**
+ * Formats a batch into packed records (see the constructor for the layout)
+ * @param reads Batch of rendered records
+ */
+void genomeMaker::ReadSink::formatPacked( const RenderedReads &reads ) {
+    const std::string         &source = _clean ? reads._clean : reads._sequences;
+    const std::vector<size_t> &ends   = _clean ? reads._clean_ends : reads._ends;
+    std::vector<size_t> others; //positions of the bases not in the letter set
+    for( size_t r = 0; r < reads._numbers.size(); r++ ) {
+        const size_t begin  = r > 0 ? ends[ r - 1 ] : 0;
+        const size_t length = ends[ r ] - begin;
+        const char  *bases  = source.data() + begin;
+        appendVarInt( ( reads._numbers[ r ] << 2 ) | reads._mates[ r ] );
+        appendVarInt( length );
+        others.clear();
+        for( size_t i = 0; i < length; i += 4 ) {
+            uint8_t byte { 0 };
+            for( size_t b = 0; b < 4 && i + b < length; b++ ) {
+                const int8_t code = _codes[ static_cast<uint8_t>( bases[ i + b ] ) ];
+                if( code < 0 ) {
+                    others.push_back( i + b );
+                } else {
+                    byte |= static_cast<uint8_t>( code << ( 2 * b ) );
+                }
+            }
+            _buffer.push_back( static_cast<char>( byte ) );
+        }
+        appendVarInt( others.size() );
+        size_t last { 0 };
+        for( const size_t &position : others ) {
+            appendVarInt( position - last );
+            _buffer.push_back( bases[ position ] );
+            last = position;
+        }
+    }
+    _records += reads._numbers.size();
+}
+
+/**
+ * Appends a variable length integer (7 bits per byte, low bits first) to the buffer
+ * @param value Value
+ */
+void genomeMaker::ReadSink::appendVarInt( uint64_t value ) {
+    while( value >= 0x80 ) {
+        _buffer.push_back( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+    }
+    _buffer.push_back( static_cast<char>( value ) );
+}
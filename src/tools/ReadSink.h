@@ -0,0 +1,57 @@
+#ifndef GENOMEMAKER_READSINK_H
+#define GENOMEMAKER_READSINK_H
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileWriter.h"
+
+#include "../containers/FileOptions.h"
+#include "../containers/RenderedReads.h"
+
+namespace genomeMaker {
+    class ReadSink {
+      public:
+        ReadSink( const std::string &file_name, const FileOptions::ExtraFormat &format, const bool &clean );
+        ReadSink( const ReadSink &sink ) = delete;
+        ~ReadSink();
+        bool open( const std::string &letters );
+        bool add( const std::shared_ptr<const RenderedReads> &reads );
+        bool finish();
+        FileOptions::ExtraFormat format() const;
+        bool isClean() const;
+        uint64_t records() const;
+        std::string getFileName();
+        static const std::string _MAGIC;
+
+      private:
+        void run();
+        void formatText( const RenderedReads &reads );
+        void formatPacked( const RenderedReads &reads );
+        void appendVarInt( uint64_t value );
+        //Private variables
+        static const size_t _LINE_SIZE = 71; //per line max char write in FASTA records (as the sequencer file)
+        static const size_t _QUEUE_SIZE = 2; //batches handed over and not written yet
+        eadlib::io::FileWriter   _writer;
+        FileOptions::ExtraFormat _format;
+        bool                     _clean;
+        std::array<int8_t, 256>  _codes;   //index of each letter in the letter set (-1: not in it)
+        std::string              _buffer;  //formatted records (writer thread)
+        std::deque<std::shared_ptr<const RenderedReads>> _queue; //batches waiting or being written
+        std::mutex               _mutex;
+        std::condition_variable  _queued;
+        std::condition_variable  _taken;
+        bool                     _done;
+        bool                     _failed;
+        std::thread              _thread;
+        uint64_t                 _records;
+    };
+}
+
+#endif //GENOMEMAKER_READSINK_H
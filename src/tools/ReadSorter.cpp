@@ -0,0 +1,344 @@
+#include "ReadSorter.h"
+
+/**
+ * Constructor
+ * Note: reads are held in memory up to the limit then sorted by key and spilled to a run file
+ *       on disk. The runs are merged into the outputs at the end so memory stays bounded
+ *       whatever the number of reads. Reads with the same key keep the order they came in.
+ * @param writer       Writer of the sequencer file
+ * @param run_prefix   Prefix of the run files (a number is appended)
+ * @param memory_limit Memory for the reads held before being spilled (bytes)
+ */
+genomeMaker::ReadSorter::ReadSorter( eadlib::io::FileWriter &writer, const std::string &run_prefix, const size_t &memory_limit ) :
+    _writer( writer ),
+    _mate_writer( nullptr ),
+    _truth_writer( nullptr ),
+    _depth_index( nullptr ),
+    _run_prefix( run_prefix ),
+    _memory_limit( std::max( memory_limit, (size_t) _MIN_RUN_BUFFER ) ),
+    _record_bytes( 0 ),
+    _mate_bytes( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::ReadSorter::~ReadSorter() {
+    removeRuns();
+}
+
+/**
+ * Sets the writer of the mate #2 file
+ * @param mate_writer EADlib File Writer
+ */
+void genomeMaker::ReadSorter::setMateWriter( eadlib::io::FileWriter &mate_writer ) {
+    _mate_writer = &mate_writer;
+}
+
+/**
+ * Sets the writer of the truth records (written in the same order as the reads)
+ * @param truth_writer Truth writer
+ */
+void genomeMaker::ReadSorter::setTruthWriter( genomeMaker::TruthWriter &truth_writer ) {
+    _truth_writer = &truth_writer;
+}
+
+/**
+ * Sets the index of the depths reached as the reads are written
+ * @param depth_index Depth index (opened)
+ */
+void genomeMaker::ReadSorter::setDepthIndex( genomeMaker::DepthIndex &depth_index ) {
+    _depth_index = &depth_index;
+}
+
+/**
+ * Adds a read
+ * Payload: u32 record size, u32 mate record size, u32 truth count, u32 bases, record, mate record,
+ *          per truth record: u64 position, u64 read number, u32 ( mate << 1 | reverse ),
+ *          u32 length, u32 adapter bases, u32 error count,
+ *          per error: u32 position, u32 ( type << 8 | base )
+ * @param key         Sort key
+ * @param record      Record(s) of the read for the sequencer file
+ * @param mate_record Record of mate #2 for the mate file
+ * @param truth       Truth records of the read's segments
+ * @param bases       Bases of the read (mates included)
+ * @return Success
+ */
+bool genomeMaker::ReadSorter::add( const uint64_t &key,
+                                   const std::string &record,
+                                   const std::string &mate_record,
+                                   const std::vector<TruthRecord> &truth,
+                                   const uint32_t &bases ) {
+    if( _buffer.capacity() < _memory_limit / 2 ) {
+        _buffer.reserve( _memory_limit / 2 );
+    }
+    const size_t offset = _buffer.size();
+    append( static_cast<uint32_t>( record.size() ) );
+    append( static_cast<uint32_t>( mate_record.size() ) );
+    append( static_cast<uint32_t>( truth.size() ) );
+    append( bases );
+    _buffer.append( record );
+    _buffer.append( mate_record );
+    for( const TruthRecord &segment : truth ) {
+        append( segment._position );
+        append( segment._read );
+        append( segment._duplicate );
+        append( static_cast<uint32_t>( ( segment._mate << 1 ) | ( segment._reverse ? 1 : 0 ) ) );
+        append( segment._length );
+        append( segment._adapter_bases );
+        append( static_cast<uint32_t>( segment._errors.size() ) );
+        for( const ErrorModel::Error &error : segment._errors ) {
+            append( error._position );
+            append( static_cast<uint32_t>( ( static_cast<uint32_t>( error._type ) << 8 ) | static_cast<unsigned char>( error._base ) ) );
+        }
+    }
+    _items.push_back( { key, offset, static_cast<uint32_t>( _buffer.size() - offset ) } );
+    if( _buffer.size() + _items.size() * sizeof( Item ) >= _memory_limit / 2 ) { //vector growth can double either
+        return spill();
+    }
+    return true;
+}
+
+/**
+ * Writes all the reads to the outputs in key order
+ * Note: when everything fitted in memory the reads are written straight away
+ * @return Success
+ */
+bool genomeMaker::ReadSorter::finish() {
+    if( _runs.empty() ) {
+        std::stable_sort( _items.begin(), _items.end(), []( const Item &a, const Item &b ) { return a._key < b._key; } );
+        for( const Item &item : _items ) {
+            if( !writeItem( &_buffer[ item._offset ] ) ) {
+                return false;
+            }
+        }
+        _items.clear();
+        _buffer.clear();
+        return flushOutput( true );
+    }
+    if( !_items.empty() && !spill() ) {
+        return false;
+    }
+    std::string().swap( _buffer );
+    std::vector<Item>().swap( _items );
+    return merge() && flushOutput( true );
+}
+
+/**
+ * Gets the number of runs spilled to disk so far
+ * @return Number of runs
+ */
+size_t genomeMaker::ReadSorter::runs() const {
+    return _runs.size();
+}
+
+/**
+ * Sorts the reads held in memory and writes them to a new run file
+ * Run file: per read: u64 key, u32 payload size, payload
+ * @return Success
+ */
+bool genomeMaker::ReadSorter::spill() {
+    std::stable_sort( _items.begin(), _items.end(), []( const Item &a, const Item &b ) { return a._key < b._key; } );
+    const std::string file_name = _run_prefix + "." + std::to_string( _runs.size() );
+    std::FILE *file = std::fopen( file_name.c_str(), "wb" );
+    if( file == nullptr ) {
+        LOG_ERROR( "[genomeMaker::ReadSorter::spill()] Could not create the run file '", file_name, "'." );
+        std::cerr << "Error: could not create the temporary file '" << file_name << "'." << std::endl;
+        return false;
+    }
+    _runs.emplace_back( file_name );
+    bool success { true };
+    for( const Item &item : _items ) {
+        success = success
+                  && std::fwrite( &item._key, sizeof( item._key ), 1, file ) == 1
+                  && std::fwrite( &item._size, sizeof( item._size ), 1, file ) == 1
+                  && std::fwrite( &_buffer[ item._offset ], 1, item._size, file ) == item._size;
+    }
+    success = std::fclose( file ) == 0 && success;
+    if( !success ) {
+        LOG_ERROR( "[genomeMaker::ReadSorter::spill()] Could not write the run file '", file_name, "'." );
+        std::cerr << "Error: could not write to the temporary file '" << file_name << "'." << std::endl;
+        return false;
+    }
+    LOG_DEBUG( "[genomeMaker::ReadSorter::spill()] Run #", _runs.size(), ": ", _items.size(), " reads to '", file_name, "'." );
+    _items.clear();
+    _buffer.clear();
+    return true;
+}
+
+/**
+ * Merges the runs into the outputs
+ * Note: the memory limit is shared out between the read buffers of the runs
+ * @return Success
+ */
+bool genomeMaker::ReadSorter::merge() {
+    typedef std::pair<uint64_t, size_t> Head_t; //key, run index (earlier runs first on equal keys)
+    std::vector<Run> runs( _runs.size() );
+    std::priority_queue<Head_t, std::vector<Head_t>, std::greater<Head_t>> heads;
+    const size_t run_buffer = std::max( _memory_limit / ( 2 * _runs.size() ), (size_t) _MIN_RUN_BUFFER );
+    LOG( "[genomeMaker::ReadSorter::merge()] Merging ", _runs.size(), " runs into '", _writer.getFileName(), "'." );
+    bool success { true };
+    for( size_t i = 0; i < _runs.size() && success; i++ ) {
+        runs[ i ]._file = std::fopen( _runs[ i ].c_str(), "rb" );
+        if( runs[ i ]._file == nullptr ) {
+            LOG_ERROR( "[genomeMaker::ReadSorter::merge()] Could not open the run file '", _runs[ i ], "'." );
+            success = false;
+            break;
+        }
+        runs[ i ]._stream_buffer.resize( run_buffer );
+        std::setvbuf( runs[ i ]._file, runs[ i ]._stream_buffer.data(), _IOFBF, run_buffer );
+        if( readItem( runs[ i ] ) ) {
+            heads.emplace( runs[ i ]._key, i );
+        }
+    }
+    while( success && !heads.empty() ) {
+        const size_t i = heads.top().second;
+        heads.pop();
+        success = writeItem( runs[ i ]._payload.data() ) && flushOutput( false );
+        if( readItem( runs[ i ] ) ) {
+            heads.emplace( runs[ i ]._key, i );
+        }
+    }
+    for( Run &run : runs ) {
+        if( run._file != nullptr ) {
+            std::fclose( run._file );
+        }
+    }
+    removeRuns();
+    if( !success ) {
+        std::cerr << "Error: could not merge the temporary files into '" << _writer.getFileName() << "'." << std::endl;
+    }
+    return success;
+}
+
+/**
+ * Reads the next read of a run
+ * @param run Run
+ * @return Success (false at the end of the run)
+ */
+bool genomeMaker::ReadSorter::readItem( Run &run ) {
+    uint32_t size { 0 };
+    if( std::fread( &run._key, sizeof( run._key ), 1, run._file ) != 1
+        || std::fread( &size, sizeof( size ), 1, run._file ) != 1 ) {
+        return false;
+    }
+    run._payload.resize( size );
+    return std::fread( &run._payload[ 0 ], 1, size, run._file ) == size;
+}
+
+/**
+ * Writes a read's payload to the outputs
+ * @param payload Payload of the read
+ * @return Success
+ */
+bool genomeMaker::ReadSorter::writeItem( const char *payload ) {
+    const char    *cursor      = payload;
+    const uint32_t record_size = extract32( cursor );
+    const uint32_t mate_size   = extract32( cursor );
+    const uint32_t segments    = extract32( cursor );
+    const uint32_t bases       = extract32( cursor );
+    _output.append( cursor, record_size );
+    _record_bytes += record_size;
+    cursor        += record_size;
+    if( _mate_writer ) {
+        _mate_output.append( cursor, mate_size );
+        _mate_bytes += mate_size;
+    }
+    cursor += mate_size;
+    if( _depth_index ) {
+        _depth_index->add( bases, _record_bytes, _mate_bytes );
+    }
+    for( uint32_t i = 0; i < segments; i++ ) {
+        _truth._position      = extract64( cursor );
+        _truth._read          = extract64( cursor );
+        _truth._duplicate     = extract64( cursor );
+        const uint32_t flags  = extract32( cursor );
+        _truth._reverse       = ( flags & 1 ) != 0;
+        _truth._mate          = static_cast<uint8_t>( flags >> 1 );
+        _truth._length        = extract32( cursor );
+        _truth._adapter_bases = extract32( cursor );
+        _truth._errors.resize( extract32( cursor ) );
+        for( ErrorModel::Error &error : _truth._errors ) {
+            error._position     = extract32( cursor );
+            const uint32_t code = extract32( cursor );
+            error._type         = static_cast<ErrorModel::Type>( code >> 8 );
+            error._base         = static_cast<char>( code & 0xFF );
+        }
+        if( _truth_writer ) {
+            _truth_writer->add( _truth );
+        }
+    }
+    return _output.size() < _OUTPUT_BUFFER_SIZE || flushOutput( true );
+}
+
+/**
+ * Writes the output buffers to the files
+ * @param force Write even when the buffers are not full
+ * @return Success
+ */
+bool genomeMaker::ReadSorter::flushOutput( const bool &force ) {
+    if( !force && _output.size() < _OUTPUT_BUFFER_SIZE ) {
+        return true;
+    }
+    if( !_output.empty() && !_writer.write( _output ) ) {
+        LOG_ERROR( "[genomeMaker::ReadSorter::flushOutput(..)] Could not write to '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _output.clear();
+    if( _mate_writer && !_mate_output.empty() && !_mate_writer->write( _mate_output ) ) {
+        LOG_ERROR( "[genomeMaker::ReadSorter::flushOutput(..)] Could not write to '", _mate_writer->getFileName(), "'." );
+        return false;
+    }
+    _mate_output.clear();
+    return !_truth_writer || _truth_writer->flush();
+}
+
+/**
+ * Removes the run files from the disk
+ */
+void genomeMaker::ReadSorter::removeRuns() {
+    for( const std::string &file_name : _runs ) {
+        std::remove( file_name.c_str() );
+    }
+    _runs.clear();
+}
+
+/**
+ * Appends a 32bit value to the buffer
+ * @param value Value
+ */
+void genomeMaker::ReadSorter::append( const uint32_t &value ) {
+    _buffer.append( reinterpret_cast<const char *>( &value ), sizeof( value ) );
+}
+
+/**
+ * Appends a 64bit value to the buffer
+ * @param value Value
+ */
+void genomeMaker::ReadSorter::append( const uint64_t &value ) {
+    _buffer.append( reinterpret_cast<const char *>( &value ), sizeof( value ) );
+}
+
+/**
+ * Extracts a 32bit value from a payload and moves the cursor past it
+ * @param cursor Position in the payload
+ * @return Value
+ */
+uint32_t genomeMaker::ReadSorter::extract32( const char *&cursor ) {
+    uint32_t value;
+    std::memcpy( &value, cursor, sizeof( value ) );
+    cursor += sizeof( value );
+    return value;
+}
+
+/**
+ * Extracts a 64bit value from a payload and moves the cursor past it
+ * @param cursor Position in the payload
+ * @return Value
+ */
+uint64_t genomeMaker::ReadSorter::extract64( const char *&cursor ) {
+    uint64_t value;
+    std::memcpy( &value, cursor, sizeof( value ) );
+    cursor += sizeof( value );
+    return value;
+}
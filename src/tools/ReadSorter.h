@@ -0,0 +1,80 @@
+#ifndef GENOMEMAKER_READSORTER_H
+#define GENOMEMAKER_READSORTER_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileWriter.h"
+
+#include "TruthWriter.h"
+#include "DepthIndex.h"
+#include "../containers/TruthRecord.h"
+
+namespace genomeMaker {
+    class ReadSorter {
+      public:
+        ReadSorter( eadlib::io::FileWriter &writer, const std::string &run_prefix, const size_t &memory_limit );
+        ReadSorter( const ReadSorter &sorter ) = delete;
+        ~ReadSorter();
+        void setMateWriter( eadlib::io::FileWriter &mate_writer );
+        void setTruthWriter( genomeMaker::TruthWriter &truth_writer );
+        void setDepthIndex( genomeMaker::DepthIndex &depth_index );
+        bool add( const uint64_t &key,
+                  const std::string &record,
+                  const std::string &mate_record,
+                  const std::vector<TruthRecord> &truth,
+                  const uint32_t &bases );
+        bool finish();
+        size_t runs() const;
+
+      private:
+        //Read held in memory (payload in the buffer)
+        struct Item {
+            uint64_t _key;
+            size_t   _offset;
+            uint32_t _size;
+        };
+        //Sorted run on disk being merged
+        struct Run {
+            std::FILE        *_file;
+            std::vector<char> _stream_buffer;
+            uint64_t          _key;
+            std::string       _payload;
+        };
+        bool spill();
+        bool merge();
+        bool readItem( Run &run );
+        bool writeItem( const char *payload );
+        bool flushOutput( const bool &force );
+        void removeRuns();
+        void append( const uint32_t &value );
+        void append( const uint64_t &value );
+        static uint32_t extract32( const char *&cursor );
+        static uint64_t extract64( const char *&cursor );
+        //Private variables
+        static const size_t _OUTPUT_BUFFER_SIZE = 1 << 22;
+        static const size_t _MIN_RUN_BUFFER     = 1 << 16; //smallest read buffer of a run when merging
+        eadlib::io::FileWriter  &_writer;
+        eadlib::io::FileWriter  *_mate_writer;
+        TruthWriter             *_truth_writer;
+        DepthIndex              *_depth_index;
+        std::string              _run_prefix;
+        size_t                   _memory_limit;
+        std::string              _buffer;      //payloads of the reads held in memory
+        std::vector<Item>        _items;
+        std::vector<std::string> _runs;        //file names of the sorted runs on disk
+        std::string              _output;
+        std::string              _mate_output;
+        TruthRecord              _truth;
+        uint64_t                 _record_bytes; //bytes of the reads written to the sequencer file
+        uint64_t                 _mate_bytes;   //bytes of the reads written to the mate file
+    };
+}
+
+#endif //GENOMEMAKER_READSORTER_H
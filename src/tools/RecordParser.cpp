@@ -0,0 +1,157 @@
+#include "RecordParser.h"
+
+/**
+ * Constructor
+ * Note: the format is detected from the first character of the data ('>' FASTA, '@' FASTQ)
+ * @param data Reads file content
+ * @param size Size of the content
+ */
+genomeMaker::RecordParser::RecordParser( const char *data, const uint64_t &size ) :
+    _data( data ),
+    _cursor( data ),
+    _end( data + size ),
+    _format( Format::FASTA ),
+    _valid( true ),
+    _copy_sequence( true )
+{
+    while( _cursor < _end && ( *_cursor == '\n' || *_cursor == '\r' ) ) {
+        _cursor++;
+    }
+    if( _cursor < _end ) {
+        if( *_cursor == '@' ) {
+            _format = Format::FASTQ;
+        } else if( *_cursor != '>' ) {
+            LOG_ERROR( "[genomeMaker::RecordParser::RecordParser(..)] Data is neither FASTA nor FASTQ." );
+            _valid = false;
+        }
+    }
+}
+
+/**
+ * Destructor
+ */
+genomeMaker::RecordParser::~RecordParser() {}
+
+/**
+ * Sets whether the sequences get copied into the records
+ * Note: without the copy only the boundaries, name and length of the records are worked out
+ * @param copy Copy flag
+ */
+void genomeMaker::RecordParser::setSequenceCopy( const bool &copy ) {
+    _copy_sequence = copy;
+}
+
+/**
+ * Parses the next record
+ * Note: record boundaries are found with memchr on the new lines rather than per character reads
+ * @param record Record to fill
+ * @return Success (false when there are no more records or the data is malformed)
+ */
+bool genomeMaker::RecordParser::next( Record &record ) {
+    while( _cursor < _end && ( *_cursor == '\n' || *_cursor == '\r' ) ) {
+        _cursor++;
+    }
+    if( !_valid || _cursor >= _end ) {
+        return false;
+    }
+    const char marker = _format == Format::FASTA ? '>' : '@';
+    if( *_cursor != marker ) {
+        LOG_ERROR( "[genomeMaker::RecordParser::next(..)] Expected '", marker, "' at byte ", _cursor - _data, "." );
+        _valid = false;
+        return false;
+    }
+    record._begin = _cursor;
+    const char *eol     = lineEnd( _cursor );
+    record._name        = _cursor + 1;
+    record._name_length = static_cast<size_t>( eol - record._name );
+    record._sequence.clear();
+    record._length      = 0;
+    record._qualities   = nullptr;
+    _cursor = nextLine( eol );
+    if( _format == Format::FASTA ) {
+        while( _cursor < _end && *_cursor != '>' ) {
+            eol = lineEnd( _cursor );
+            if( _copy_sequence ) {
+                record._sequence.append( _cursor, eol );
+            }
+            record._length += static_cast<size_t>( eol - _cursor );
+            _cursor = nextLine( eol );
+        }
+    } else {
+        eol = lineEnd( _cursor );
+        if( _copy_sequence ) {
+            record._sequence.assign( _cursor, eol );
+        }
+        record._length = static_cast<size_t>( eol - _cursor );
+        _cursor = nextLine( eol );
+        if( _cursor >= _end || *_cursor != '+' ) {
+            LOG_ERROR( "[genomeMaker::RecordParser::next(..)] Missing '+' line in FASTQ record at byte ", _cursor - _data, "." );
+            _valid = false;
+            return false;
+        }
+        eol     = lineEnd( _cursor );
+        _cursor = nextLine( eol );
+        eol     = lineEnd( _cursor );
+        if( static_cast<size_t>( eol - _cursor ) != record._length ) {
+            LOG_ERROR( "[genomeMaker::RecordParser::next(..)] Quality and sequence lengths differ in FASTQ record at byte ", _cursor - _data, "." );
+            _valid = false;
+            return false;
+        }
+        record._qualities = _cursor;
+        _cursor = nextLine( eol );
+    }
+    while( _cursor < _end && ( *_cursor == '\n' || *_cursor == '\r' ) ) {
+        _cursor++;
+    }
+    record._end = _cursor;
+    return true;
+}
+
+/**
+ * Gets the detected format
+ * @return Format
+ */
+genomeMaker::RecordParser::Format genomeMaker::RecordParser::format() const {
+    return _format;
+}
+
+/**
+ * Gets the position of the parser in the data
+ * @return Offset of the next record
+ */
+uint64_t genomeMaker::RecordParser::position() const {
+    return static_cast<uint64_t>( _cursor - _data );
+}
+
+/**
+ * Checks the parser state
+ * @return Valid state (false when the data is malformed)
+ */
+bool genomeMaker::RecordParser::isValid() const {
+    return _valid;
+}
+
+/**
+ * Finds the end of a line (without the carriage return on Windows line endings)
+ * @param from Start of the line
+ * @return Position of the line's end
+ */
+const char * genomeMaker::RecordParser::lineEnd( const char *from ) const {
+    const char *eol = static_cast<const char *>( memchr( from, '\n', static_cast<size_t>( _end - from ) ) );
+    if( !eol ) {
+        eol = _end;
+    }
+    return ( eol > from && *( eol - 1 ) == '\r' ) ? eol - 1 : eol;
+}
+
+/**
+ * Moves past the end of a line
+ * @param eol End of the line (as given by lineEnd(..))
+ * @return Start of the next line
+ */
+const char * genomeMaker::RecordParser::nextLine( const char *eol ) const {
+    if( eol < _end && *eol == '\r' ) {
+        eol++;
+    }
+    return eol < _end ? eol + 1 : _end;
+}
@@ -0,0 +1,46 @@
+#ifndef GENOMEMAKER_RECORDPARSER_H
+#define GENOMEMAKER_RECORDPARSER_H
+
+#include <string>
+#include <cstring>
+
+#include "eadlib/logger/Logger.h"
+
+namespace genomeMaker {
+    class RecordParser {
+      public:
+        enum class Format {
+            FASTA,
+            FASTQ
+        };
+        struct Record {
+            const char *_begin;      //first byte of the record in the data
+            const char *_end;        //one past the last byte of the record (including its trailing new lines)
+            const char *_name;       //read name (without the '>'/'@' marker)
+            size_t      _name_length;
+            std::string _sequence;   //sequence with the FASTA line wraps removed
+            size_t      _length;     //number of bases in the sequence
+            const char *_qualities;  //FASTQ qualities (nullptr for FASTA)
+        };
+        RecordParser( const char *data, const uint64_t &size );
+        ~RecordParser();
+        void setSequenceCopy( const bool &copy );
+        bool next( Record &record );
+        Format format() const;
+        uint64_t position() const;
+        bool isValid() const;
+
+      private:
+        const char * lineEnd( const char *from ) const;
+        const char * nextLine( const char *eol ) const;
+        //Private variables
+        const char *_data;
+        const char *_cursor;
+        const char *_end;
+        Format      _format;
+        bool        _valid;
+        bool        _copy_sequence; //sequences are copied into the records
+    };
+}
+
+#endif //GENOMEMAKER_RECORDPARSER_H
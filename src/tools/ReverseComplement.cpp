@@ -0,0 +1,132 @@
+#include "ReverseComplement.h"
+
+#if defined( __SSSE3__ )
+#include <tmmintrin.h>
+#endif
+
+namespace {
+    /**
+     * Creates a complement lookup table
+     * Note: anything that is not a base letter is left as is
+     * @param rna RNA letter set flag ('U' instead of 'T')
+     * @return Complement lookup table
+     */
+    std::array<char, 256> createComplementTable( const bool &rna ) {
+        std::array<char, 256> table;
+        for( size_t c = 0; c < table.size(); c++ ) {
+            table[ c ] = static_cast<char>( c );
+        }
+        table[ 'A' ] = rna ? 'U' : 'T';
+        table[ 'C' ] = 'G';
+        table[ 'G' ] = 'C';
+        table[ 'T' ] = 'A';
+        table[ 'U' ] = 'A';
+        table[ 'a' ] = rna ? 'u' : 't';
+        table[ 'c' ] = 'g';
+        table[ 'g' ] = 'c';
+        table[ 't' ] = 'a';
+        table[ 'u' ] = 'a';
+        return table;
+    }
+
+    const std::array<char, 256> DNA_COMPLEMENT = createComplementTable( false );
+    const std::array<char, 256> RNA_COMPLEMENT = createComplementTable( true );
+
+#if defined( __SSSE3__ )
+    /**
+     * Reverse complements a block of 16 characters
+     * Note: letters are folded to upper case and complemented through a shuffle on their low
+     *       nibble (A=1, C=3, G=7, T=4, U=5). Anything else is blended back unchanged.
+     * @param block   Block of 16 characters
+     * @param lookup  Complement shuffle table (indexed by low nibble)
+     * @return Reverse complemented block
+     */
+    inline __m128i reverseComplementBlock( const __m128i &block, const __m128i &lookup ) {
+        const __m128i reverse_index = _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+        const __m128i case_bit      = _mm_set1_epi8( 0x20 );
+        const __m128i upper         = _mm_andnot_si128( case_bit, block );
+        const __m128i letters       = _mm_setr_epi8( -1, 'A', -1, 'C', 'T', 'U', -1, 'G', -1, -1, -1, -1, -1, -1, -1, -1 );
+        const __m128i nibble        = _mm_and_si128( upper, _mm_set1_epi8( 0x0F ) );
+        const __m128i valid         = _mm_cmpeq_epi8( upper, _mm_shuffle_epi8( letters, nibble ) );
+        const __m128i complement    = _mm_or_si128( _mm_shuffle_epi8( lookup, nibble ), _mm_and_si128( block, case_bit ) );
+        const __m128i result        = _mm_or_si128( _mm_and_si128( valid, complement ), _mm_andnot_si128( valid, block ) );
+        return _mm_shuffle_epi8( result, reverse_index );
+    }
+#endif
+}
+
+/**
+ * Reverse complements a sequence in place
+ * Note: uses 16 byte shuffles from both ends when built with SSSE3 support
+ * @param sequence Sequence
+ * @param length   Length of the sequence
+ * @param rna      RNA letter set flag
+ */
+void genomeMaker::sequence::reverseComplement( char *sequence, const size_t &length, const bool &rna ) {
+    char *front = sequence;
+    char *back  = sequence + length;
+#if defined( __SSSE3__ )
+    const __m128i lookup = _mm_setr_epi8( 0, rna ? 'U' : 'T', 0, 'G', 'A', 'A', 0, 'C', 0, 0, 0, 0, 0, 0, 0, 0 );
+    while( back - front >= 32 ) {
+        back -= 16;
+        const __m128i front_block = _mm_loadu_si128( reinterpret_cast<const __m128i *>( front ) );
+        const __m128i back_block  = _mm_loadu_si128( reinterpret_cast<const __m128i *>( back ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( front ), reverseComplementBlock( back_block, lookup ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( back ), reverseComplementBlock( front_block, lookup ) );
+        front += 16;
+    }
+#endif
+    const std::array<char, 256> &table = rna ? RNA_COMPLEMENT : DNA_COMPLEMENT;
+    while( front < back ) {
+        --back;
+        const char c = table[ static_cast<uint8_t>( *front ) ];
+        *front = table[ static_cast<uint8_t>( *back ) ];
+        *back  = c;
+        ++front;
+    }
+}
+
+/**
+ * Reverse complements a sequence in place
+ * @param sequence Sequence
+ * @param rna      RNA letter set flag
+ */
+void genomeMaker::sequence::reverseComplement( std::string &sequence, const bool &rna ) {
+    if( !sequence.empty() ) {
+        reverseComplement( &sequence[ 0 ], sequence.size(), rna );
+    }
+}
+
+/**
+ * Writes the reverse complement of a sequence into a buffer
+ * Note: single pass from the back of the sequence (16 byte shuffles when built with SSSE3 support,
+ *       the last one overlapping) so a window of the genome can be rendered reversed without an
+ *       intermediate copy
+ * @param sequence Sequence
+ * @param length   Length of the sequence
+ * @param output   Buffer to write to (at least 'length' long, not overlapping the sequence)
+ * @param rna      RNA letter set flag
+ */
+void genomeMaker::sequence::reverseComplement( const char *sequence, const size_t &length, char *output, const bool &rna ) {
+    const char *back = sequence + length;
+    char       *out  = output;
+    char       *end  = output + length;
+#if defined( __SSSE3__ )
+    const __m128i lookup = _mm_setr_epi8( 0, rna ? 'U' : 'T', 0, 'G', 'A', 'A', 0, 'C', 0, 0, 0, 0, 0, 0, 0, 0 );
+    while( end - out >= 16 ) {
+        back -= 16;
+        const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i *>( back ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( out ), reverseComplementBlock( block, lookup ) );
+        out += 16;
+    }
+    if( out < end && length >= 16 ) { //the rest as the last block, overlapping what is already written
+        const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i *>( sequence ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( end - 16 ), reverseComplementBlock( block, lookup ) );
+        return;
+    }
+#endif
+    const std::array<char, 256> &table = rna ? RNA_COMPLEMENT : DNA_COMPLEMENT;
+    while( out < end ) {
+        *out++ = table[ static_cast<uint8_t>( *--back ) ];
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef GENOMEMAKER_REVERSECOMPLEMENT_H
+#define GENOMEMAKER_REVERSECOMPLEMENT_H
+
+#include <string>
+#include <array>
+
+namespace genomeMaker {
+    namespace sequence {
+        void reverseComplement( char *sequence, const size_t &length, const bool &rna );
+        void reverseComplement( std::string &sequence, const bool &rna );
+        void reverseComplement( const char *sequence, const size_t &length, char *output, const bool &rna );
+    }
+}
+
+#endif //GENOMEMAKER_REVERSECOMPLEMENT_H
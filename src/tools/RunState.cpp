@@ -0,0 +1,323 @@
+#include "RunState.h"
+
+const std::string genomeMaker::RunState::_HEADER = "#genomeMaker run state 1";
+
+/**
+ * Constructor
+ * State file layout (text): header line then one 'name<TAB>value' line per entry. The reads
+ * only depend on the seed, their number and the options so this is all a top-up run needs to
+ * carry on where the reads on disk stop.
+ */
+genomeMaker::RunState::RunState() :
+    _reads( 0 ),
+    _parts( 0 ),
+    _depth( 0 ),
+    _truth_position( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::RunState::~RunState() {}
+
+/**
+ * Sets the parameters of the run from the options the reads depend on
+ * Note: the depth and the outputs that are not appended to (tracks, indices) are left out
+ * @param options Sequencer options of the read set
+ */
+void genomeMaker::RunState::setParameters( const FileOptions &options ) {
+    auto number = []( const double &value ) {
+        std::ostringstream stream;
+        stream.precision( 17 );
+        stream << value;
+        return stream.str();
+    };
+    _parameters.clear();
+    addParameter( "genome", options._genome_file );
+    addParameter( "seed", std::to_string( options._seed ) );
+    addParameter( "read_length", std::to_string( options._read_length ) );
+    addParameter( "tiling", std::to_string( options._tile_stride ) );
+    addParameter( "error_rate", number( options._error_rate ) );
+    addParameter( "strands", options._both_strands ? "both" : "forward" );
+    addParameter( "format", options._read_format == FileOptions::ReadFormat::FASTQ ? "fastq" : "fasta" );
+    addParameter( "base_errors", number( options._substitution_rate ) + " " + number( options._insertion_rate ) + " " + number( options._deletion_rate ) );
+    addParameter( "error_ramp", number( options._error_ramp ) );
+    addParameter( "error_profile", options._error_profile );
+    addParameter( "error_matrix", options._error_matrix );
+    addParameter( "error_hotspots", options._error_hotspots );
+    addParameter( "pairing", std::to_string( static_cast<int>( options._pairing ) ) + " " + number( options._insert_mean ) + " " + number( options._insert_sd ) );
+    addParameter( "mate_file", options._mate_file );
+    addParameter( "long_reads", options._long_reads ? number( options._long_mean ) + " " + number( options._long_sd ) + " " + options._long_lengths : "" );
+    addParameter( "chimera_rate", number( options._chimera_rate ) );
+    addParameter( "duplicates", number( options._duplicate_rate ) + " " + number( options._mutation_rate ) + " " + std::to_string( options._reservoir_size ) );
+    addParameter( "truth_file", options._truth_file );
+    addParameter( "targets", options._target_file + " " + number( options._off_target_rate ) );
+    addParameter( "coverage_bias", ( options._gc_bias ? number( options._gc_peak ) + " " + number( options._gc_sd ) : "-" )
+                                   + " " + number( options._overdispersion ) + " " + std::to_string( options._bias_window ) );
+    addParameter( "read_order", std::to_string( static_cast<int>( options._read_order ) ) );
+    addParameter( "quality", options._quality_profile + " " + std::to_string( options._quality_start ) + " "
+                             + std::to_string( options._quality_end ) + ( options._quality_binning ? " binned" : "" ) );
+}
+
+/**
+ * Gets the parameters of the run into the options the reads depend on (inverse of setParameters(..))
+ * Note: used as the defaults of a top-up so only the new depth needs to be given
+ * @param options Sequencer options to set
+ * @return Success (false when a parameter is missing or malformed)
+ */
+bool genomeMaker::RunState::getParameters( FileOptions &options ) const {
+    auto converter = eadlib::tool::Convert();
+    try {
+        const auto genome         = parameter( "genome", 1 );
+        const auto seed           = parameter( "seed", 1 );
+        const auto read_length    = parameter( "read_length", 1 );
+        const auto tiling         = parameter( "tiling", 1 );
+        const auto error_rate     = parameter( "error_rate", 1 );
+        const auto strands        = parameter( "strands", 1 );
+        const auto format         = parameter( "format", 1 );
+        const auto base_errors    = parameter( "base_errors", 3 );
+        const auto error_ramp     = parameter( "error_ramp", 1 );
+        const auto error_profile  = parameter( "error_profile", 1 );
+        const auto error_matrix   = parameter( "error_matrix", 1 );
+        const auto error_hotspots = parameter( "error_hotspots", 1 );
+        const auto pairing        = parameter( "pairing", 3 );
+        const auto mate_file      = parameter( "mate_file", 1 );
+        const auto long_reads     = parameter( "long_reads", 0 );
+        const auto chimera_rate   = parameter( "chimera_rate", 1 );
+        const auto duplicates     = parameter( "duplicates", 3 );
+        const auto truth_file     = parameter( "truth_file", 1 );
+        const auto targets        = parameter( "targets", 2 );
+        const auto coverage_bias  = parameter( "coverage_bias", 0 );
+        const auto read_order     = parameter( "read_order", 1 );
+        const auto quality        = parameter( "quality", 0 );
+        if( ( long_reads.size() != 1 && long_reads.size() != 3 ) || ( quality.size() != 3 && quality.size() != 4 )
+            || coverage_bias.size() != ( coverage_bias.at( 0 ) == "-" ? 3 : 4 ) ) {
+            throw std::out_of_range( "[genomeMaker::RunState::getParameters(..)] Unexpected number of fields." );
+        }
+        options._genome_file       = genome.at( 0 );
+        options._seed              = converter.string_to_type<uint64_t>( seed.at( 0 ) );
+        options._read_length       = converter.string_to_type<size_t>( read_length.at( 0 ) );
+        options._tile_stride       = converter.string_to_type<size_t>( tiling.at( 0 ) );
+        options._error_rate        = converter.string_to_type<double>( error_rate.at( 0 ) );
+        options._both_strands      = strands.at( 0 ) == "both";
+        options._read_format       = format.at( 0 ) == "fastq" ? FileOptions::ReadFormat::FASTQ : FileOptions::ReadFormat::FASTA;
+        options._substitution_rate = converter.string_to_type<double>( base_errors.at( 0 ) );
+        options._insertion_rate    = converter.string_to_type<double>( base_errors.at( 1 ) );
+        options._deletion_rate     = converter.string_to_type<double>( base_errors.at( 2 ) );
+        options._error_ramp        = converter.string_to_type<double>( error_ramp.at( 0 ) );
+        options._error_profile     = error_profile.at( 0 );
+        options._error_matrix      = error_matrix.at( 0 );
+        options._error_hotspots    = error_hotspots.at( 0 );
+        options._pairing           = static_cast<FileOptions::Pairing>( converter.string_to_type<int>( pairing.at( 0 ) ) );
+        options._insert_mean       = converter.string_to_type<double>( pairing.at( 1 ) );
+        options._insert_sd         = converter.string_to_type<double>( pairing.at( 2 ) );
+        options._mate_file         = mate_file.at( 0 );
+        options._long_reads        = long_reads.size() == 3;
+        if( options._long_reads ) {
+            options._long_mean    = converter.string_to_type<double>( long_reads.at( 0 ) );
+            options._long_sd      = converter.string_to_type<double>( long_reads.at( 1 ) );
+            options._long_lengths = long_reads.at( 2 );
+        }
+        options._chimera_rate      = converter.string_to_type<double>( chimera_rate.at( 0 ) );
+        options._duplicate_rate    = converter.string_to_type<double>( duplicates.at( 0 ) );
+        options._mutation_rate     = converter.string_to_type<double>( duplicates.at( 1 ) );
+        options._reservoir_size    = converter.string_to_type<size_t>( duplicates.at( 2 ) );
+        options._truth_file        = truth_file.at( 0 );
+        options._target_file       = targets.at( 0 );
+        options._off_target_rate   = converter.string_to_type<double>( targets.at( 1 ) );
+        options._gc_bias           = coverage_bias.at( 0 ) != "-";
+        if( options._gc_bias ) {
+            options._gc_peak = converter.string_to_type<double>( coverage_bias.at( 0 ) );
+            options._gc_sd   = converter.string_to_type<double>( coverage_bias.at( 1 ) );
+        }
+        options._overdispersion    = converter.string_to_type<double>( coverage_bias.at( coverage_bias.size() - 2 ) );
+        options._bias_window       = converter.string_to_type<size_t>( coverage_bias.at( coverage_bias.size() - 1 ) );
+        options._read_order        = static_cast<FileOptions::ReadOrder>( converter.string_to_type<int>( read_order.at( 0 ) ) );
+        options._quality_profile   = quality.at( 0 );
+        options._quality_start     = converter.string_to_type<unsigned>( quality.at( 1 ) );
+        options._quality_end       = converter.string_to_type<unsigned>( quality.at( 2 ) );
+        options._quality_binning   = quality.size() == 4 && quality.at( 3 ) == "binned";
+    } catch( std::exception &e ) {
+        LOG_ERROR( "[genomeMaker::RunState::getParameters( <FileOptions> )] Missing or malformed parameter in the run state." );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Sets how far the run got
+ * @param reads          Reads in the output(s)
+ * @param parts          Runs the reads were generated in
+ * @param depth          Depth reached
+ * @param truth_position Position of the last truth record written
+ */
+void genomeMaker::RunState::setProgress( const uint64_t &reads, const size_t &parts, const unsigned &depth, const uint64_t &truth_position ) {
+    _reads          = reads;
+    _parts          = parts;
+    _depth          = depth;
+    _truth_position = truth_position;
+}
+
+/**
+ * Checks the parameters of another run state against this one's
+ * Note: the parameters that differ are printed out
+ * @param state Run state
+ * @return Same parameters state
+ */
+bool genomeMaker::RunState::sameParameters( const RunState &state ) const {
+    bool same { _parameters.size() == state._parameters.size() };
+    for( size_t i = 0; i < _parameters.size() && i < state._parameters.size(); i++ ) {
+        if( _parameters[ i ] != state._parameters[ i ] ) {
+            std::cerr << "Error: option '" << _parameters[ i ].first << "' differs from the reads on disk ('"
+                      << _parameters[ i ].second << "' instead of '" << state._parameters[ i ].second << "')." << std::endl;
+            same = false;
+        }
+    }
+    return same;
+}
+
+/**
+ * Saves the run state to a file
+ * @param file_name Name of the state file
+ * @return Success
+ */
+bool genomeMaker::RunState::save( const std::string &file_name ) const {
+    std::ofstream file( file_name, std::ofstream::out | std::ofstream::trunc );
+    if( !file.is_open() ) {
+        LOG_ERROR( "[genomeMaker::RunState::save( ", file_name, " )] Could not create the state file." );
+        return false;
+    }
+    file << _HEADER << "\n";
+    file << "reads\t" << _reads << "\n";
+    file << "parts\t" << _parts << "\n";
+    file << "depth\t" << _depth << "\n";
+    file << "truth_position\t" << _truth_position << "\n";
+    for( const auto &parameter : _parameters ) {
+        file << "param." << parameter.first << "\t" << parameter.second << "\n";
+    }
+    file.close();
+    if( file.fail() ) {
+        LOG_ERROR( "[genomeMaker::RunState::save( ", file_name, " )] Could not write the state file." );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Loads the run state from a file
+ * @param file_name Name of the state file
+ * @return Success
+ */
+bool genomeMaker::RunState::load( const std::string &file_name ) {
+    auto converter = eadlib::tool::Convert();
+    std::ifstream file( file_name );
+    std::string   line;
+    if( !file.is_open() || !std::getline( file, line ) || line != _HEADER ) {
+        LOG_ERROR( "[genomeMaker::RunState::load( ", file_name, " )] Not a run state file." );
+        return false;
+    }
+    _parameters.clear();
+    try {
+        while( std::getline( file, line ) ) {
+            const size_t tab = line.find( '\t' );
+            if( tab == std::string::npos ) {
+                continue;
+            }
+            const std::string name  = line.substr( 0, tab );
+            const std::string value = line.substr( tab + 1 );
+            if( name == "reads" ) {
+                _reads = converter.string_to_type<uint64_t>( value );
+            } else if( name == "parts" ) {
+                _parts = converter.string_to_type<size_t>( value );
+            } else if( name == "depth" ) {
+                _depth = converter.string_to_type<unsigned>( value );
+            } else if( name == "truth_position" ) {
+                _truth_position = converter.string_to_type<uint64_t>( value );
+            } else if( name.compare( 0, 6, "param." ) == 0 ) {
+                addParameter( name.substr( 6 ), value );
+            }
+        }
+    } catch( std::bad_cast &e ) {
+        LOG_ERROR( "[genomeMaker::RunState::load( ", file_name, " )] Malformed value in the state file." );
+        return false;
+    }
+    return _parts > 0;
+}
+
+/**
+ * Gets the number of reads in the output(s)
+ * @return Number of reads
+ */
+uint64_t genomeMaker::RunState::reads() const {
+    return _reads;
+}
+
+/**
+ * Gets the number of runs the reads were generated in
+ * @return Number of runs
+ */
+size_t genomeMaker::RunState::parts() const {
+    return _parts;
+}
+
+/**
+ * Gets the depth reached
+ * @return Depth
+ */
+unsigned genomeMaker::RunState::depth() const {
+    return _depth;
+}
+
+/**
+ * Gets the position of the last truth record written
+ * @return Genome position
+ */
+uint64_t genomeMaker::RunState::truthPosition() const {
+    return _truth_position;
+}
+
+/**
+ * Gets the name of the state file of a sequencer file
+ * @param sequencer_file Sequencer file name
+ * @return State file name
+ */
+std::string genomeMaker::RunState::fileName( const std::string &sequencer_file ) {
+    return sequencer_file + ".state";
+}
+
+/**
+ * Adds a parameter
+ * @param name  Name
+ * @param value Value
+ */
+void genomeMaker::RunState::addParameter( const std::string &name, const std::string &value ) {
+    _parameters.emplace_back( name, value );
+}
+
+/**
+ * Gets the space separated fields of a parameter
+ * Note: empty fields are kept (e.g. no target file) so they stay in place
+ * @param name   Name
+ * @param fields Number of fields expected (0: any)
+ * @return Fields
+ * @throws std::out_of_range when the parameter is missing or does not have the fields expected
+ */
+std::vector<std::string> genomeMaker::RunState::parameter( const std::string &name, const size_t &fields ) const {
+    for( const auto &parameter : _parameters ) {
+        if( parameter.first == name ) {
+            std::vector<std::string> values;
+            size_t begin { 0 };
+            size_t end   { 0 };
+            while( fields != 1 && ( end = parameter.second.find( ' ', begin ) ) != std::string::npos ) {
+                values.emplace_back( parameter.second.substr( begin, end - begin ) );
+                begin = end + 1;
+            }
+            values.emplace_back( parameter.second.substr( begin ) );
+            if( fields > 0 && values.size() != fields ) {
+                throw std::out_of_range( "[genomeMaker::RunState::parameter(..)] Unexpected number of fields." );
+            }
+            return values;
+        }
+    }
+    throw std::out_of_range( "[genomeMaker::RunState::parameter(..)] Parameter not found." );
+}
@@ -0,0 +1,47 @@
+#ifndef GENOMEMAKER_RUNSTATE_H
+#define GENOMEMAKER_RUNSTATE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+#include <stdexcept>
+#include <iostream>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/tool/Convert.h"
+
+#include "../containers/FileOptions.h"
+
+namespace genomeMaker {
+    class RunState {
+      public:
+        RunState();
+        ~RunState();
+        void setParameters( const FileOptions &options );
+        bool getParameters( FileOptions &options ) const;
+        void setProgress( const uint64_t &reads, const size_t &parts, const unsigned &depth, const uint64_t &truth_position );
+        bool sameParameters( const RunState &state ) const;
+        bool save( const std::string &file_name ) const;
+        bool load( const std::string &file_name );
+        uint64_t reads() const;
+        size_t parts() const;
+        unsigned depth() const;
+        uint64_t truthPosition() const;
+        static std::string fileName( const std::string &sequencer_file );
+        static const std::string _HEADER;
+
+      private:
+        void addParameter( const std::string &name, const std::string &value );
+        std::vector<std::string> parameter( const std::string &name, const size_t &fields ) const;
+        //Private variables
+        std::vector<std::pair<std::string, std::string>> _parameters; //options the reads depend on
+        uint64_t _reads;          //reads in the output(s)
+        size_t   _parts;          //runs the reads were generated in (first one and top-ups)
+        unsigned _depth;          //depth reached
+        uint64_t _truth_position; //position of the last truth record written
+    };
+}
+
+#endif //GENOMEMAKER_RUNSTATE_H
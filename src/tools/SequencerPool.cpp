@@ -0,0 +1,112 @@
+#include "SequencerPool.h"
+
+/**
+ * Constructor
+ * @param genome  Genome window shared by the sequencers
+ * @param threads Maximum number of sequencers running at the same time
+ */
+genomeMaker::SequencerPool::SequencerPool( genomeMaker::GenomeWindow &genome, const size_t &threads ) :
+    _genome( genome ),
+    _threads( std::max( threads, (size_t) 1 ) )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::SequencerPool::~SequencerPool() {}
+
+/**
+ * Adds a started sequencer to the pool
+ * @param sequencer Sequencer simulator
+ */
+void genomeMaker::SequencerPool::add( genomeMaker::SequencerSim &sequencer ) {
+    _sequencers.emplace_back( &sequencer );
+}
+
+/**
+ * Runs all the sequencers over a single pass of the genome
+ * Note: each time the window moves along, the sequencers still needing more of the genome
+ *       generate their reads from it in parallel. The window only drops what comes before
+ *       the earliest pending read so every sequencer sees the genome it needs.
+ * @return Success
+ */
+bool genomeMaker::SequencerPool::run() {
+    const bool streamed = _genome.isStreamed(); //no progress bar without a genome size
+    eadlib::cli::ProgressBar progress( std::max( _genome.genomeSize(), (uint64_t) 1 ), 70 );
+    if( !streamed ) {
+        progress.printPercentBar( std::cout, 0 );
+    }
+    uint64_t shown { 0 };
+    _steps.assign( _sequencers.size(), SequencerSim::Step::MORE );
+    std::vector<size_t> active;
+    while( true ) {
+        active.clear();
+        for( size_t i = 0; i < _sequencers.size(); i++ ) {
+            if( _steps[ i ] == SequencerSim::Step::MORE ) {
+                active.emplace_back( i );
+            }
+        }
+        runRound( active );
+        uint64_t from { _genome.end() };
+        bool     more { false };
+        for( size_t i : active ) {
+            if( _steps[ i ] == SequencerSim::Step::FAILED ) {
+                LOG_ERROR( "[genomeMaker::SequencerPool::run()] Sequencer #", i, " failed." );
+                return false;
+            }
+            if( _steps[ i ] == SequencerSim::Step::MORE ) {
+                from = std::min( from, _sequencers[ i ]->pendingStart() );
+                more = true;
+            }
+        }
+        if( !streamed && _genome.end() > shown ) {
+            progress += _genome.end() - shown;
+            progress.printPercentBar( std::cout, 0 );
+            shown = _genome.end();
+        }
+        if( !more ) {
+            break;
+        }
+        if( !_genome.advance( from ) ) {
+            std::cerr << "Error: could not read the genome file." << std::endl;
+            return false;
+        }
+    }
+    if( streamed ) {
+        std::cout << "-> Genome streamed: " << _genome.genomeSize() << " bases" << std::endl;
+    } else {
+        progress.complete().printPercentBar( std::cout, 0 );
+        std::cout << std::endl;
+    }
+    bool success { true };
+    for( SequencerSim *sequencer : _sequencers ) {
+        success = sequencer->finish() && success;
+    }
+    return success;
+}
+
+/**
+ * Runs the sequencers on the current genome window
+ * Note: sequencers are shared round-robin between the worker threads (a single one runs in place)
+ * @param active Indices of the sequencers to run
+ */
+void genomeMaker::SequencerPool::runRound( const std::vector<size_t> &active ) {
+    const size_t workers = std::min( _threads, active.size() );
+    if( workers <= 1 ) {
+        for( size_t i : active ) {
+            _steps[ i ] = _sequencers[ i ]->sequenceWindow();
+        }
+        return;
+    }
+    std::vector<std::thread> threads;
+    for( size_t w = 0; w < workers; w++ ) {
+        threads.emplace_back( [ this, &active, w, workers ]() {
+            for( size_t j = w; j < active.size(); j += workers ) {
+                _steps[ active[ j ] ] = _sequencers[ active[ j ] ]->sequenceWindow();
+            }
+        } );
+    }
+    for( std::thread &thread : threads ) {
+        thread.join();
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef GENOMEMAKER_SEQUENCERPOOL_H
+#define GENOMEMAKER_SEQUENCERPOOL_H
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/cli/graphic/ProgressBar.h"
+
+#include "GenomeWindow.h"
+#include "SequencerSim.h"
+
+namespace genomeMaker {
+    class SequencerPool {
+      public:
+        SequencerPool( genomeMaker::GenomeWindow &genome, const size_t &threads );
+        ~SequencerPool();
+        void add( genomeMaker::SequencerSim &sequencer );
+        bool run();
+
+      private:
+        void runRound( const std::vector<size_t> &active );
+        //Private variables
+        GenomeWindow                    &_genome;
+        size_t                           _threads;
+        std::vector<SequencerSim *>      _sequencers;
+        std::vector<SequencerSim::Step>  _steps;
+    };
+}
+
+#endif //GENOMEMAKER_SEQUENCERPOOL_H
@@ -1,22 +1,82 @@
 #include "SequencerSim.h"
 
+const uint64_t genomeMaker::SequencerSim::_READ_STREAM;
+const uint64_t genomeMaker::SequencerSim::_SHUFFLE_STREAM;
+const uint64_t genomeMaker::SequencerSim::_LAYER_STREAM;
+const uint64_t genomeMaker::SequencerSim::_PART_STREAM;
+const size_t genomeMaker::SequencerSim::_BATCH_READS;
+const size_t genomeMaker::SequencerSim::_BATCH_BASES;
+
 /**
  * Constructor
- * @param reader           EADlib File Reader
- * @param writer           EADlib File Writer
- * @param read_randomiser  Read position randomiser
- * @param error_randomiser Error randomiser
- */
-genomeMaker::SequencerSim::SequencerSim( eadlib::io::FileReader &reader,
-                                         eadlib::io::FileWriter &writer,
-                                         genomeMaker::Randomiser &read_randomiser,
-                                         genomeMaker::Randomiser &error_randomiser ) :
-    _reader( reader ),
+ * Note: several simulators can share the same genome window (see SequencerPool)
+ * @param genome Genome window
+ * @param writer EADlib File Writer
+ */
+genomeMaker::SequencerSim::SequencerSim( genomeMaker::GenomeWindow &genome,
+                                         eadlib::io::FileWriter &writer ) :
+    _genome( genome ),
     _writer( writer ),
-    _read_randomiser( read_randomiser ),
-    _error_randomiser( error_randomiser ),
+    _seed( 0 ),
+    _read_errors( 0 ),
+    _default_error_model( 0, 0, 0 ),
+    _error_model( &_default_error_model ),
+    _error_hotspots( nullptr ),
+    _quality_model( nullptr ),
+    _fragment_model( nullptr ),
+    _length_model( nullptr ),
+    _chimeras( 0 ),
+    _duplicates( 0 ),
+    _mutations( 0 ),
+    _reservoir_size( 0 ),
+    _reservoir_next( 0 ),
+    _duplicate_of( 0 ),
+    _target_regions( nullptr ),
+    _off_target_rate( 0 ),
+    _coverage_bias( nullptr ),
+    _segments( 2 ),
+    _batch_next( 0 ),
+    _batch_size( 1 ),
+    _read_number( 0 ),
+    _mate_writer( nullptr ),
+    _truth_writer( nullptr ),
+    _truth_records( nullptr ),
+    _sorter( nullptr ),
+    _sort_key( SortKey::RANDOM ),
+    _coverage_track( nullptr ),
+    _depth_index( nullptr ),
+    _clean_reads( false ),
+    _reads_done( 0 ),
+    _part( 0 ),
+    _tile_stride( 0 ),
+    _clean_tiles( false ),
+    _truth_position( 0 ),
+    _starts( 0, 0, 0 ),
+    _current( &_starts ),
+    _read_seed( 0 ),
+    _coverage_target( nullptr ),
+    _min_coverage( 0 ),
+    _covered_fraction( 0 ),
+    _read_length( 0 ),
+    _span( 0 ),
+    _reads_total( 0 ),
+    _pending( false ),
+    _pending_end( 0 ),
+    _pending_floor( 0 ),
+    _pending_segments( 0 ),
+    _pending_fragment( 0 ),
+    _pending_reverse( false ),
+    _both_strands( false ),
+    _strand_bits( 0 ),
+    _letters( "ACGT" ),
+    _rna( false ),
     _total_reads_completed( 0 ),
-    _total_read_errors( 0 )
+    _total_read_errors( 0 ),
+    _total_base_errors( 0 ),
+    _total_quality_errors( 0 ),
+    _total_reverse_reads( 0 ),
+    _total_chimeras( 0 ),
+    _total_duplicates( 0 )
 {}
 
 /**
@@ -24,8 +84,211 @@ genomeMaker::SequencerSim::SequencerSim( eadlib::io::FileReader &reader,
  */
 genomeMaker::SequencerSim::~SequencerSim() {}
 
+/**
+ * Sets a quality model and switches the output to FASTQ
+ * Note: bases get substituted with the error probability of their quality score
+ * @param quality_model Quality model
+ */
+void genomeMaker::SequencerSim::setQualityModel( genomeMaker::QualityModel &quality_model ) {
+    _quality_model = &quality_model;
+}
+
+/**
+ * Sets a per-base error model (substitutions, insertions and deletions)
+ * @param error_model Error model
+ */
+void genomeMaker::SequencerSim::setErrorModel( genomeMaker::ErrorModel &error_model ) {
+    _error_model = &error_model;
+}
+
+/**
+ * Sets error hotspots raising the substitution rate after some motifs
+ * @param error_hotspots Error hotspots
+ */
+void genomeMaker::SequencerSim::setErrorHotspots( genomeMaker::ErrorHotspots &error_hotspots ) {
+    _error_hotspots = &error_hotspots;
+}
+
+/**
+ * Sets a fragment model to simulate paired reads (paired-end/mate-pair)
+ * Note: mates are interleaved in the sequencer file unless a mate writer is given
+ * @param fragment_model Fragment model
+ */
+void genomeMaker::SequencerSim::setFragmentModel( genomeMaker::FragmentModel &fragment_model ) {
+    _fragment_model = &fragment_model;
+}
+
+/**
+ * Sets a separate writer for the mate #2 reads
+ * @param mate_writer EADlib File Writer
+ */
+void genomeMaker::SequencerSim::setMateWriter( eadlib::io::FileWriter &mate_writer ) {
+    _mate_writer = &mate_writer;
+}
+
+/**
+ * Sets the strand sampling of the reads
+ * Note: when both strands are used each read (or pair) is taken from the reverse
+ *       complement of the genome with a probability of 0.5
+ * @param both_strands Sample from both strands flag
+ */
+void genomeMaker::SequencerSim::setStrandSampling( const bool &both_strands ) {
+    _both_strands = both_strands;
+}
+
+/**
+ * Sets a writer for the ground truth of the reads (origin, strand and errors)
+ * @param truth_writer Truth writer
+ */
+void genomeMaker::SequencerSim::setTruthWriter( genomeMaker::TruthWriter &truth_writer ) {
+    _truth_writer = &truth_writer;
+}
+
+/**
+ * Sets a length model to simulate variable length (long) reads
+ * Note: the read length given to start(..) is then used as the longest read possible
+ * @param length_model Length model
+ */
+void genomeMaker::SequencerSim::setLengthModel( genomeMaker::LengthModel &length_model ) {
+    _length_model = &length_model;
+}
+
+/**
+ * Sets the rate of chimeric reads (two segments joined from unrelated parts of the genome)
+ * @param chimera_rate Probability of a read being chimeric (0 to 1)
+ */
+void genomeMaker::SequencerSim::setChimeraRate( const double &chimera_rate ) {
+    _chimeras = BernoulliStream( chimera_rate );
+}
+
+/**
+ * Sets the target regions read starts are taken from (capture panels, exomes, amplicons)
+ * Note: the read depth then applies to the targets
+ * @param target_regions  Loaded target regions
+ * @param off_target_rate Fraction of the reads starting outside the targets (0 to 1)
+ */
+void genomeMaker::SequencerSim::setTargetRegions( genomeMaker::TargetRegions &target_regions, const double &off_target_rate ) {
+    _target_regions  = &target_regions;
+    _off_target_rate = off_target_rate;
+}
+
+/**
+ * Sets the coverage bias (GC bias and/or overdispersion) read starts are drawn with
+ * @param coverage_bias Coverage bias model
+ */
+void genomeMaker::SequencerSim::setCoverageBias( genomeMaker::CoverageBias &coverage_bias ) {
+    _coverage_bias = &coverage_bias;
+}
+
+/**
+ * Sets the seed everything drawn for the reads is keyed on
+ * @param seed Seed
+ */
+void genomeMaker::SequencerSim::setSeed( const uint64_t &seed ) {
+    _seed = seed;
+}
+
+/**
+ * Sets a coverage target the number of reads is worked out from
+ * Note: reads are drawn as layers of independent read sets (1/4x each) until the target is met
+ *       or the read depth given to start(..) is reached. The layers are then merged by position
+ *       so the genome is still read in a single pass.
+ * @param coverage_target  Coverage target (built over the genome in prepare(..))
+ * @param min_coverage     Coverage wanted on the positions (1-255)
+ * @param fraction         Fraction of the genome positions that need the coverage (0 to 1)
+ */
+void genomeMaker::SequencerSim::setCoverageTarget( genomeMaker::CoverageTarget &coverage_target,
+                                                   const unsigned &min_coverage,
+                                                   const double &fraction ) {
+    _coverage_target  = &coverage_target;
+    _min_coverage     = min_coverage;
+    _covered_fraction = fraction;
+}
+
+/**
+ * Sets a track the per-base coverage of the reads is written to as they are generated
+ * @param coverage_track Coverage track
+ */
+void genomeMaker::SequencerSim::setCoverageTrack( genomeMaker::CoverageTrack &coverage_track ) {
+    _coverage_track = &coverage_track;
+}
+
+/**
+ * Sets a sorter the reads go through before being written (random or coordinate output order)
+ * Note: random keys are drawn from the seed and the read's number so the order does not depend
+ *       on the memory given to the sorter. Reads with the same position keep the order they were
+ *       generated in. The sorter writes the reads when the run finishes.
+ * @param sorter   Read sorter (using the same writers as the simulator)
+ * @param sort_key Key the reads are sorted on
+ */
+void genomeMaker::SequencerSim::setReadSorter( genomeMaker::ReadSorter &sorter, const SortKey &sort_key ) {
+    _sorter   = &sorter;
+    _sort_key = sort_key;
+}
+
+/**
+ * Sets an index of where the depth milestones end in the output (random output order)
+ * @param depth_index Depth index
+ */
+void genomeMaker::SequencerSim::setDepthIndex( genomeMaker::DepthIndex &depth_index ) {
+    _depth_index = &depth_index;
+}
+
+/**
+ * Sets the reads to tile the genome at a fixed stride instead of being drawn
+ * Note: the depth is then given by the stride (read span / stride) and the number of reads by
+ *       the genome size. Errors and strands are still drawn per read.
+ * @param stride Distance between the starts of two consecutive reads
+ */
+void genomeMaker::SequencerSim::setTiling( const uint64_t &stride ) {
+    _tile_stride = stride;
+}
+
+/**
+ * Sets duplicate reads (PCR/optical) sequencing a fragment already sequenced again
+ * Note: candidates are the latest fragments drawn, kept in a reservoir of fixed size so memory
+ *       does not grow with the number of reads. Duplicates keep the position, strand(s) and length
+ *       of their fragment but get their own errors (plus any mutations).
+ * @param duplicate_rate Probability of a read being a duplicate (0 to 1)
+ * @param mutation_rate  Probability of each base of a duplicate being substituted (0 to 1)
+ * @param reservoir_size Number of fragments kept as candidates
+ */
+void genomeMaker::SequencerSim::setDuplicates( const double &duplicate_rate, const double &mutation_rate, const size_t &reservoir_size ) {
+    _duplicates     = BernoulliStream( duplicate_rate );
+    _mutations      = BernoulliStream( mutation_rate );
+    _reservoir_size = duplicate_rate > 0 ? reservoir_size : 0;
+}
+
+/**
+ * Adds an extra output of the reads (other format and/or error-free reads)
+ * Note: each read is rendered once whatever the number of sinks. The sinks get the records in
+ *       batches shared between them and write them on their own threads (see ReadSink).
+ * @param sink Read sink
+ */
+void genomeMaker::SequencerSim::addSink( genomeMaker::ReadSink &sink ) {
+    _sinks.emplace_back( &sink );
+    _clean_reads = _clean_reads || sink.isClean();
+}
+
+/**
+ * Sets the run up to top up the reads of an earlier run to a higher depth
+ * Note: the missing reads are drawn as an independent set (own seed) and numbered on from the
+ *       ones on disk. Read starts of both sets are uniform so together they are a uniform set
+ *       of the size a fresh run at the higher depth would have.
+ * @param reads_done     Reads already on disk
+ * @param part           Top-up run number (1 for the first top-up)
+ * @param truth_position Position of the last truth record on disk
+ */
+void genomeMaker::SequencerSim::setTopUp( const uint64_t &reads_done, const size_t &part, const uint64_t &truth_position ) {
+    _reads_done     = reads_done;
+    _part           = part;
+    _truth_position = truth_position;
+}
+
 /**
  * Starts sequence read simulation
+ * Note: the genome window needs to be opened beforehand. Reads are then generated window
+ *       by window with sequenceWindow() and the run is closed with finish().
  * @param read_length Number of characters per reads
  * @param read_depth  Total number of simulated reads
  * @param error_rate  Error rate of the simulator on the reads (0 to 1)
@@ -34,55 +297,249 @@ genomeMaker::SequencerSim::~SequencerSim() {}
 bool genomeMaker::SequencerSim::start( const size_t &read_length,
                                        const size_t &read_depth,
                                        const double &error_rate ) {
-    //Error control
-    if( read_length < 1 || read_length > 1000 ) {
+    if( _genome.getFileName() == _writer.getFileName() ) {
         LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
-            "Invalid read length of '", read_length, "'." );
+            "Input and Output files are the same ('", _genome.getFileName(), "')!" );
+        return false;
+    }
+    if( !_writer.isOpen() && !_writer.open() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+                       "There was a problem creating the sequencer file." );
         return false;
     }
-    if( read_depth < 1 ) {
+    if( _mate_writer && ( _mate_writer->getFileName() == _writer.getFileName() || _mate_writer->getFileName() == _genome.getFileName() ) ) {
         LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Mate file clashes with another file ('", _mate_writer->getFileName(), "')!" );
+        return false;
+    }
+    if( _mate_writer && !_mate_writer->isOpen() && !_mate_writer->open() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+                       "There was a problem creating the mate sequencer file." );
+        return false;
+    }
+    if( !prepare( read_length, read_depth, error_rate ) ) {
+        return false;
+    }
+    if( _genome.isStreamed() ) {
+        std::cout << "-> Genome streamed, number of " << ( _fragment_model ? "pairs" : "reads" ) << " known at the end" << std::endl;
+    } else {
+        std::cout << "-> Calculated the number of " << ( _fragment_model ? "pairs" : "reads" ) << " at..........: ~" << _reads_total << std::endl;
+        std::cout << "-> Expected number of erroneous reads.........: ~" << _read_errors.expected( _reads_total ) << std::endl;
+    }
+    LOG( "[genomeMaker::SequencerSim::start(..)] Writing to file...: '", _writer.getFileName() , "'" );
+    _truth_records = ( _sorter && _truth_writer ) ? &_read_truth : nullptr;
+    if( _depth_index && ( !_sorter || _sort_key != SortKey::RANDOM ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::start(..)] A depth index needs the reads in random order." );
+        std::cerr << "Error: a depth index needs the reads in random order (-or random)." << std::endl;
+        return false;
+    }
+    if( !_sinks.empty() && ( _sorter || _part > 0 ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::start(..)] Extra outputs need the reads in the order they are generated in a fresh run." );
+        std::cerr << "Error: extra outputs cannot be used with a sorted read order or a top-up." << std::endl;
+        return false;
+    }
+    for( ReadSink *sink : _sinks ) {
+        if( sink->format() == FileOptions::ExtraFormat::FASTQ && !_quality_model ) {
+            LOG_ERROR( "[genomeMaker::SequencerSim::start(..)] FASTQ output '", sink->getFileName(), "' without a quality model." );
+            std::cerr << "Error: FASTQ extra outputs need FASTQ reads (-q)." << std::endl;
+            return false;
+        }
+        if( !sink->open( _letters ) ) {
+            std::cerr << "Error: could not create the extra output '" << sink->getFileName() << "'." << std::endl;
+            return false;
+        }
+    }
+    if( !_sinks.empty() ) {
+        _rendered = std::make_shared<RenderedReads>();
+    }
+    if( _coverage_track && !_coverage_track->open( _genome.getFileName() ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::start(..)] Could not open the coverage track." );
+        std::cerr << "Error: could not create the coverage track." << std::endl;
+        return false;
+    }
+    if( _truth_writer && _part > 0 ) { //records carry on after the ones of the earlier run(s)
+        if( !_truth_writer->resume( read_length, _letters, _sorter != nullptr, _reservoir_size > 0, _truth_position ) ) {
+            LOG_ERROR( "[genomeMaker::SequencerSim::start(..)] Could not carry on the truth file." );
+            std::cerr << "Error: could not write to the truth file." << std::endl;
+            return false;
+        }
+    } else if( _truth_writer && !_truth_writer->writeHeader( _genome.getFileName(), _genome.genomeSize(), read_length, _fragment_model != nullptr, _letters, _sorter != nullptr, _reservoir_size > 0 ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::start(..)] Could not write the header of the truth file." );
+        std::cerr << "Error: could not write to the truth file." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Prepares the read simulation without opening or writing to any of the outputs
+ * Note: this is all that is needed for generating single reads with sequenceRead(..).
+ * @param read_length Number of characters per reads
+ * @param read_depth  Total number of simulated reads
+ * @param error_rate  Error rate of the simulator on the reads (0 to 1)
+ * @return Success
+ */
+bool genomeMaker::SequencerSim::prepare( const size_t &read_length,
+                                         const size_t &read_depth,
+                                         const double &error_rate ) {
+    //Error control
+    if( read_length < 1 || read_length > _MAX_READ_LENGTH ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Invalid read length of '", read_length, "'." );
+        return false;
+    }
+    if( read_depth < 1 && _tile_stride == 0 ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
             "Invalid read depth of '", read_depth, "'." );
         return false;
     }
     if( error_rate < 0 || error_rate > 1 ) {
-        LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
             "Invalid error rate of '", error_rate, "'." );
         return false;
     }
-    if( _reader.getFileName() == _writer.getFileName() ) {
-        LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
-            "Input and Output files are the same ('", _reader.getFileName(), "')!" );
+    const size_t span { std::max( read_length, _fragment_model ? _fragment_model->maxLength() : read_length ) };
+    if( _genome.isStreamed() && ( _target_regions || _coverage_bias || _coverage_target ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Target regions, coverage bias and coverage targets need the whole genome up front (streamed genome)." );
+        std::cerr << "Error: target regions, coverage bias and coverage targets cannot be used with a streamed genome." << std::endl;
         return false;
     }
-    if( !_reader.isOpen() && !_reader.open() ) {
-        LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
-                       "There was a problem opening the genome file." );
+    if( _tile_stride > 0 && ( _genome.isStreamed() || _target_regions || _coverage_bias || _coverage_target || _part > 0 ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Tiling lays the reads out over the whole genome (streamed genome, targets, bias, coverage target or top-up given)." );
+        std::cerr << "Error: tiling cannot be used with a streamed genome, target regions, coverage bias, coverage targets or top-ups." << std::endl;
         return false;
     }
-    if( !_writer.isOpen() && !_writer.open() ) {
-        LOG_ERROR( "[genomeMaker::SequencerSim::start( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
-                       "There was a problem creating the sequencer file." );
+    if( _part > 0 && ( _genome.isStreamed() || _coverage_target ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Top-up runs need a fixed number of reads (streamed genome or coverage target given)." );
+        std::cerr << "Error: a top-up cannot be used with a streamed genome or a coverage target." << std::endl;
+        return false;
+    }
+    if( _target_regions && _coverage_target ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Coverage targets apply to the whole genome (target regions given)." );
+        std::cerr << "Error: a coverage target cannot be used with target regions." << std::endl;
+        return false;
+    }
+    if( !_genome.isStreamed() && _genome.genomeSize() < span ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Genome ('", _genome.genomeSize(), "') smaller than a read span ('", span, "')." );
+        std::cerr << "Error: The genome is too small for the length of the reads." << std::endl;
         return false;
     }
     //Calculating total number of reads to do on genome
     _total_reads_completed = 0;
-    uint64_t reads_total   = calcReadCount( _reader.size(), read_length, read_depth );
-    _total_read_errors     = calcErrorUpperBound( reads_total, error_rate );
-    _error_randomiser.setPoolRange( _total_read_errors, reads_total );
-    std::cout << "-> Calculated the number of reads at..........: ~" << reads_total << std::endl;
-    std::cout << "-> Calculated the number of erroneous reads at: ~" << _total_read_errors << std::endl;
+    _total_base_errors     = 0;
+    _total_quality_errors  = 0;
+    _total_reverse_reads   = 0;
+    _total_chimeras        = 0;
+    _total_duplicates      = 0;
+    _reservoir.clear();
+    _reservoir_next        = 0;
+    const size_t mean_length { _length_model ? static_cast<size_t>( std::max( std::round( _length_model->mean() ), 1. ) ) : read_length };
+    if( _target_regions && !_target_regions->build( _genome.genomeSize() - span + 1, _off_target_rate ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Could not build the target regions over the genome." );
+        std::cerr << "Error: none of the target regions are in the genome." << std::endl;
+        return false;
+    }
+    if( _coverage_bias && !_coverage_bias->build( _genome.getFileName(), _genome.genomeSize() - span + 1, _genome.ioBlock() ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare( ", read_length, ", ", read_depth, ", ", error_rate, " )] "
+            "Could not build the coverage bias over the genome." );
+        std::cerr << "Error: could not work out the coverage bias of the genome. For more see the log." << std::endl;
+        return false;
+    }
+    uint64_t reads_total   = calcReadCount( _target_regions ? _target_regions->targetBases() : (uint64_t) _genome.genomeSize(),
+                                            _fragment_model ? 2 * mean_length : mean_length,
+                                            read_depth );
+    const double read_rate = static_cast<double>( read_depth ) / static_cast<double>( _fragment_model ? 2 * mean_length : mean_length );
+    if( _target_regions ) { //off-target reads come on top of the ones giving the depth on the targets
+        reads_total = static_cast<uint64_t>( std::round( reads_total / ( 1 - _target_regions->offTargetRate() ) ) );
+    }
+    if( _tile_stride > 0 ) { //one read per tile whatever the depth
+        reads_total = StartStream::tiling( _tile_stride, _genome.genomeSize() - span + 1 ).remaining();
+    }
+    _total_read_errors     = 0;
+    _read_errors           = BernoulliStream( error_rate );
     //Logging stats
-    LOG( "[genomeMaker::SequencerSim::start(..)] Reading from file.: '", _reader.getFileName() , "'" );
-    LOG( "[genomeMaker::SequencerSim::start(..)] Read length.......: ", read_length );
-    LOG( "[genomeMaker::SequencerSim::start(..)] Depth of reads....: ", read_depth );
-    LOG( "[genomeMaker::SequencerSim::start(..)] Error rate........: ", error_rate );
-    LOG( "[genomeMaker::SequencerSim::start(..)] Calculated #reads.: ~", reads_total );
-    LOG( "[genomeMaker::SequencerSim::start(..)] Calculated #errors: ~", _total_read_errors, "/", reads_total );
-    LOG( "[genomeMaker::SequencerSim::start(..)] Writing to file...: '", _writer.getFileName() , "'" );
-    //Starting sequencing..
-    std::cout << "...Starting..." << std::endl;
-    return sequenceGenome( read_length, read_depth, reads_total, _total_read_errors );
+    LOG( "[genomeMaker::SequencerSim::prepare(..)] Reading from file.: '", _genome.getFileName() , "'" );
+    LOG( "[genomeMaker::SequencerSim::prepare(..)] Read length.......: ", ( _length_model ? "variable, mean " + std::to_string( mean_length ) + ", max " : "" ), read_length );
+    if( _tile_stride > 0 ) {
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Tiling............: every ", _tile_stride, " bases" );
+    } else {
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Depth of reads....: ", read_depth );
+    }
+    LOG( "[genomeMaker::SequencerSim::prepare(..)] Error rate........: ", error_rate );
+    if( _genome.isStreamed() ) {
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Reads per base....: ", read_rate, " (streamed genome)" );
+    } else {
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Calculated #reads.: ~", reads_total );
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Expected #errors..: ~", _read_errors.expected( reads_total ), "/", reads_total );
+    }
+    LOG( "[genomeMaker::SequencerSim::prepare(..)] Output format.....: ", ( _quality_model ? "FASTQ" : "FASTA" ) );
+    LOG( "[genomeMaker::SequencerSim::prepare(..)] Strand(s).........: ", ( _both_strands ? "both" : "forward" ) );
+    LOG( "[genomeMaker::SequencerSim::prepare(..)] Seed..............: ", _seed );
+    if( _target_regions ) {
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Target regions....: ", _target_regions->size(), " (",
+             _target_regions->targetBases(), " bases, ", _target_regions->offTargetRate(), " off-target)" );
+    }
+    if( _coverage_bias ) {
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Coverage bias.....: ", _coverage_bias->windows(), " windows" );
+    }
+    if( _fragment_model ) {
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Paired reads......: max fragment ", _fragment_model->maxLength(),
+             ( _mate_writer ? ", mates in '" + _mate_writer->getFileName() + "'" : ", interleaved" ) );
+    }
+    if( _part > 0 ) { //only the reads missing for the depth
+        if( reads_total <= _reads_done ) {
+            LOG_ERROR( "[genomeMaker::SequencerSim::prepare(..)] Reads on disk ('", _reads_done, "') already reach the depth ('", reads_total, "')." );
+            std::cerr << "Error: the reads on disk (" << _reads_done << ") already reach a depth of " << read_depth << "." << std::endl;
+            return false;
+        }
+        LOG( "[genomeMaker::SequencerSim::prepare(..)] Top-up #", _part, "........: ", reads_total - _reads_done, " reads after the ", _reads_done, " on disk" );
+        reads_total -= _reads_done;
+    }
+    if( reads_total < 1 && !_genome.isStreamed() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepare(..)] Number of reads calculated ('", reads_total, "') too low." );
+        std::cerr << "Error: Number of reads calculated based on arguments is too low for the size of the genome." << std::endl;
+        return false;
+    }
+    //Setting up the read starts and ground truth
+    _letters = _genome.detectLetterSet();
+    _rna     = _letters.find( 'U' ) != std::string::npos;
+    LOG( "[genomeMaker::SequencerSim::prepare(..)] Letter set used for substitutions: ", _letters );
+    _read_length = read_length;
+    _span        = span;
+    _reads_total = reads_total;
+    _clean_tiles = _tile_stride > 0 && !_fragment_model && !_length_model && !_quality_model && !_error_hotspots
+                   && !_error_model->isActive() && error_rate <= 0 && _reservoir_size == 0;
+    if( _tile_stride > 0 ) {
+        _starts = StartStream::tiling( _tile_stride, _genome.genomeSize() - span + 1 );
+    } else {
+        _starts = _genome.isStreamed()
+                  ? StartStream( read_rate, _seed )
+                  : StartStream( reads_total, _genome.genomeSize() - span + 1, partSeed() );
+    }
+    if( _target_regions ) {
+        _starts.setTargetRegions( *_target_regions );
+    }
+    if( _coverage_bias ) {
+        _starts.setCoverageBias( *_coverage_bias );
+    }
+    _current     = &_starts;
+    _read_seed   = partSeed();
+    _pending     = false;
+    _batch_size  = std::max( std::min( _BATCH_READS, _BATCH_BASES / ( _fragment_model ? 2 * mean_length : mean_length ) ), size_t( 1 ) );
+    _batch._numbers.clear();
+    _batch_next  = 0;
+    _layers.clear();
+    if( _coverage_target && !prepareLayers( reads_total, _genome.genomeSize() - span + 1, read_depth ) ) {
+        return false;
+    }
+    _total_reads_completed = _reads_done;
+    return true;
 }
 
 /**
@@ -101,297 +558,1086 @@ uint64_t genomeMaker::SequencerSim::calcReadCount( const std::streampos &genome_
 }
 
 /**
- * Calculates the number of read errors over the total number of reads based on the rate given
- * @param reads_total Total number of reads
- * @param error_rate  Error rate on the reads
- * @return Upper bound number for the eroneous reads
- */
-uint64_t genomeMaker::SequencerSim::calcErrorUpperBound( const uint64_t &reads_total, const double &error_rate ) const {
-    //TODO clean all of this.. horrible hackety-hack prone to failing miserably when a file size is extremely large and the error rate is high too
-    if( error_rate == 0 ) return 0;
-    unsigned count { 0 };
-    double   err   { error_rate };
-    double   part  { 0 };
-    uint64_t reads { reads_total };
-    std::cout << std::fixed;
-    bool done { false };
-    while( !done ) {
-        if( err * 10 >= 1 ) {
-            done = true;
-        } else {
-            count++;
-            reads /= 10;
-            err *= 10;
+ * Generates the reads whose template is held in the genome window
+ * Note: reads come in the order of their start on the genome. They are drawn in batches (see
+ *       drawBatch(..)) then rendered one after the other. When a read needs more of the genome
+ *       than the window holds it is kept pending (with the rest of its batch) until the window
+ *       has moved along.
+ * @return Step state (DONE when all reads are done, MORE when the window needs to move along)
+ */
+genomeMaker::SequencerSim::Step genomeMaker::SequencerSim::sequenceWindow() {
+    while( true ) {
+        if( !_pending ) {
+            if( _batch_next >= _batch._numbers.size() ) {
+                if( _genome.isStreamed() ) { //starts are placed as the genome comes in
+                    _starts.extend( streamedRange(), _genome.isComplete() );
+                    if( !_starts.ready() ) {
+                        return Step::MORE;
+                    }
+                }
+                if( drawBatch( _batch_size ) == 0 ) {
+                    if( _genome.isStreamed() && _genome.genomeSize() < _span ) {
+                        LOG_ERROR( "[genomeMaker::SequencerSim::sequenceWindow()] "
+                            "Streamed genome ('", _genome.genomeSize(), "') smaller than a read span ('", _span, "')." );
+                        std::cerr << "Error: The genome is too small for the length of the reads." << std::endl;
+                        return Step::FAILED;
+                    }
+                    return Step::DONE;
+                }
+                _batch_next = 0;
+            }
+            loadRead( _batch_next++ );
+            _pending = true;
+            if( _coverage_track && !_coverage_track->advance( _pending_floor ) ) { //no read from now on starts before
+                std::cerr << "Error: could not write to the coverage track." << std::endl;
+                std::cerr << "Aborting..." << std::endl;
+                return Step::FAILED;
+            }
+        }
+        if( _pending_end > _genome.end() && !_genome.isComplete() ) {
+            return Step::MORE;
+        }
+        if( _pending_end > _genome.end() ) { //streamed genome ending before the template does
+            for( size_t i = 0; i < _pending_segments; i++ ) {
+                _segments[ i ]._fragment_bases = std::min( _segments[ i ]._fragment_bases,
+                                                           static_cast<size_t>( _genome.end() - _segments[ i ]._start ) );
+            }
+        }
+        renderRead();
+        _pending = false;
+        if( _sorter ) {
+            const uint64_t key = _sort_key == SortKey::RANDOM
+                                 ? CounterRng::key( _seed, _read_number - 1, _SHUFFLE_STREAM )
+                                 : leftmost( _segments[ 0 ] );
+            uint32_t bases { 0 };
+            for( size_t i = 0; i < _pending_segments; i++ ) {
+                bases += static_cast<uint32_t>( _segments[ i ]._length );
+            }
+            if( !_sorter->add( key, _output, _mate_output, _read_truth, bases ) ) {
+                std::cerr << "Aborting..." << std::endl;
+                return Step::FAILED;
+            }
+            _output.clear();
+            _mate_output.clear();
+            _read_truth.clear();
+            continue;
+        }
+        if( _rendered && _rendered->_sequences.size() >= _OUTPUT_BUFFER_SIZE && !flushSinks() ) {
+            std::cerr << "Error: could not write read #" << _read_number << " to the extra outputs." << std::endl;
+            std::cerr << "Aborting..." << std::endl;
+            return Step::FAILED;
+        }
+        //Writing reads to sequencer file(s)
+        if( _output.size() >= _OUTPUT_BUFFER_SIZE && !flushOutput() ) {
+            LOG_ERROR( "[genomeMaker::SequencerSim::sequenceWindow()] Error occurred whilst writing read #",
+                       _read_number, " to file '", _writer.getFileName(), "'." );
+            std::cerr << "Error: could not write read #" << _read_number << " to sequencer file." << std::endl;
+            std::cerr << "Aborting..." << std::endl;
+            return Step::FAILED;
         }
-    }
-    if( std::numeric_limits<double>::max() < reads) { //crap!
-        std::cerr << "Error: could not drop read count into a manageable size for error rate calculation...";
-        std::cerr << "       Returning error injection count of 0 back. Sorry :(" << std::endl;
-        return 0;
-    } else {
-        uint64_t result = std::ceil( static_cast<double>( reads ) * err );
-        return result;
     }
 }
 
 /**
- * Creates a randomised set of read indices that should be injected with an error
- * @param reads_total Total number of reads to do on the genome
- * @param errors      Total number of errors to inject
- * @return Ordered stack of read indices
+ * Generates a single read on its own (random access)
+ * Note: a read only depends on the seed and its number so it comes out the same as in a full
+ *       run with the same options, in O(read length). The genome window needs to hold all of
+ *       the genome (memory mapped).
+ * @param number Read number (1 to readCount())
+ * @param record Output for the record(s) of the read (mate #2 after mate #1)
+ * @param truth  Output for the truth records of the read's segments
+ * @return Success
  */
-std::stack<uint64_t> genomeMaker::SequencerSim::createErrorStack( const uint64_t &reads_total, const uint64_t &errors ) {
-    Randomiser randomiser( 1, reads_total );
-    std::vector<uint64_t> read_pool;
-    for( uint64_t i = 0; i < errors; i++ ) {
-        //as using uniform distribution it's very unlikely to get repeats.
-        read_pool.emplace_back( randomiser.getRand());
+bool genomeMaker::SequencerSim::sequenceRead( const uint64_t &number, std::string &record, std::vector<TruthRecord> &truth ) {
+    if( !_layers.empty() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::sequenceRead( ", number, ", <record>, <truth> )] "
+            "Reads of a coverage target run cannot be generated on their own." );
+        return false;
     }
-    std::sort( read_pool.begin(), read_pool.end(), std::greater<uint64_t>());
-    std::stack<uint64_t> stack;
-    for( auto n : read_pool ) {
-        stack.push( n );
+    if( _reservoir_size > 0 ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::sequenceRead( ", number, ", <record>, <truth> )] "
+            "Reads of a run with duplicates depend on the reads before them." );
+        return false;
+    }
+    if( number < 1 || number > _reads_total ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::sequenceRead( ", number, ", <record>, <truth> )] "
+            "Read number out of range (1-", _reads_total, ")." );
+        return false;
     }
-    return stack;
+    _starts.seek( number - 1 );
+    _total_reads_completed = number - 1;
+    _output.clear();
+    _mate_output.clear();
+    if( drawBatch( 1 ) == 0 ) {
+        return false;
+    }
+    loadRead( 0 );
+    if( _pending_end > _genome.end() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::sequenceRead( ", number, ", <record>, <truth> )] "
+            "Genome window does not hold the read's template (up to ", _pending_end, ")." );
+        return false;
+    }
+    std::vector<TruthRecord> *truth_records = _truth_records;
+    _truth_records = &truth;
+    renderRead();
+    _truth_records = truth_records;
+    record = _output;
+    record.append( _mate_output );
+    _output.clear();
+    _mate_output.clear();
+    return true;
+}
+
+/**
+ * Gets the number of reads (or pairs) of the simulation
+ * @return Number of reads
+ */
+uint64_t genomeMaker::SequencerSim::readCount() const {
+    return _reads_total;
+}
+
+/**
+ * Gets the number of reads completed (reads on disk before a top-up included)
+ * @return Number of reads
+ */
+uint64_t genomeMaker::SequencerSim::readsCompleted() const {
+    return _total_reads_completed;
 }
 
 /**
- * Calculates the number of reads to do on a chunk
- * @param genome_size Size of the genome (#chars)
- * @param genome_chunks Number of complete chunks the genome is broken into
- * @param chunk_size Size of chunk
- * @return Number of reads on the chunk
+ * Gets the genome position of the first character needed by the pending read
+ * Note: with a streamed genome the simulator can also be waiting on the next read start. Fragments
+ *       kept for duplicates are still needed.
+ * @return Genome position
  */
-uint64_t genomeMaker::SequencerSim::calcChunkReads( const uint64_t &genome_size,
-                                                    const uint64_t &reads_total,
-                                                    const uint64_t &genome_chunks,
-                                                    const size_t &chunk_size ) const {
-    uint64_t reads = ( chunk_size * 100 / genome_size ) * reads_total / 100; //even-distribution of reads
-    if( reads > 0 ) {
-        LOG_DEBUG( "[genomeMaker::SequencerSim::calcChunkReads( ", genome_size, ", ", reads_total, ", ", genome_chunks, ", ", chunk_size, " )] "
-            "Even-distribution of reads for chunk size'", chunk_size, "': ", reads );
-        return reads;
+uint64_t genomeMaker::SequencerSim::pendingStart() const {
+    return _pending ? _pending_floor : oldestFragment( _starts.lowerBound() );
+}
+
+/**
+ * Finishes the simulation (flushes the outputs and logs the stats)
+ * @return Success
+ */
+bool genomeMaker::SequencerSim::finish() {
+    if( !flushOutput() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::finish()] Problem occurred whilst flushing the last reads to file '", _writer.getFileName(), "'." );
+        return false;
+    }
+    if( _rendered && !flushSinks() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::finish()] Problem occurred whilst handing the last reads to the extra outputs." );
+        return false;
+    }
+    for( ReadSink *sink : _sinks ) {
+        if( !sink->finish() ) {
+            std::cerr << "Error: could not write to the extra output '" << sink->getFileName() << "'." << std::endl;
+            return false;
+        }
+    }
+    if( _depth_index ) { //genome size only known now for a streamed genome
+        if( !_depth_index->open( _genome.genomeSize() ) ) {
+            std::cerr << "Error: could not create the depth index." << std::endl;
+            return false;
+        }
+        _sorter->setDepthIndex( *_depth_index );
+    }
+    if( _sorter && !_sorter->finish() ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::finish()] Problem occurred whilst writing the sorted reads to file '", _writer.getFileName(), "'." );
+        return false;
+    }
+    if( _depth_index && !_depth_index->finish() ) {
+        std::cerr << "Error: could not write to the depth index." << std::endl;
+        return false;
+    }
+    if( _coverage_track && !_coverage_track->finish( _genome.genomeSize() ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::finish()] Problem occurred whilst writing the coverage track." );
+        std::cerr << "Error: could not write to the coverage track." << std::endl;
+        return false;
+    }
+    LOG( "[genomeMaker::SequencerSim::finish()] Sequencer file: '", _writer.getFileName(), "'" );
+    LOG( "[genomeMaker::SequencerSim::finish()] Reads completed: ", _total_reads_completed );
+    LOG( "[genomeMaker::SequencerSim::finish()] Erroneous reads: ", _total_read_errors );
+    LOG( "[genomeMaker::SequencerSim::finish()] Injected base errors: ", _total_base_errors );
+    if( _both_strands ) {
+        LOG( "[genomeMaker::SequencerSim::finish()] Reverse strand reads: ", _total_reverse_reads );
+    }
+    if( _quality_model ) {
+        LOG( "[genomeMaker::SequencerSim::finish()] Quality driven base errors: ", _total_quality_errors );
     }
-    uint64_t reads_alt = reads_total / genome_chunks; //rough distribution of reads
-    if( reads_alt > 0 ) {
-        LOG_DEBUG( "[genomeMaker::SequencerSim::calcChunkReads( ", genome_size, ", ", reads_total, ", ", genome_chunks, ", ", chunk_size, " )] "
-            "Rough distribution of reads for chunk size '", chunk_size, "': ", reads_alt );
-        return reads_alt;
+    if( _total_chimeras > 0 ) {
+        LOG( "[genomeMaker::SequencerSim::finish()] Chimeric reads: ", _total_chimeras );
     }
-    LOG_ERROR( "[genomeMaker::SequencerSim::calcChunkReads( ", genome_size, ", ", reads_total, ", ", genome_chunks, ", ", chunk_size, " )] "
-        "Could not calculate a number of reads for chunk." );
-    return 0;
+    if( _reservoir_size > 0 ) {
+        LOG( "[genomeMaker::SequencerSim::finish()] Duplicate reads: ", _total_duplicates );
+    }
+    if( _truth_writer ) {
+        LOG( "[genomeMaker::SequencerSim::finish()] Truth records: ", _truth_writer->records(), " (", _truth_writer->bytes(), " bytes)" );
+    }
+    std::cout << "-> Total number of reads taken for '" << _writer.getFileName() << "': " << _total_reads_completed << std::endl;
+    return true;
 }
 
 /**
- * Calculates the maximum start index for a read on the buffer
- * @param current_buffer_size Size of the current buffer
- * @param next_buffer_size    Size of the next buffer
- * @param read_length         Length of a read
- * @return Maximum start index for a read
- * @throws std::out_of_range when the current buffer size is smaller than a read length
+ * Gets the number of keys drawn from each read's random stream
+ * Note: error rate, chimeras, error model, quality, fragment, length and strands, then the error
+ *       hotspots and the duplicates only when used so the reads do not change otherwise
+ * @return Number of keys
  */
-size_t genomeMaker::SequencerSim::calcMaxIndex( const std::streamsize &current_buffer_size,
-                                                const std::streamsize &next_buffer_size,
-                                                const size_t &read_length ) const {
-    //Error control
-    if( read_length > current_buffer_size ) {
-        LOG_ERROR( "[genomeMaker::SequencerSim::calcMaxIndex( ", current_buffer_size, ", ", next_buffer_size, ", ", read_length, " )] "
-            "Buffer size is too small for a full length read to happen." );
-        throw std::out_of_range( "Current buffer is too small for a read!" );
+size_t genomeMaker::SequencerSim::keyDraws() const {
+    return 7 + ( _error_hotspots ? 1 : 0 ) + ( _reservoir_size > 0 ? 2 : 0 );
+}
+
+/**
+ * Restarts the random streams used to draw a read of the batch on the read's own keys
+ * Note: keys are drawn whether or not their model is used so they only depend on the read. The
+ *       quality model and the error hotspots are only used for rendering (see loadRead(..)).
+ * @param read Read of the batch
+ */
+void genomeMaker::SequencerSim::reseedRead( const size_t &read ) {
+    const size_t reads { _batch._numbers.size() };
+    const size_t draws { keyDraws() };
+    auto key = [&]( const size_t &draw ) { return _batch._keys[ draw * reads + read ]; };
+    _read_rng.seed( _batch._read_keys[ read ], draws );
+    _read_errors.reseed( key( 0 ) );
+    _chimeras.reseed( key( 1 ) );
+    _error_model->reseed( key( 2 ) );
+    if( _fragment_model ) {
+        _fragment_model->reseed( key( 4 ) );
     }
-    if( next_buffer_size > read_length - 1 ) {
-        return current_buffer_size > 0 ? (size_t) current_buffer_size - 1 : 0;
-    } else {
-        return current_buffer_size - read_length + next_buffer_size;
+    if( _length_model ) {
+        _length_model->reseed( key( 5 ) );
+    }
+    _strand_bits = key( 6 );
+    if( _reservoir_size > 0 ) {
+        _duplicates.reseed( key( draws - 2 ) );
+        _mutations.reseed( key( draws - 1 ) );
     }
 }
 
 /**
- * Run the sequencer simulation on the provided genome file
- * @param read_length     Length of reads
- * @param read_depth      Depth of the reads
- * @param reads_total     Total number of reads to do on genome
- * @param erroneous_reads Number of erroneous reads
+ * Works out how many layers of reads are needed to meet the coverage target
+ * Note: each layer is an independent set of reads (1/4x) with its own seed. The layers are drawn
+ *       one after the other until the target is met or the read depth given is reached, then
+ *       set up to be merged by position. Reads are only drawn and not rendered so the genome is
+ *       not read.
+ * @param reads_total Number of reads for the read depth
+ * @param range       Range of the read starts
+ * @param read_depth  Read depth (cap on the layers)
  * @return Success
  */
-bool genomeMaker::SequencerSim::sequenceGenome( const size_t &read_length,
-                                                const size_t &read_depth,
-                                                const uint64_t &reads_total,
-                                                const uint64_t &erroneous_reads ) {
-    //Setting things up
-    const size_t   chunk_size       { read_length * 4 };
-    const uint64_t genome_size      { _reader.size() > 0 ? (uint64_t) _reader.size() : 0 };
-    const uint64_t genome_chunks    { genome_size / chunk_size };
-    u_int64_t      processed_chunks { 0 };
-    LOG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Genome size (#chars)...........: ", genome_size );
-    LOG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Size of genome chunks from file: ", chunk_size );
-    LOG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Number of chunks to process....: ", genome_chunks );
-    LOG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Size of remainder for chunks...: ", genome_size % chunk_size );
-
-    //Calculating and error checking number of reads per full sized genome chunks
-    uint64_t reads_per_chunk = calcChunkReads( genome_size, reads_total, genome_chunks, chunk_size );
-    if( reads_per_chunk < 1 ) {
-        LOG_ERROR( "[genomeMaker::SequencerSim::sequenceGenome(..)] Number of reads calculated ('", reads_per_chunk, "') too low." );
-        std::cerr << "Error: Number of reads calculated based on arguments is too low for the size of the genome." << std::endl;
+bool genomeMaker::SequencerSim::prepareLayers( const uint64_t &reads_total, const uint64_t &range, const size_t &read_depth ) {
+    if( !_coverage_target->build( _genome.genomeSize(), _min_coverage, _covered_fraction ) ) {
+        LOG_ERROR( "[genomeMaker::SequencerSim::prepareLayers( ", reads_total, ", ", range, ", ", read_depth, " )] "
+            "Could not build the coverage target over the genome." );
+        std::cerr << "Error: invalid coverage target." << std::endl;
         return false;
     }
-    LOG( "[genomeMaker::SequencerSim::sequenceGenome(..)] #reads per whole chunks........: ", reads_per_chunk );
+    const size_t   max_layers  = read_depth * _LAYERS_PER_X;
+    const uint64_t layer_reads = std::max( reads_total / max_layers, (uint64_t) 1 );
+    size_t layers { 0 };
+    while( layers < max_layers && !_coverage_target->isMet() ) {
+        _starts    = StartStream( layer_reads, range, layerSeed( layers ) );
+        _read_seed = layerSeed( layers );
+        if( _coverage_bias ) {
+            _starts.setCoverageBias( *_coverage_bias );
+        }
+        while( drawBatch( _batch_size ) > 0 ) {
+            for( size_t read = 0; read < _batch._numbers.size(); read++ ) {
+                loadRead( read );
+                if( _fragment_model ) {
+                    placeMates( _pending_fragment );
+                    for( size_t i = 0; i < 2; i++ ) {
+                        const Segment &mate  = _segments[ i ];
+                        const uint64_t first = mate._reverse ? mate._anchor + 1 - mate._fragment_bases : mate._anchor;
+                        _coverage_target->add( first, first + mate._fragment_bases );
+                    }
+                } else {
+                    for( size_t i = 0; i < _pending_segments; i++ ) {
+                        _coverage_target->add( _segments[ i ]._start, _segments[ i ]._start + _segments[ i ]._fragment_bases );
+                    }
+                }
+            }
+        }
+        layers++;
+    }
+    LOG( "[genomeMaker::SequencerSim::prepareLayers(..)] Coverage target...: ", _coverage_target->coveredFraction(),
+         " of the genome at ", _min_coverage, "x with ", layers, "/", max_layers, " layers of ", layer_reads, " reads" );
+    std::cout << "-> Coverage target " << ( _coverage_target->isMet() ? "met" : "NOT met (depth cap reached)" )
+              << " with " << layers << " layers: " << _coverage_target->coveredFraction() * 100
+              << "% of the genome at " << _min_coverage << "x" << std::endl;
+    //Setting up the layers to be merged by position
+    for( size_t i = 0; i < layers; i++ ) {
+        _layers.emplace_back( StartStream( layer_reads, range, layerSeed( i ) ) );
+        if( _coverage_bias ) {
+            _layers.back().setCoverageBias( *_coverage_bias );
+        }
+    }
+    _layer_heads = decltype( _layer_heads )();
+    for( size_t i = 0; i < _layers.size(); i++ ) {
+        uint64_t position { 0 };
+        if( _layers[ i ].at( 0, position ) ) {
+            _layer_heads.emplace( position, i );
+        }
+    }
+    _reads_total           = layers * layer_reads;
+    _total_reads_completed = 0;
+    _total_read_errors     = 0;
+    _total_reverse_reads   = 0;
+    _total_chimeras        = 0;
+    _total_duplicates      = 0;
+    _reservoir.clear();
+    _reservoir_next        = 0;
+    _batch._numbers.clear();
+    _batch_next            = 0;
+    return true;
+}
 
-    //Getting indices of reads to inject errors in
-    std::stack<uint64_t> read_error_pool = createErrorStack( reads_total, erroneous_reads );
+/**
+ * Gets the seed of a layer of reads
+ * Note: the first layer uses the run's seed as is, the others a key drawn from it
+ * @param layer Layer index
+ * @return Seed
+ */
+uint64_t genomeMaker::SequencerSim::layerSeed( const size_t &layer ) const {
+    return layer == 0 ? _seed : CounterRng::key( _seed, layer, _LAYER_STREAM );
+}
 
-    eadlib::cli::ProgressBar progress( genome_size, 70 );
-    progress.printPercentBar( std::cout, 0 );
+/**
+ * Gets the seed of the reads of this run
+ * Note: the first run uses the seed as is, top-ups a key drawn from it and their number
+ * @return Seed
+ */
+uint64_t genomeMaker::SequencerSim::partSeed() const {
+    return _part == 0 ? _seed : CounterRng::key( _seed, _part, _PART_STREAM );
+}
 
-    Buffers buffer;
-    buffer._current_size = _reader.read( *buffer._current, chunk_size );
+/**
+ * Moves on to the layer holding the lowest of the next read starts
+ * Note: ties go to the lowest layer so the order only depends on the seed
+ * @return Success (false when all the layers are done)
+ */
+bool genomeMaker::SequencerSim::nextLayer() {
+    if( _layer_heads.empty() ) {
+        return false;
+    }
+    const size_t layer = _layer_heads.top().second;
+    _layer_heads.pop();
+    _current   = &_layers[ layer ];
+    _read_seed = layerSeed( layer );
+    uint64_t position { 0 };
+    if( _current->at( _current->index() + 1, position ) ) {
+        _layer_heads.emplace( position, layer );
+    }
+    return true;
+}
 
-    bool data_remaining_flag { true };
-    do {
-        progress.printPercentBar( std::cout, 0 );
-        if( buffer._current_size < 1 || buffer._current_size < read_length) { //Got nothing from read || not enough to do a full length read
-            data_remaining_flag = false;
+/**
+ * Draws the next batch of reads ahead of rendering them
+ * Note: the starts of the reads are gathered first, then the keys of the reads' random streams
+ *       are derived for the whole batch in one go, a column at a time, and the reads are drawn
+ *       one after the other from their keys. Everything a read needs for rendering is kept in
+ *       the batch's columns (see loadRead(..)). Reads come out as if drawn one at a time as
+ *       each only depends on its own keys (and with duplicates on the fragments before it).
+ * @param max_reads Most reads to draw
+ * @return Number of reads drawn (0 when there are no more reads to do)
+ */
+size_t genomeMaker::SequencerSim::drawBatch( const size_t &max_reads ) {
+    if( _clean_tiles ) {
+        return drawTiles( max_reads );
+    }
+    ReadBatch &batch = _batch;
+    for( auto *column : { &batch._seeds, &batch._indices, &batch._starts, &batch._next_starts, &batch._remaining, &batch._numbers,
+                          &batch._error_draws, &batch._floors, &batch._ends, &batch._duplicates, &batch._segment_starts } ) {
+        column->clear();
+    }
+    for( auto *column : { &batch._fragments, &batch._first_segments, &batch._read_lengths, &batch._fragment_bases, &batch._first_errors } ) {
+        column->clear();
+    }
+    for( auto *column : { &batch._fragment_reverse, &batch._segment_counts, &batch._reverse, &batch._mates } ) {
+        column->clear();
+    }
+    batch._error_counts.clear();
+    batch._errors.clear();
+    //Read starts (the second segment of a chimeric read starts where the next read does)
+    const bool chimeras { _length_model && _chimeras.probability() > 0 };
+    while( batch._numbers.size() < max_reads ) {
+        if( _genome.isStreamed() && !_starts.ready() ) {
+            break;
+        }
+        if( !_layers.empty() && !nextLayer() ) {
+            break;
+        }
+        const uint64_t index { _current->index() };
+        uint64_t start { 0 }, next_start { 0 };
+        if( !_current->next( start ) ) {
+            break;
+        }
+        const uint64_t remaining { _current->remaining() };
+        if( chimeras && remaining > 0 ) {
+            _current->at( index + 1, next_start );
+        }
+        batch._seeds.emplace_back( _read_seed );
+        batch._indices.emplace_back( index );
+        batch._starts.emplace_back( start );
+        batch._next_starts.emplace_back( next_start );
+        batch._remaining.emplace_back( remaining );
+        batch._numbers.emplace_back( ++_total_reads_completed );
+    }
+    //Keys of the reads' random streams
+    const size_t reads { batch._numbers.size() };
+    batch._read_keys.resize( reads );
+    batch._keys.resize( reads * keyDraws() );
+    CounterRng::keys( batch._seeds.data(), batch._indices.data(), reads, _READ_STREAM, batch._read_keys.data() );
+    CounterRng::fill( batch._read_keys.data(), reads, keyDraws(), batch._keys.data() );
+    //Reads
+    for( size_t read = 0; read < reads; read++ ) {
+        _read_number = batch._numbers[ read ];
+        reseedRead( read );
+        _duplicate_of = 0;
+        if( !_reservoir.empty() && _duplicates.next() ) { //read start drawn is given up for the fragment's
+            reuseFragment( _reservoir[ _read_rng() % _reservoir.size() ] );
         } else {
-            processed_chunks++;
-            LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Processing chunk #", processed_chunks , "/", genome_chunks );
-            buffer._next_size = _reader.read( *buffer._next, chunk_size );
-            if( buffer._current_size < chunk_size ) { //EOF reached during 'current' read
-                //This block kept for safety but should never trigger as when the cached 'next' buffer hits EOF it gets merged with the current.
-                LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Inside the section where the current buffer read hits EOF on the genome!" );
-                if( !sequenceGenomeChunk( read_length, reads_per_chunk, read_error_pool, buffer )) {
-                    LOG_ERROR( "[genomeMaker::SequencerSim::sequenceGenome( ", read_length, ", ", read_depth, ", ", reads_total, " )] "
-                        "Problem occurred whilst processing genome chunk #", processed_chunks, "/", genome_chunks, ". (EOF chunk)" );
-                    return false;
-                }
-                data_remaining_flag = false;
-            } else if( buffer._next_size < chunk_size ) { //EOF reached during 'next' read
-                LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenome(..)] EOF reached whilst caching 'next' buffer." );
-                LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Merging buffers... ", buffer._current_size, " + ", buffer._next_size );
-                //concatenating 'next' buffer into 'current'
-                buffer._current->insert( buffer._current->end(), buffer._next->begin(), buffer._next->end() );
-                buffer._current_size += buffer._next_size;
-                buffer._next_size = 0;
-                //getting number of reads for merged chunks
-                size_t   merged_size     = chunk_size + ( genome_size % chunk_size );
-                uint64_t reads_on_merged = calcChunkReads( genome_size, reads_total, genome_chunks, merged_size );
-                if( reads_on_merged < 1 ) {
-                    LOG_ERROR( "[genomeMaker::SequencerSim::sequenceGenome( ", read_length, ", ", read_depth, ", ", reads_total, " )] "
-                        "could not get a number of reads for genome chunk #", processed_chunks, "/", genome_chunks, ". (EOF merged chunk)" );
-                    return false;
-                }
-                LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Number of reads on merged chunk: ", reads_on_merged );
-                if( !sequenceGenomeChunk( read_length, reads_on_merged, read_error_pool, buffer )) {
-                    LOG_ERROR( "[genomeMaker::SequencerSim::sequenceGenome( ", read_length, ", ", read_depth, ", ", reads_total, " )] "
-                        "Problem occurred whilst processing genome chunk #", processed_chunks, "/", genome_chunks, ". (EOF merged chunk)" );
-                    return false;
-                }
-                progress += reads_on_merged;
-                data_remaining_flag = false;
-            } else { //Both 'current' and 'next' buffers are fully filled
-                if( !sequenceGenomeChunk( read_length, reads_per_chunk, read_error_pool, buffer )) {
-                    LOG_ERROR( "[genomeMaker::SequencerSim::sequenceGenome( ", read_length, ", ", read_depth, ", ", reads_total, " )] "
-                        "Problem occurred whilst processing genome chunk ", processed_chunks, "/", genome_chunks, ". (STD chunk)" );
-                    return false;
-                }
-                buffer.swapBuffers();
-                progress += reads_per_chunk;
+            drawFragment( read );
+            if( _reservoir_size > 0 ) {
+                keepFragment();
             }
         }
-    } while( data_remaining_flag );
+        drawErrors();
+        storeRead();
+    }
+    return reads;
+}
+
+/**
+ * Draws the next batch of error-free tiles
+ * Note: with nothing to draw but the strands the reads are only their start and the strand bits
+ *       of their random stream (the same as drawBatch(..) would use) so they are rendered straight
+ *       from the genome window without going through the models (see loadTile(..)).
+ * @param max_reads Most reads to draw
+ * @return Number of reads drawn (0 when there are no more reads to do)
+ */
+size_t genomeMaker::SequencerSim::drawTiles( const size_t &max_reads ) {
+    ReadBatch &batch = _batch;
+    for( auto *column : { &batch._seeds, &batch._indices, &batch._starts, &batch._numbers } ) {
+        column->clear();
+    }
+    batch._reverse.clear();
+    while( batch._numbers.size() < max_reads ) {
+        const uint64_t index { _current->index() };
+        uint64_t start { 0 };
+        if( !_current->next( start ) ) {
+            break;
+        }
+        batch._seeds.emplace_back( _read_seed );
+        batch._indices.emplace_back( index );
+        batch._starts.emplace_back( start );
+        batch._numbers.emplace_back( ++_total_reads_completed );
+    }
+    const size_t reads { batch._numbers.size() };
+    if( _both_strands ) {
+        batch._read_keys.resize( reads );
+        CounterRng::keys( batch._seeds.data(), batch._indices.data(), reads, _READ_STREAM, batch._read_keys.data() );
+        for( size_t read = 0; read < reads; read++ ) {
+            _read_rng.seed( batch._read_keys[ read ], 6 ); //strand bits are the 7th key (see reseedRead(..))
+            _strand_bits = _read_rng();
+            batch._reverse.emplace_back( nextStrand() ? 1 : 0 );
+        }
+    }
+    return reads;
+}
 
-    progress.complete().printPercentBar( std::cout, 0 );
-    LOG( "[genomeMaker::SequencerSim::sequenceGenome(..)] Reads completed: ", _total_reads_completed );
-    std::cout << "\n-> Total number of reads taken: " << _total_reads_completed << std::endl;
-    return true;
+/**
+ * Adds the pending read to the batch's columns
+ */
+void genomeMaker::SequencerSim::storeRead() {
+    ReadBatch &batch = _batch;
+    batch._error_draws.emplace_back( _error_model->draws() );
+    batch._floors.emplace_back( oldestFragment( _segments[ 0 ]._start ) );
+    batch._ends.emplace_back( _pending_end );
+    batch._duplicates.emplace_back( _duplicate_of );
+    batch._fragments.emplace_back( _pending_fragment );
+    batch._fragment_reverse.emplace_back( _pending_reverse ? 1 : 0 );
+    batch._first_segments.emplace_back( batch._segment_starts.size() );
+    batch._segment_counts.emplace_back( static_cast<uint8_t>( _pending_segments ) );
+    for( size_t i = 0; i < _pending_segments; i++ ) {
+        const Segment &segment = _segments[ i ];
+        batch._segment_starts.emplace_back( segment._start );
+        batch._reverse.emplace_back( segment._reverse ? 1 : 0 );
+        batch._mates.emplace_back( segment._mate );
+        batch._read_lengths.emplace_back( segment._read_length );
+        batch._fragment_bases.emplace_back( segment._fragment_bases );
+        batch._first_errors.emplace_back( batch._errors.size() );
+        batch._error_counts.emplace_back( static_cast<uint32_t>( segment._errors.size() ) );
+        batch._errors.insert( batch._errors.end(), segment._errors.begin(), segment._errors.end() );
+    }
 }
 
 /**
- * Sequences a genome chunk
- * @param read_length            Length of reads
- * @param read_count             Number of reads to do on the chunk
- * @param erroneous_read_indices Stack of read indices where an error should be injected
- * @param buffer                 Chunk of the genome to sequence
- * @return Success
+ * Sets a read of the batch up as the pending read
+ * Note: the random streams used for rendering are restarted where the read needs them
+ * @param read Read of the batch
+ */
+void genomeMaker::SequencerSim::loadRead( const size_t &read ) {
+    if( _clean_tiles ) {
+        loadTile( read );
+        return;
+    }
+    const ReadBatch &batch = _batch;
+    const size_t reads { batch._numbers.size() };
+    _read_number      = batch._numbers[ read ];
+    _duplicate_of     = batch._duplicates[ read ];
+    _pending_floor    = batch._floors[ read ];
+    _pending_end      = batch._ends[ read ];
+    _pending_fragment = batch._fragments[ read ];
+    _pending_reverse  = batch._fragment_reverse[ read ] != 0;
+    _pending_segments = batch._segment_counts[ read ];
+    for( size_t i = 0; i < _pending_segments; i++ ) {
+        const size_t s   = batch._first_segments[ read ] + i;
+        Segment &segment = _segments[ i ];
+        segment._start          = batch._segment_starts[ s ];
+        segment._reverse        = batch._reverse[ s ] != 0;
+        segment._mate           = batch._mates[ s ];
+        segment._read_length    = batch._read_lengths[ s ];
+        segment._fragment_bases = batch._fragment_bases[ s ];
+        segment._errors.assign( batch._errors.begin() + static_cast<std::ptrdiff_t>( batch._first_errors[ s ] ),
+                                batch._errors.begin() + static_cast<std::ptrdiff_t>( batch._first_errors[ s ] + batch._error_counts[ s ] ) );
+    }
+    _error_model->resume( batch._keys[ 2 * reads + read ], batch._error_draws[ read ] );
+    if( _quality_model ) {
+        _quality_model->reseed( batch._keys[ 3 * reads + read ] );
+    }
+    if( _error_hotspots ) {
+        _error_hotspots->reseed( batch._keys[ 7 * reads + read ] );
+    }
+}
+
+/**
+ * Sets an error-free tile of the batch up as the pending read
+ * @param read Read of the batch
+ */
+void genomeMaker::SequencerSim::loadTile( const size_t &read ) {
+    const ReadBatch &batch = _batch;
+    Segment &segment = _segments[ 0 ];
+    _read_number            = batch._numbers[ read ];
+    _duplicate_of           = 0;
+    _pending_segments       = 1;
+    segment._start          = batch._starts[ read ];
+    segment._reverse        = _both_strands && batch._reverse[ read ] != 0;
+    segment._mate           = 0;
+    segment._read_length    = _read_length;
+    segment._fragment_bases = std::min( _read_length, static_cast<size_t>( _genome.genomeSize() - segment._start ) );
+    segment._errors.clear();
+    _pending_floor          = segment._start;
+    _pending_end            = segment._start + segment._fragment_bases;
+}
+
+/**
+ * Draws where the segments of the pending read are taken from
+ * @param read Read of the batch
+ */
+void genomeMaker::SequencerSim::drawFragment( const size_t &read ) {
+    if( _fragment_model ) {
+        _pending_reverse      = nextStrand();
+        _pending_fragment     = _fragment_model->sampleLength();
+        _pending_segments     = 2;
+        _segments[ 0 ]._start = _batch._starts[ read ];
+    } else {
+        //Chimeras join segments from unrelated parts of the genome
+        const size_t length   = _length_model ? _length_model->sample() : _read_length;
+        const bool   chimeric = length > 1 && _chimeras.next() && _batch._remaining[ read ] > 0;
+        _pending_segments = chimeric ? 2 : 1;
+        _segments[ 0 ]._read_length = chimeric ? 1 + _read_rng() % ( length - 1 ) : length;
+        _segments[ 1 ]._read_length = length - _segments[ 0 ]._read_length;
+        for( size_t i = 0; i < _pending_segments; i++ ) {
+            Segment &segment = _segments[ i ];
+            segment._start   = i == 0 ? _batch._starts[ read ] : _batch._next_starts[ read ];
+            segment._reverse = nextStrand();
+            segment._mate    = i == 0 ? 0 : 3;
+        }
+        _total_chimeras += chimeric ? 1 : 0;
+    }
+}
+
+/**
+ * Draws the errors of the pending read and works out how much of the genome it needs
+ * Note: the per-base errors come first as indels change the length of template needed
  */
-bool genomeMaker::SequencerSim::sequenceGenomeChunk( const size_t &read_length,
-                                                     const uint64_t &read_count,
-                                                     std::stack<uint64_t> &erroneous_read_indices,
-                                                     Buffers &buffer ) {
-    try {
-        size_t max_begin_index = calcMaxIndex( buffer._current_size, buffer._next_size, read_length );
-        _read_randomiser.setPoolRange( 0, max_begin_index ); //so that we get full read_length reads only
-        LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenomeChunk(..)] Current buffer size..: ", buffer._current_size );
-        LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenomeChunk(..)] Next buffer size.....: ", buffer._next_size );
-        LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenomeChunk(..)] Reads to do on chunk.: ", read_count );
-        LOG_DEBUG( "[genomeMaker::SequencerSim::sequenceGenomeChunk(..)] Pool range set to....: 0-", max_begin_index );
-        //Sequencing...
-        Randomiser error_randomiser( 0, read_length - 1 );
-        uint64_t   reads_done  { 0 };
-        bool       error_flag  { false };
-        size_t     error_index { 0 };
-        char       error_char  { 0 };
-
-        while( reads_done < read_count ) {
-            _total_reads_completed++;
-            //Checking if read is erroneous
-            if( !erroneous_read_indices.empty() && erroneous_read_indices.top() == _total_reads_completed ) {
-                erroneous_read_indices.pop();
-                error_index = error_randomiser.getRand();
-                LOG_TRACE( "[genomeMaker::SequencerSim::sequenceGenomeChunk(..)] Read #", _total_reads_completed, " marked for being erroneous." );
-                error_flag  = true;
+void genomeMaker::SequencerSim::drawErrors() {
+    const size_t reads { _fragment_model ? size_t( 2 ) : size_t( 1 ) };
+    for( size_t i = 0; i < _pending_segments; i++ ) {
+        Segment &segment = _segments[ i ];
+        if( _fragment_model ) {
+            segment._read_length = _read_length;
+        }
+        segment._errors.clear();
+        _error_model->sampleErrors( segment._read_length, segment._errors );
+        if( reads > 1 && i == 0 ) { //mate #1 on its own
+            addReadError( _read_length, 1 );
+        }
+    }
+    if( reads == 1 ) {
+        addReadError( _segments[ 0 ]._read_length + ( _pending_segments > 1 ? _segments[ 1 ]._read_length : 0 ), _pending_segments );
+    }
+    if( _duplicate_of > 0 && _mutations.probability() > 0 ) { //substitutions picked up by the copy
+        for( size_t i = 0; i < _pending_segments; i++ ) {
+            Segment &segment = _segments[ i ];
+            for( uint64_t p = _mutations.gap(); p < segment._read_length; p += 1 + _mutations.gap() ) {
+                _error_model->addSubstitution( static_cast<uint32_t>( p ), segment._errors );
             }
-            //Getting read from buffer
-            size_t start_index = _read_randomiser.getRand();
-            std::stringstream ss;
-            ss << ">read#" << _total_reads_completed << "\n";
-            for( size_t i = 0; i < read_length; i++ ) {
-                if( i > 0 && i % _LINE_SIZE == 0 ) {
-                    ss << "\n";
-                }
-                char c = getCharAt( buffer, start_index, i );
-                if( error_flag && i == error_index ) {
-                    size_t count { read_length };
-                    do {
-                        error_char = getCharAt( buffer, start_index, error_randomiser.getRand() );
-                    } while( count && error_char == c ); //Trying to get a different char than the one at position
-                    LOG_TRACE( "[genomeMaker::SequencerSim::sequenceGenomeChunk(..)] Injected error ('", error_char,
-                               "') in read #", _total_reads_completed, " at position ", i , " ('", c, "')." );
-                    ss << error_char;
-                    error_flag = false;
-                } else {
-                    ss << c;
+        }
+    }
+    if( _fragment_model ) {
+        _pending_end = _segments[ 0 ]._start + _pending_fragment;
+        return;
+    }
+    _pending_end = 0;
+    for( size_t i = 0; i < _pending_segments; i++ ) {
+        Segment &segment = _segments[ i ];
+        segment._fragment_bases = _error_model->templateLength( segment._read_length, segment._errors );
+        if( !_genome.isStreamed() || _genome.isComplete() ) { //streamed genome clamped once its end is known
+            segment._fragment_bases = std::min( segment._fragment_bases, static_cast<size_t>( _genome.genomeSize() - segment._start ) );
+        }
+        _pending_end = std::max( _pending_end, segment._start + segment._fragment_bases );
+    }
+}
+
+/**
+ * Keeps the fragment of the pending read in the reservoir (in place of the oldest once full)
+ */
+void genomeMaker::SequencerSim::keepFragment() {
+    Fragment fragment { _read_number, _pending_segments, { 0, 0 }, { false, false }, { 0, 0 }, _pending_fragment };
+    for( size_t i = 0; i < _pending_segments; i++ ) {
+        fragment._starts[ i ]  = _segments[ i ]._start;
+        fragment._reverse[ i ] = _fragment_model ? _pending_reverse : _segments[ i ]._reverse;
+        fragment._lengths[ i ] = _segments[ i ]._read_length;
+    }
+    if( _reservoir.size() < _reservoir_size ) {
+        _reservoir.emplace_back( fragment );
+    } else {
+        _reservoir[ _reservoir_next ] = fragment;
+        _reservoir_next = ( _reservoir_next + 1 ) % _reservoir_size;
+    }
+}
+
+/**
+ * Sets the pending read up to sequence a fragment of the reservoir again
+ * @param fragment Fragment
+ */
+void genomeMaker::SequencerSim::reuseFragment( const Fragment &fragment ) {
+    _duplicate_of     = fragment._read;
+    _pending_segments = fragment._segments;
+    _pending_fragment = fragment._fragment;
+    _pending_reverse  = fragment._reverse[ 0 ];
+    for( size_t i = 0; i < _pending_segments; i++ ) {
+        Segment &segment     = _segments[ i ];
+        segment._start       = fragment._starts[ i ];
+        segment._reverse     = fragment._reverse[ i ];
+        segment._read_length = fragment._lengths[ i ];
+        segment._mate        = i == 0 ? 0 : 3;
+        _total_reverse_reads += segment._reverse && ( i == 0 || !_fragment_model ) ? 1 : 0;
+    }
+    _total_chimeras += !_fragment_model && _pending_segments > 1 ? 1 : 0;
+    _total_duplicates++;
+}
+
+/**
+ * Gets the lowest genome position still needed between a read start and the fragments kept for duplicates
+ * Note: reads are drawn in the order of their start so the oldest fragment kept starts the lowest
+ * @param start Read start
+ * @return Genome position
+ */
+uint64_t genomeMaker::SequencerSim::oldestFragment( const uint64_t &start ) const {
+    if( _reservoir.empty() ) {
+        return start;
+    }
+    return std::min( start, _reservoir[ _reservoir.size() < _reservoir_size ? 0 : _reservoir_next ]._starts[ 0 ] );
+}
+
+/**
+ * Renders the pending read from the genome window into its record(s)
+ */
+void genomeMaker::SequencerSim::renderRead() {
+    if( _fragment_model ) {
+        Segment &mate1 = _segments[ 0 ];
+        Segment &mate2 = _segments[ 1 ];
+        //Getting the whole fragment from the window in one go
+        const uint64_t first = mate1._start;
+        _fragment.assign( _genome.at( first ), _pending_fragment );
+        if( _pending_reverse ) { //fragment from the reverse strand swaps the mates' orientation on the genome
+            sequence::reverseComplement( _fragment, _rna );
+        }
+        const size_t template_length = placeMates( _fragment.size() );
+        _fragment_model->createMates( _fragment, template_length, _letters, mate1._template, mate2._template );
+        for( Segment *mate : { &mate1, &mate2 } ) {
+            mate->_source      = mate->_template.data();
+            mate->_source_size = mate->_template.size();
+        }
+        //Rendering the read records
+        renderRecord( _output, "/1", 0, 1 );
+        renderRecord( _mate_writer ? _mate_output : _output, "/2", 1, 1 );
+    } else {
+        for( size_t i = 0; i < _pending_segments; i++ ) {
+            Segment &segment = _segments[ i ];
+            //Reverse ones are complemented from the window when rendered (see source(..))
+            segment._source      = segment._reverse ? nullptr : _genome.at( segment._start );
+            segment._source_size = segment._fragment_bases;
+            segment._anchor = segment._start + ( segment._reverse ? segment._fragment_bases - 1 : 0 );
+        }
+        //Rendering the read record
+        renderRecord( _output, "", 0, _pending_segments );
+    }
+}
+
+/**
+ * Gets the template of a segment in read orientation
+ * Note: the template of a reverse segment is only complemented into its buffer when something needs it
+ *       (errors to apply or merge, clean reads). Error-free ones are complemented straight into the record.
+ * @param segment Segment
+ * @return Template
+ */
+const char *genomeMaker::SequencerSim::source( Segment &segment ) {
+    if( !segment._source ) {
+        segment._template.resize( segment._fragment_bases );
+        sequence::reverseComplement( _genome.at( segment._start ), segment._fragment_bases, &segment._template[ 0 ], _rna );
+        segment._source = segment._template.data();
+    }
+    return segment._source;
+}
+
+/**
+ * Places the mates of the pending pair on the genome
+ * Note: anchors are on the (possibly reverse complemented) fragment
+ * @param fragment_length Length of the fragment
+ * @return Length of template needed by the mates
+ */
+size_t genomeMaker::SequencerSim::placeMates( const size_t &fragment_length ) {
+    Segment &mate1 = _segments[ 0 ];
+    Segment &mate2 = _segments[ 1 ];
+    const size_t template_length = std::max( _error_model->templateLength( _read_length, mate1._errors ),
+                                             _error_model->templateLength( _read_length, mate2._errors ) );
+    FragmentModel::MateAnchor anchor1, anchor2;
+    _fragment_model->mateAnchors( fragment_length, template_length, anchor1, anchor2 );
+    const uint64_t first = mate1._start;
+    const uint64_t last  = first + fragment_length - 1;
+    mate1._anchor         = _pending_reverse ? last - anchor1._offset : first + anchor1._offset;
+    mate1._reverse        = anchor1._reverse != _pending_reverse;
+    mate1._fragment_bases = anchor1._length;
+    mate1._read_length    = _read_length;
+    mate1._mate           = 1;
+    mate2._anchor         = _pending_reverse ? last - anchor2._offset : first + anchor2._offset;
+    mate2._reverse        = anchor2._reverse != _pending_reverse;
+    mate2._fragment_bases = anchor2._length;
+    mate2._read_length    = _read_length;
+    mate2._mate           = 2;
+    return template_length;
+}
+
+/**
+ * Marks a read as erroneous (error rate of the simulator) by adding a substitution to one of its segments
+ * @param length   Length of the read
+ * @param segments Number of segments making up the read
+ */
+void genomeMaker::SequencerSim::addReadError( const size_t &length, const size_t &segments ) {
+    if( !_read_errors.next() ) {
+        return;
+    }
+    size_t error_index = length > 1 ? _read_rng() % length : 0;
+    LOG_TRACE( "[genomeMaker::SequencerSim::addReadError(..)] Read #", _read_number, " marked for being erroneous." );
+    size_t i { 0 };
+    while( i + 1 < segments && error_index >= _segments[ i ]._read_length ) {
+        error_index -= _segments[ i++ ]._read_length;
+    }
+    _error_model->addSubstitution( static_cast<uint32_t>( error_index ), _segments[ i ]._errors );
+    _total_read_errors++;
+}
+
+/**
+ * Renders segments into a FASTA/FASTQ record straight into an output buffer
+ * Note: FASTA lines are wrapped in place so no per-read copy is made whatever the read length
+ * @param output Output buffer
+ * @param suffix Read name suffix (e.g. "/1" for mate #1)
+ * @param first  Index of the first segment of the read
+ * @param count  Number of segments in the read
+ */
+void genomeMaker::SequencerSim::renderRecord( std::string &output, const char *suffix, const size_t &first, const size_t &count ) {
+    output.append( _quality_model ? "@read#" : ">read#" ).append( std::to_string( _read_number ) ).append( suffix ).append( "\n" );
+    const size_t sequence_begin = output.size();
+    for( size_t i = first; i < first + count; i++ ) {
+        Segment &segment = _segments[ i ];
+        segment._offset = output.size() - sequence_begin;
+        if( !segment._source && segment._errors.empty() ) { //error-free reverse segment: single pass from the window
+            const size_t end = output.size();
+            segment._length  = std::min( segment._read_length, segment._source_size );
+            output.resize( end + segment._length );
+            sequence::reverseComplement( _genome.at( segment._start + segment._source_size - segment._length ),
+                                         segment._length, &output[ end ], _rna );
+        } else {
+            segment._length = _error_model->apply( source( segment ), segment._source_size, segment._read_length,
+                                                   _letters, segment._errors, output );
+        }
+        _total_base_errors += segment._errors.size();
+        if( _error_hotspots ) { //substitutions on top of the sampled errors (truth updated as for quality errors)
+            char *sequence = &output[ sequence_begin + segment._offset ];
+            _hotspot_positions.clear();
+            _total_base_errors += _error_hotspots->inject( sequence, segment._length, _letters, *_error_model, _hotspot_positions );
+            if( _truth_writer || _truth_records ) {
+                for( const uint32_t &position : _hotspot_positions ) {
+                    _error_model->mergeSubstitution( position, sequence[ position ], source( segment ), segment._source_size, segment._errors );
                 }
             }
-            ss << "\n\n";
-            //Writing read to sequencer file
-            if( !_writer.write( ss.str() ) ) {
-                LOG_ERROR( "[genomeMaker::SequencerSim::sequenceGenomeChunk(..)] Error occurred whilst writing read ",
-                           reads_done, "/", read_count, " of genome chunk to file '", _writer.getFileName(), "'." );
-                std::cerr << "Error: could not write read #" << _total_reads_completed << " to sequencer file: " << std::endl;
-                std::cerr << ss.str();
-                std::cerr << "Aborting..." << std::endl;
-                return false;
+        }
+    }
+    const size_t length = output.size() - sequence_begin;
+    size_t qualities_begin { 0 };
+    if( _quality_model ) {
+        output.append( "\n+\n" );
+        qualities_begin = output.size();
+        output.resize( qualities_begin + length );
+        _quality_model->generate( &output[ qualities_begin ], length );
+        for( size_t i = first; i < first + count; i++ ) {
+            Segment &segment = _segments[ i ];
+            char *sequence   = &output[ sequence_begin + segment._offset ];
+            _quality_error_positions.clear();
+            _total_quality_errors += _quality_model->injectErrors( sequence, &output[ qualities_begin + segment._offset ], segment._length,
+                                                                   _letters, ( _truth_writer || _truth_records ) ? &_quality_error_positions : nullptr );
+            for( const uint32_t &position : _quality_error_positions ) {
+                _error_model->mergeSubstitution( position, sequence[ position ], source( segment ), segment._source_size, segment._errors );
             }
-            reads_done++;
         }
+        if( _rendered ) {
+            shareRecord( output, sequence_begin, qualities_begin, first, count );
+        }
+        output.push_back( '\n' );
+    } else {
+        if( _rendered ) { //before the lines are wrapped
+            shareRecord( output, sequence_begin, qualities_begin, first, count );
+        }
+        wrapLines( output, sequence_begin );
+        output.append( "\n\n" );
+    }
+    if( _truth_writer || _truth_records ) {
+        for( size_t i = first; i < first + count; i++ ) {
+            addTruth( _segments[ i ] );
+        }
+    }
+    if( _coverage_track ) {
+        for( size_t i = first; i < first + count; i++ ) {
+            uint64_t begin { 0 }, end { 0 };
+            alignedSpan( _segments[ i ], begin, end );
+            _coverage_track->add( begin, end );
+        }
+    }
+}
+
+/**
+ * Copies a record just rendered into the batch shared by the sinks
+ * Note: the error-free sequence of a segment is the template it was rendered from, over the bases
+ *       its errors consumed (the span of its truth record) so indels change its length
+ * @param output          Output buffer the record was rendered into
+ * @param sequence_begin  Position of the sequence in the buffer (lines not wrapped yet)
+ * @param qualities_begin Position of the qualities in the buffer (FASTQ)
+ * @param first           Index of the first segment of the record
+ * @param count           Number of segments in the record
+ */
+void genomeMaker::SequencerSim::shareRecord( const std::string &output,
+                                             const size_t &sequence_begin,
+                                             const size_t &qualities_begin,
+                                             const size_t &first,
+                                             const size_t &count ) {
+    RenderedReads &reads = *_rendered;
+    size_t length { 0 };
+    for( size_t i = first; i < first + count; i++ ) {
+        length += _segments[ i ]._length;
+    }
+    reads._numbers.emplace_back( _read_number );
+    reads._mates.emplace_back( _segments[ first ]._mate );
+    reads._sequences.append( output, sequence_begin, length );
+    reads._ends.emplace_back( reads._sequences.size() );
+    if( _quality_model ) {
+        reads._qualities.append( output, qualities_begin, length );
+    }
+    if( _clean_reads ) {
+        for( size_t i = first; i < first + count; i++ ) {
+            Segment &segment      = _segments[ i ];
+            const size_t consumed = ErrorModel::templateLength( segment._length, segment._errors );
+            reads._clean.append( source( segment ), std::min( consumed, segment._source_size ) );
+        }
+        reads._clean_ends.emplace_back( reads._clean.size() );
+    }
+}
+
+/**
+ * Hands the records rendered since the last call over to the sinks
+ * @return Success
+ */
+bool genomeMaker::SequencerSim::flushSinks() {
+    if( _rendered->_numbers.empty() ) {
         return true;
-    } catch ( std::out_of_range e ) {
-        return false;
     }
+    for( ReadSink *sink : _sinks ) {
+        if( !sink->add( _rendered ) ) {
+            return false;
+        }
+    }
+    _rendered = std::make_shared<RenderedReads>();
+    return true;
+}
+
+/**
+ * Wraps the sequence at the end of an output buffer into FASTA lines in place
+ * @param output Output buffer
+ * @param begin  Position of the sequence in the buffer
+ */
+void genomeMaker::SequencerSim::wrapLines( std::string &output, const size_t &begin ) const {
+    const size_t length = output.size() - begin;
+    if( length <= _LINE_SIZE ) {
+        return;
+    }
+    const size_t breaks = ( length - 1 ) / _LINE_SIZE;
+    output.resize( output.size() + breaks );
+    char  *sequence = &output[ begin ];
+    size_t line     = length - breaks * _LINE_SIZE;
+    size_t from     = length - line;
+    size_t to       = from + breaks;
+    std::memmove( sequence + to, sequence + from, line );
+    while( from > 0 ) {
+        sequence[ --to ] = '\n';
+        from -= _LINE_SIZE;
+        to   -= _LINE_SIZE;
+        std::memmove( sequence + to, sequence + from, _LINE_SIZE );
+    }
+}
+
+/**
+ * Adds the truth record of a rendered segment
+ * @param segment Segment of a read
+ */
+void genomeMaker::SequencerSim::addTruth( const Segment &segment ) {
+    const size_t consumed = ErrorModel::templateLength( segment._length, segment._errors );
+    const size_t bases    = std::min( consumed, segment._fragment_bases );
+    _truth._position      = leftmost( segment );
+    _truth._reverse       = segment._reverse;
+    _truth._mate          = segment._mate;
+    _truth._length        = static_cast<uint32_t>( segment._length );
+    _truth._adapter_bases = static_cast<uint32_t>( consumed - bases );
+    _truth._errors        = segment._errors;
+    _truth._read          = _read_number;
+    _truth._duplicate     = _duplicate_of;
+    if( _truth_records ) {
+        _truth_records->push_back( _truth );
+    } else if( _truth_writer ) {
+        _truth_writer->add( _truth );
+    }
+}
+
+/**
+ * Gets the leftmost genome position of a rendered segment (its truth position)
+ * @param segment Segment of a read
+ * @return Genome position
+ */
+uint64_t genomeMaker::SequencerSim::leftmost( const Segment &segment ) const {
+    return segment._reverse ? segment._anchor + 1 - genomeBases( segment ) : segment._anchor;
+}
+
+/**
+ * Gets the number of genome bases a rendered segment covers (adapter bases left out)
+ * @param segment Segment of a read
+ * @return Number of bases
+ */
+size_t genomeMaker::SequencerSim::genomeBases( const Segment &segment ) const {
+    return std::min( ErrorModel::templateLength( segment._length, segment._errors ), segment._fragment_bases );
+}
+
+/**
+ * Gets the genome positions a rendered segment aligns to
+ * Note: deletions at either end of the segment are left out as in its alignment (SAM export)
+ * @param segment Segment of a read
+ * @param begin   Output for the first genome position
+ * @param end     Output for the genome position after the last one
+ */
+void genomeMaker::SequencerSim::alignedSpan( const Segment &segment, uint64_t &begin, uint64_t &end ) const {
+    const size_t bases = genomeBases( segment );
+    size_t t { 0 }, r { 0 }, front { 0 }, back { 0 }; //template/read positions, aligned template range
+    bool leading { true };
+    for( const ErrorModel::Error &error : segment._errors ) {
+        const size_t matches = std::max( std::min<size_t>( error._position, segment._length ), r ) - r;
+        if( matches > 0 ) {
+            back    = t < bases ? std::min( t + matches, bases ) : back;
+            leading = false;
+            r      += matches;
+            t      += matches;
+        }
+        switch( error._type ) {
+            case ErrorModel::Type::DELETION:
+                front = leading ? t + 1 : front;
+                t++;
+                break;
+            case ErrorModel::Type::SUBSTITUTION:
+                back    = t < bases ? t + 1 : back;
+                leading = false;
+                r++;
+                t++;
+                break;
+            case ErrorModel::Type::INSERTION:
+                back    = t < bases ? t : back;
+                leading = false;
+                r++;
+                break;
+        }
+    }
+    if( segment._length > r ) {
+        back = t < bases ? std::min( t + segment._length - r, bases ) : back;
+    }
+    front = std::min( front, back );
+    const uint64_t first = leftmost( segment );
+    begin = segment._reverse ? first + bases - back : first + front;
+    end   = segment._reverse ? first + bases - front : first + back;
 }
 
 /**
- * Gets a single character from a read starting in the current buffer
- * @param buffer  Buffer object
- * @param start_i Start index of the read
- * @param read_i  Index within the read
- * @return Character at position
+ * Gets the range read starts can be placed in on a streamed genome
+ * Note: a start is only placed once the genome is known to go on for a read span after it
+ *       (the last read span - 1 characters are carried over in the window)
+ * @return Size of the range
  */
-char genomeMaker::SequencerSim::getCharAt( const Buffers &buffer, const size_t &start_i, const size_t &read_i ) const {
-    if( start_i + read_i < buffer._current_size ) {
-        return buffer._current->at( start_i + read_i );
-    } else { //read overlaps with the 'next' buffer
-        return buffer._next->at( start_i + read_i - buffer._current_size );
+uint64_t genomeMaker::SequencerSim::streamedRange() const {
+    const uint64_t end = _genome.isComplete() ? _genome.genomeSize() : _genome.end();
+    return end >= _span ? end - _span + 1 : 0;
+}
+
+/**
+ * Flushes the output buffers to the sequencer file(s)
+ * Note: both mate files are flushed together so they stay in lockstep
+ * @return Success
+ */
+bool genomeMaker::SequencerSim::flushOutput() {
+    if( !_output.empty() ) {
+        if( !_writer.write( _output ) ) {
+            return false;
+        }
+        _output.clear();
     }
-}
\ No newline at end of file
+    if( _mate_writer && !_mate_output.empty() ) {
+        if( !_mate_writer->write( _mate_output ) ) {
+            return false;
+        }
+        _mate_output.clear();
+    }
+    return !_truth_writer || _truth_writer->flush();
+}
+
+/**
+ * Draws the strand of the next segment of the read
+ * Note: the coin flips come from one 64bit random draw per read
+ * @return Reverse strand flag
+ */
+bool genomeMaker::SequencerSim::nextStrand() {
+    if( !_both_strands ) {
+        return false;
+    }
+    const bool reverse = ( _strand_bits & 1 ) != 0;
+    _strand_bits >>= 1;
+    if( reverse ) {
+        _total_reverse_reads++;
+    }
+    return reverse;
+}
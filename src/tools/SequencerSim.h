@@ -4,62 +4,263 @@
 #include <iostream>
 #include <cmath>
 #include <ctgmath>
+#include <random>
+#include <cstring>
+#include <queue>
+#include <memory>
 
 #include "eadlib/logger/Logger.h"
-#include "eadlib/io/FileReader.h"
 #include "eadlib/io/FileWriter.h"
-#include "eadlib/cli/graphic/ProgressBar.h"
 
-#include "Randomiser.h"
-#include "../containers/Buffers.h"
+#include "CounterRng.h"
+#include "BernoulliStream.h"
+#include "StartStream.h"
+#include "CoverageTarget.h"
+#include "CoverageTrack.h"
+#include "ErrorModel.h"
+#include "ErrorHotspots.h"
+#include "QualityModel.h"
+#include "FragmentModel.h"
+#include "LengthModel.h"
+#include "ReverseComplement.h"
+#include "TruthWriter.h"
+#include "ReadSorter.h"
+#include "ReadSink.h"
+#include "GenomeWindow.h"
 
 namespace genomeMaker {
     class SequencerSim {
       public:
-        SequencerSim( eadlib::io::FileReader &reader,
-                      eadlib::io::FileWriter &writer,
-                      genomeMaker::Randomiser &read_randomiser,
-                      genomeMaker::Randomiser &error_randomiser );
+        enum class Step {
+            DONE,   //all reads done
+            MORE,   //a read needs more of the genome than the window holds
+            FAILED
+        };
+        enum class SortKey {
+            RANDOM,  //shuffled
+            POSITION //leftmost genome position of the first record of the read
+        };
+        SequencerSim( genomeMaker::GenomeWindow &genome,
+                      eadlib::io::FileWriter &writer );
         ~SequencerSim();
+        void setErrorModel( genomeMaker::ErrorModel &error_model );
+        void setErrorHotspots( genomeMaker::ErrorHotspots &error_hotspots );
+        void setQualityModel( genomeMaker::QualityModel &quality_model );
+        void setFragmentModel( genomeMaker::FragmentModel &fragment_model );
+        void setMateWriter( eadlib::io::FileWriter &mate_writer );
+        void setStrandSampling( const bool &both_strands );
+        void setTruthWriter( genomeMaker::TruthWriter &truth_writer );
+        void setLengthModel( genomeMaker::LengthModel &length_model );
+        void setChimeraRate( const double &chimera_rate );
+        void setTargetRegions( genomeMaker::TargetRegions &target_regions, const double &off_target_rate );
+        void setCoverageBias( genomeMaker::CoverageBias &coverage_bias );
+        void setSeed( const uint64_t &seed );
+        void setCoverageTarget( genomeMaker::CoverageTarget &coverage_target, const unsigned &min_coverage, const double &fraction );
+        void setCoverageTrack( genomeMaker::CoverageTrack &coverage_track );
+        void setReadSorter( genomeMaker::ReadSorter &sorter, const SortKey &sort_key );
+        void setDepthIndex( genomeMaker::DepthIndex &depth_index );
+        void setTopUp( const uint64_t &reads_done, const size_t &part, const uint64_t &truth_position );
+        void setTiling( const uint64_t &stride );
+        void setDuplicates( const double &duplicate_rate, const double &mutation_rate, const size_t &reservoir_size );
+        void addSink( genomeMaker::ReadSink &sink );
+        bool prepare( const size_t &read_length,
+                      const size_t &read_depth,
+                      const double &error_rate );
         bool start( const size_t &read_length,
                     const size_t &read_depth,
                     const double &error_rate );
+        Step sequenceWindow();
+        bool sequenceRead( const uint64_t &number, std::string &record, std::vector<TruthRecord> &truth );
+        uint64_t readCount() const;
+        uint64_t readsCompleted() const;
+        uint64_t pendingStart() const;
+        bool finish();
 
       private:
+        //Read segment (mate or chimeric part) rendered into a record
+        struct Segment {
+            uint64_t    _start          { 0 };     //genome position where the template is taken from
+            uint64_t    _anchor         { 0 };     //genome position of the first template base
+            bool        _reverse        { false }; //template runs towards the start of the genome
+            uint8_t     _mate           { 0 };     //truth mate code (0: single, 1/2: mates, 3: continuation)
+            size_t      _fragment_bases { 0 };     //genome bases available in the template (the rest is adapter)
+            size_t      _read_length    { 0 };     //target length of the segment
+            size_t      _offset         { 0 };     //offset of the rendered segment in the record's sequence
+            size_t      _length         { 0 };     //rendered length
+            std::string _template;
+            const char *_source         { nullptr }; //template rendered from (genome window when taken as is, null until a reverse one is needed)
+            size_t      _source_size    { 0 };
+            std::vector<ErrorModel::Error> _errors;
+        };
+        //Placement of a fragment kept to be sequenced again (duplicates)
+        struct Fragment {
+            uint64_t _read;        //number of the read the fragment was first sequenced in
+            size_t   _segments;
+            uint64_t _starts[ 2 ];
+            bool     _reverse[ 2 ];
+            size_t   _lengths[ 2 ]; //segment read lengths (single reads)
+            size_t   _fragment;     //fragment length (pairs)
+        };
+        //Reads drawn ahead of rendering, one column per field (reads in the order of their start)
+        struct ReadBatch {
+            //Columns of the reads
+            std::vector<uint64_t> _seeds;            //seed of the read's start stream
+            std::vector<uint64_t> _indices;          //index of the read in its start stream
+            std::vector<uint64_t> _starts;
+            std::vector<uint64_t> _next_starts;      //start of the next read of the stream (chimeras)
+            std::vector<uint64_t> _remaining;        //starts left in the stream after the read's
+            std::vector<uint64_t> _numbers;          //read number
+            std::vector<uint64_t> _read_keys;        //key of the read's random stream
+            std::vector<uint64_t> _keys;             //keys drawn from the read's stream, one column per key (see reseedRead(..))
+            std::vector<uint64_t> _error_draws;      //draws of the error model's stream used by the sampling
+            std::vector<uint64_t> _floors;           //lowest genome position the read and the ones after it need
+            std::vector<uint64_t> _ends;             //genome position after the last character the read needs
+            std::vector<uint64_t> _duplicates;       //read duplicated (0: none)
+            std::vector<size_t>   _fragments;        //fragment length (pairs)
+            std::vector<uint8_t>  _fragment_reverse; //strand of the fragment (pairs)
+            std::vector<size_t>   _first_segments;
+            std::vector<uint8_t>  _segment_counts;
+            //Columns of the segments
+            std::vector<uint64_t> _segment_starts;
+            std::vector<uint8_t>  _reverse;
+            std::vector<uint8_t>  _mates;
+            std::vector<size_t>   _read_lengths;
+            std::vector<size_t>   _fragment_bases;
+            std::vector<size_t>   _first_errors;
+            std::vector<uint32_t> _error_counts;
+            std::vector<ErrorModel::Error> _errors;  //errors of all the segments
+        };
         //Private methods
         uint64_t calcReadCount( const std::streampos &genome_size,
                                 const size_t &read_length,
                                 const size_t &read_depth ) const;
-        uint64_t calcErrorUpperBound( const uint64_t &reads_total,
-                                      const double &error_rate ) const;
-        std::stack<uint64_t> createErrorStack( const uint64_t &reads_total,
-                                               const uint64_t &errors );
-        uint64_t calcChunkReads( const uint64_t &genome_size,
-                                 const uint64_t &reads_total,
-                                 const uint64_t &genome_chunks,
-                                 const size_t &chunk_size ) const;
-        size_t calcMaxIndex( const std::streamsize &current_buffer_size,
-                             const std::streamsize &next_buffer_size,
-                             const size_t &read_length ) const;
-        bool sequenceGenome( const size_t &read_length,
-                             const size_t &read_depth,
-                             const uint64_t &reads_total,
-                             const uint64_t &erroneous_reads );
-        bool sequenceGenomeChunk( const size_t &read_length,
-                                  const uint64_t &read_count,
-                                  std::stack<uint64_t> &erroneous_read_indices,
-                                  Buffers &buffer );
-        char getCharAt( const Buffers &buffer,
-                        const size_t &start_i,
-                        const size_t &read_i ) const;
+        size_t keyDraws() const;
+        void reseedRead( const size_t &read );
+        bool prepareLayers( const uint64_t &reads_total, const uint64_t &range, const size_t &read_depth );
+        uint64_t layerSeed( const size_t &layer ) const;
+        uint64_t partSeed() const;
+        bool nextLayer();
+        size_t drawBatch( const size_t &max_reads );
+        size_t drawTiles( const size_t &max_reads );
+        void storeRead();
+        void loadRead( const size_t &read );
+        void loadTile( const size_t &read );
+        void drawFragment( const size_t &read );
+        void drawErrors();
+        void keepFragment();
+        void reuseFragment( const Fragment &fragment );
+        uint64_t oldestFragment( const uint64_t &start ) const;
+        size_t placeMates( const size_t &fragment_length );
+        void renderRead();
+        const char *source( Segment &segment );
+        bool nextStrand();
+        void addReadError( const size_t &length, const size_t &segments );
+        void renderRecord( std::string &output,
+                           const char *suffix,
+                           const size_t &first,
+                           const size_t &count );
+        void wrapLines( std::string &output, const size_t &begin ) const;
+        void shareRecord( const std::string &output,
+                          const size_t &sequence_begin,
+                          const size_t &qualities_begin,
+                          const size_t &first,
+                          const size_t &count );
+        bool flushSinks();
+        void addTruth( const Segment &segment );
+        uint64_t leftmost( const Segment &segment ) const;
+        size_t genomeBases( const Segment &segment ) const;
+        void alignedSpan( const Segment &segment, uint64_t &begin, uint64_t &end ) const;
+        uint64_t streamedRange() const;
+        bool flushOutput();
         //Private variables
         static const size_t _LINE_SIZE = 71; //per line max char write in sequencer file output
-        eadlib::io::FileReader &_reader;
+        static const size_t _OUTPUT_BUFFER_SIZE = 1 << 22; //output buffered before each file write
+        static const size_t _MAX_READ_LENGTH = 1000000; //longest read supported (long read mode)
+        static const uint64_t _READ_STREAM = 3; //random stream of the reads (see CounterRng::key(..))
+        static const uint64_t _SHUFFLE_STREAM = 4; //random stream of the read order keys
+        static const uint64_t _LAYER_STREAM = 6; //seeds of the read layers (coverage target)
+        static const uint64_t _PART_STREAM = 7;  //seeds of the top-up runs
+        static const size_t _LAYERS_PER_X = 4; //read layers per unit of depth (coverage target)
+        static const size_t _BATCH_READS = 1024;    //most reads drawn ahead of rendering
+        static const size_t _BATCH_BASES = 1 << 22; //read bases drawn ahead of rendering (long reads)
+        GenomeWindow &_genome;
         eadlib::io::FileWriter &_writer;
-        Randomiser &_read_randomiser;
-        Randomiser &_error_randomiser;
+        uint64_t _seed;
+        CounterRng _read_rng; //everything drawn for a read is keyed on the seed and the read's index
+        BernoulliStream _read_errors;
+        ErrorModel _default_error_model;
+        ErrorModel *_error_model;
+        ErrorHotspots *_error_hotspots;
+        QualityModel *_quality_model;
+        FragmentModel *_fragment_model;
+        LengthModel *_length_model;
+        BernoulliStream _chimeras;
+        BernoulliStream _duplicates;
+        BernoulliStream _mutations;          //substitutions added to the duplicates
+        size_t _reservoir_size;              //fragments kept for duplicates (0: off)
+        std::vector<Fragment> _reservoir;    //ring of the latest fragments (oldest at _reservoir_next once full)
+        size_t _reservoir_next;
+        uint64_t _duplicate_of;              //read the pending read duplicates (0: none)
+        TargetRegions *_target_regions;
+        double _off_target_rate;
+        CoverageBias *_coverage_bias;
+        std::vector<Segment> _segments;
+        ReadBatch _batch;
+        size_t _batch_next;          //next read of the batch to render
+        size_t _batch_size;          //reads drawn per batch
+        uint64_t _read_number;       //number of the read being drawn or rendered
+        eadlib::io::FileWriter *_mate_writer;
+        TruthWriter *_truth_writer;
+        std::vector<TruthRecord> *_truth_records; //truth of a read generated on its own or held by the sorter
+        ReadSorter *_sorter;
+        SortKey _sort_key;
+        CoverageTrack *_coverage_track;
+        DepthIndex *_depth_index;
+        std::vector<ReadSink *> _sinks;
+        std::shared_ptr<RenderedReads> _rendered; //records rendered for the sinks since the last hand-over
+        bool _clean_reads;                        //a sink takes the error-free reads
+        uint64_t _reads_done;     //reads already on disk (top-up run)
+        size_t _part;             //top-up run number (0: first run)
+        uint64_t _tile_stride;    //read starts at a fixed stride instead of drawn (0: off)
+        bool _clean_tiles;        //error-free tiling: tiles only drawn for their strand (see drawTiles(..))
+        uint64_t _truth_position; //position of the last truth record on disk (top-up run)
+        std::vector<TruthRecord> _read_truth;
+        TruthRecord _truth;
+        std::vector<uint32_t> _quality_error_positions;
+        std::vector<uint32_t> _hotspot_positions;
+        StartStream _starts;
+        StartStream *_current;       //read starts the next read is drawn from (_starts or a layer)
+        uint64_t _read_seed;         //seed of the reads of the current start stream
+        CoverageTarget *_coverage_target;
+        unsigned        _min_coverage;     //coverage each position of the target fraction needs
+        double          _covered_fraction; //fraction of the genome that needs the minimum coverage
+        std::vector<StartStream> _layers; //independent read sets merged by position (coverage target)
+        std::priority_queue<std::pair<uint64_t, size_t>,
+                            std::vector<std::pair<uint64_t, size_t>>,
+                            std::greater<std::pair<uint64_t, size_t>>> _layer_heads; //next start, layer
+        size_t _read_length;
+        size_t _span;                //longest stretch of genome a read (or pair) can start before the end
+        uint64_t _reads_total;       //0 when the genome is streamed (not known up front)
+        bool _pending;               //read drawn but waiting on the genome window
+        uint64_t _pending_end;       //genome position after the last character the pending read needs
+        uint64_t _pending_floor;     //lowest genome position the pending read and the ones after it need
+        size_t _pending_segments;
+        size_t _pending_fragment;    //fragment length of the pending pair
+        bool _pending_reverse;       //strand of the pending pair
+        std::string _fragment;
+        bool _both_strands;
+        uint64_t _strand_bits;      //random bits for the strand coin flips of the read's segments
+        std::string _letters;
+        bool _rna;                   //letter set has 'U' instead of 'T'
+        std::string _output;
+        std::string _mate_output;
         uint64_t _total_reads_completed;
         uint64_t _total_read_errors;
+        uint64_t _total_base_errors;
+        uint64_t _total_quality_errors;
+        uint64_t _total_reverse_reads;
+        uint64_t _total_chimeras;
+        uint64_t _total_duplicates;
     };
 }
 
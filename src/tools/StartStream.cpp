@@ -0,0 +1,355 @@
+#include "StartStream.h"
+
+const uint64_t genomeMaker::StartStream::_SPLIT_STREAM;
+const uint64_t genomeMaker::StartStream::_LEAF_STREAM;
+const uint64_t genomeMaker::StartStream::_WINDOW_SIZE;
+const uint64_t genomeMaker::StartStream::_COUNT_STREAM;
+
+/**
+ * Constructor
+ * Note: positions are sorted uniforms laid out as an implicit binary tree over their indices.
+ *       The middle index of a node is drawn from the Beta distribution of its order statistic
+ *       within the node's bounds and splits it in two; small nodes (leaves) are drawn in one go
+ *       as ascending uniform order statistics. Every draw is keyed on the seed and an index so
+ *       any position can be got in O(log(count)) and going through them in order costs O(1)
+ *       each (amortised) whatever the I/O windows or the order they are asked in.
+ * @param count Number of positions in the stream
+ * @param range Size of the range positions are drawn from [0, range)
+ * @param seed  Seed of the stream
+ */
+genomeMaker::StartStream::StartStream( const uint64_t &count, const uint64_t &range, const uint64_t &seed ) :
+    _count( range > 0 ? count : 0 ),
+    _range( range ),
+    _seed( seed ),
+    _index( 0 ),
+    _leaf_begin( 0 ),
+    _regions( nullptr ),
+    _bias( nullptr ),
+    _streamed( false ),
+    _rate( 0 ),
+    _final( true ),
+    _windows( 0 ),
+    _drawn_begin( 0 ),
+    _stride( 0 )
+{
+    pushNode( 0, _count, 0, 1 );
+}
+
+/**
+ * Constructor (streamed range)
+ * Note: for ranges only known as they go along (e.g. a genome coming from a pipe). The range
+ *       is cut into fixed windows each getting a Poisson number of positions (keyed on the seed
+ *       and the window) laid out as ascending uniforms. A window is drawn once the range is
+ *       known to cover it (or is known to end inside it) so positions come out the same
+ *       whatever the steps the range was extended by. The total count is not known until the
+ *       range is final and positions cannot be sought.
+ * @param rate Expected number of positions per unit of range
+ * @param seed Seed of the stream
+ */
+genomeMaker::StartStream::StartStream( const double &rate, const uint64_t &seed ) :
+    _count( 0 ),
+    _range( 0 ),
+    _seed( seed ),
+    _index( 0 ),
+    _leaf_begin( 0 ),
+    _regions( nullptr ),
+    _bias( nullptr ),
+    _streamed( true ),
+    _rate( std::max( rate, 0. ) ),
+    _final( false ),
+    _windows( 0 ),
+    _drawn_begin( 0 ),
+    _stride( 0 )
+{}
+
+/**
+ * Creates a stream of positions laid out at a fixed stride (tiling)
+ * Note: positions are 0, stride, 2 * stride... and a last one at the end of the range when the
+ *       stride does not land on it so spans starting from them cover the genome exactly. Nothing
+ *       is drawn so the stream is the same whatever the seed.
+ * @param stride Distance between two positions
+ * @param range  Size of the range positions are laid out on [0, range)
+ * @return Start stream
+ */
+genomeMaker::StartStream genomeMaker::StartStream::tiling( const uint64_t &stride, const uint64_t &range ) {
+    StartStream stream( static_cast<uint64_t>( 0 ), range );
+    if( stride > 0 && range > 0 ) {
+        stream._stride = stride;
+        stream._count  = ( range - 1 + stride - 1 ) / stride + 1;
+    }
+    return stream;
+}
+
+/**
+ * Destructor
+ */
+genomeMaker::StartStream::~StartStream() {}
+
+/**
+ * Sets the target regions positions are drawn from
+ * Note: the mapping is monotone so positions stay in ascending order
+ * @param regions Target regions (built over the range of the stream)
+ */
+void genomeMaker::StartStream::setTargetRegions( genomeMaker::TargetRegions &regions ) {
+    _regions = &regions;
+}
+
+/**
+ * Sets the coverage bias positions are drawn with
+ * Note: the mapping is monotone so positions stay in ascending order
+ * @param bias Coverage bias (built over the range of the stream)
+ */
+void genomeMaker::StartStream::setCoverageBias( genomeMaker::CoverageBias &bias ) {
+    _bias = &bias;
+}
+
+/**
+ * Gets the next position of the stream
+ * @param position Position output (ascending)
+ * @return Success (false when the stream is exhausted)
+ */
+bool genomeMaker::StartStream::next( uint64_t &position ) {
+    if( _streamed ) {
+        while( buffered() < 1 ) {
+            if( !drawWindow() ) {
+                return false;
+            }
+        }
+        position = _drawn[ _index++ - _drawn_begin ];
+        return true;
+    }
+    if( _index >= _count ) {
+        return false;
+    }
+    position = _stride > 0 ? tile( _index++ ) : map( uniform( _index++ ) );
+    return true;
+}
+
+/**
+ * Gets the position at an index of the stream without moving the stream along
+ * @param index    Index of the position (0 to count - 1)
+ * @param position Position output
+ * @return Success (false when the index is past the end of the stream)
+ */
+bool genomeMaker::StartStream::at( const uint64_t &index, uint64_t &position ) {
+    if( _streamed ) { //only the positions drawn and not yet dropped
+        if( index < _drawn_begin || index - _drawn_begin >= _drawn.size() ) {
+            return false;
+        }
+        position = _drawn[ index - _drawn_begin ];
+        return true;
+    }
+    if( index >= _count ) {
+        return false;
+    }
+    position = _stride > 0 ? tile( index ) : map( uniform( index ) );
+    return true;
+}
+
+/**
+ * Moves the stream to an index so that next() carries on from there
+ * @param index Index of the next position
+ */
+void genomeMaker::StartStream::seek( const uint64_t &index ) {
+    _index = std::min( index, _count );
+}
+
+/**
+ * Extends the known range of a streamed stream
+ * @param range Size of the range known so far (never less than before)
+ * @param final Flag for the range being the whole of it
+ */
+void genomeMaker::StartStream::extend( const uint64_t &range, const bool &final ) {
+    _range = std::max( _range, range );
+    _final = final;
+}
+
+/**
+ * Checks that the next two positions (or the end of the stream) are known
+ * Note: always true when the range is not streamed
+ * @return Ready state (false when the range needs extending first)
+ */
+bool genomeMaker::StartStream::ready() {
+    if( !_streamed ) {
+        return true;
+    }
+    while( buffered() < 2 && drawWindow() ) {}
+    return buffered() >= 2 || ( _final && _windows * _WINDOW_SIZE >= _range );
+}
+
+/**
+ * Gets the lowest position the next one of a streamed stream can be at
+ * @return Position (0 when the range is not streamed)
+ */
+uint64_t genomeMaker::StartStream::lowerBound() const {
+    if( !_streamed ) {
+        return 0;
+    }
+    return buffered() > 0 ? _drawn[ _index - _drawn_begin ] : _windows * _WINDOW_SIZE;
+}
+
+/**
+ * Gets the index of the next position of the stream
+ * @return Index
+ */
+uint64_t genomeMaker::StartStream::index() const {
+    return _index;
+}
+
+/**
+ * Gets the number of positions left in the stream
+ * @return Number of positions
+ */
+uint64_t genomeMaker::StartStream::remaining() const {
+    if( _streamed ) { //only what is drawn so far
+        return buffered();
+    }
+    return _count - _index;
+}
+
+/**
+ * Gets the size of the range positions are drawn from
+ * @return Range size
+ */
+uint64_t genomeMaker::StartStream::range() const {
+    return _range;
+}
+
+/**
+ * Gets the uniform at an index of the stream
+ * Note: the path from the root is kept so only the nodes not shared with the last index
+ *       accessed get drawn.
+ * @param index Index (0 to count - 1)
+ * @return Uniform (0-1)
+ */
+double genomeMaker::StartStream::uniform( const uint64_t &index ) {
+    if( index >= _leaf_begin && index - _leaf_begin < _leaf.size() ) {
+        return _leaf[ index - _leaf_begin ];
+    }
+    while( _path.size() > 1 && ( index < _path.back()._begin || index >= _path.back()._end ) ) {
+        _path.pop_back();
+    }
+    while( true ) {
+        const Node node = _path.back();
+        if( node._end - node._begin <= _LEAF_SIZE ) {
+            fillLeaf( node );
+            return _leaf[ index - _leaf_begin ];
+        }
+        const uint64_t middle = node._begin + ( node._end - node._begin ) / 2;
+        if( index == middle ) {
+            return node._split;
+        }
+        if( index < middle ) {
+            pushNode( node._begin, middle, node._low, node._split );
+        } else {
+            pushNode( middle + 1, node._end, node._split, node._high );
+        }
+    }
+}
+
+/**
+ * Adds a node to the path and draws its split
+ * The k-th smallest of n uniforms is Beta(k, n + 1 - k) distributed (drawn as a ratio of Gammas).
+ * @param begin First index of the node
+ * @param end   Index after the last one of the node
+ * @param low   Lower bound of the node's uniforms
+ * @param high  Upper bound of the node's uniforms
+ */
+void genomeMaker::StartStream::pushNode( const uint64_t &begin, const uint64_t &end, const double &low, const double &high ) {
+    Node node { begin, end, low, high, low };
+    if( end - begin > _LEAF_SIZE ) {
+        const uint64_t middle = begin + ( end - begin ) / 2;
+        CounterRng rng( CounterRng::key( _seed, middle, _SPLIT_STREAM ) );
+        std::gamma_distribution<double> before( static_cast<double>( middle - begin + 1 ) );
+        std::gamma_distribution<double> after( static_cast<double>( end - middle ) );
+        const double x = before( rng );
+        const double y = after( rng );
+        node._split = low + ( high - low ) * ( x / ( x + y ) );
+    }
+    _path.push_back( node );
+}
+
+/**
+ * Draws the uniforms of a leaf
+ * The minimum of the k uniforms left in what remains of the node is 1 - V^(1/k) of it.
+ * @param node Leaf node
+ */
+void genomeMaker::StartStream::fillLeaf( const Node &node ) {
+    const size_t size = static_cast<size_t>( node._end - node._begin );
+    CounterRng rng( CounterRng::key( _seed, node._begin, _LEAF_STREAM ) );
+    _leaf.resize( size );
+    _leaf_begin = node._begin;
+    double log_rest { 0 }; //log of the part of the node left after the last uniform
+    for( size_t i = 0; i < size; i++ ) {
+        double v { 0 };
+        do {
+            v = static_cast<double>( rng() >> 11 ) / 9007199254740992.0;
+        } while( v <= 0 );
+        log_rest += std::log( v ) / static_cast<double>( size - i );
+        _leaf[ i ] = node._low + ( node._high - node._low ) * -std::expm1( log_rest );
+    }
+}
+
+/**
+ * Maps a uniform onto the range (through the target regions or coverage bias when set)
+ * @param u Uniform (0-1)
+ * @return Position
+ */
+uint64_t genomeMaker::StartStream::map( const double &u ) const {
+    if( _regions ) {
+        return _regions->map( u );
+    }
+    if( _bias ) {
+        return _bias->map( u );
+    }
+    const uint64_t position = static_cast<uint64_t>( u * static_cast<double>( _range ) );
+    return position >= _range ? _range - 1 : position;
+}
+
+/**
+ * Gets the position of a tile
+ * @param index Index of the tile (0 to count - 1)
+ * @return Position (the last tile is moved back to the end of the range)
+ */
+uint64_t genomeMaker::StartStream::tile( const uint64_t &index ) const {
+    return std::min( index * _stride, _range - 1 );
+}
+
+/**
+ * Draws the positions of the next Poisson window of a streamed range
+ * Note: positions already gone through are dropped first
+ * @return Success (false when the range does not cover the window yet or is done)
+ */
+bool genomeMaker::StartStream::drawWindow() {
+    const uint64_t begin = _windows * _WINDOW_SIZE;
+    if( begin >= _range || ( !_final && begin + _WINDOW_SIZE > _range ) ) {
+        return false;
+    }
+    const uint64_t size = std::min( _WINDOW_SIZE, _range - begin );
+    _drawn.erase( _drawn.begin(), _drawn.begin() + static_cast<std::ptrdiff_t>( _index - _drawn_begin ) );
+    _drawn_begin = _index;
+    CounterRng rng( CounterRng::key( _seed, _windows, _COUNT_STREAM ) );
+    std::poisson_distribution<uint64_t> count( _rate * static_cast<double>( size ) );
+    const uint64_t n = count( rng );
+    double log_rest { 0 }; //log of the part of the window left after the last position
+    for( uint64_t i = 0; i < n; i++ ) {
+        double v { 0 };
+        do {
+            v = static_cast<double>( rng() >> 11 ) / 9007199254740992.0;
+        } while( v <= 0 );
+        log_rest += std::log( v ) / static_cast<double>( n - i );
+        const uint64_t offset = static_cast<uint64_t>( -std::expm1( log_rest ) * static_cast<double>( size ) );
+        _drawn.emplace_back( begin + std::min( offset, size - 1 ) );
+    }
+    _count += n;
+    _windows++;
+    return true;
+}
+
+/**
+ * Gets the number of drawn positions not gone through yet
+ * @return Number of positions
+ */
+uint64_t genomeMaker::StartStream::buffered() const {
+    return _drawn.size() - ( _index - _drawn_begin );
+}
@@ -0,0 +1,72 @@
+#ifndef GENOMEMAKER_STARTSTREAM_H
+#define GENOMEMAKER_STARTSTREAM_H
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "CounterRng.h"
+#include "TargetRegions.h"
+#include "CoverageBias.h"
+
+namespace genomeMaker {
+    class StartStream {
+      public:
+        StartStream( const uint64_t &count, const uint64_t &range, const uint64_t &seed = 0 );
+        StartStream( const double &rate, const uint64_t &seed );
+        static StartStream tiling( const uint64_t &stride, const uint64_t &range );
+        ~StartStream();
+        void setTargetRegions( genomeMaker::TargetRegions &regions );
+        void setCoverageBias( genomeMaker::CoverageBias &bias );
+        bool next( uint64_t &position );
+        bool at( const uint64_t &index, uint64_t &position );
+        void seek( const uint64_t &index );
+        void extend( const uint64_t &range, const bool &final );
+        bool ready();
+        uint64_t lowerBound() const;
+        uint64_t index() const;
+        uint64_t remaining() const;
+        uint64_t range() const;
+
+      private:
+        //Part of the stream: the uniforms of indices [begin, end) lie sorted within (low, high)
+        struct Node {
+            uint64_t _begin;
+            uint64_t _end;
+            double   _low;
+            double   _high;
+            double   _split; //uniform of the middle index (nodes larger than a leaf)
+        };
+        double uniform( const uint64_t &index );
+        void pushNode( const uint64_t &begin, const uint64_t &end, const double &low, const double &high );
+        void fillLeaf( const Node &node );
+        uint64_t map( const double &u ) const;
+        uint64_t tile( const uint64_t &index ) const;
+        bool drawWindow();
+        uint64_t buffered() const;
+        //Private variables
+        static const uint64_t _LEAF_SIZE    = 1024; //indices generated in one go at the bottom of the tree
+        static const uint64_t _WINDOW_SIZE  = 1 << 16; //positions per Poisson window (streamed range)
+        static const uint64_t _SPLIT_STREAM = 1;
+        static const uint64_t _LEAF_STREAM  = 2;
+        static const uint64_t _COUNT_STREAM = 5;
+        uint64_t              _count;
+        uint64_t              _range;
+        uint64_t              _seed;
+        uint64_t              _index;      //index of the next position
+        std::vector<Node>     _path;       //nodes from the root down to the last index accessed
+        std::vector<double>   _leaf;       //uniforms of the last leaf
+        uint64_t              _leaf_begin;
+        TargetRegions        *_regions;    //maps the positions onto target regions when set
+        CoverageBias         *_bias;       //maps the positions by window weights when set
+        bool                  _streamed;   //range only known up to what has been given with extend(..)
+        double                _rate;       //expected positions per unit of range (streamed)
+        bool                  _final;      //range given is the whole of it (streamed)
+        uint64_t              _windows;    //Poisson windows drawn so far (streamed)
+        std::vector<uint64_t> _drawn;      //positions drawn and not yet dropped (streamed)
+        uint64_t              _drawn_begin; //index of the first drawn position held
+        uint64_t              _stride;     //positions laid out every stride instead of drawn when set
+    };
+}
+
+#endif //GENOMEMAKER_STARTSTREAM_H
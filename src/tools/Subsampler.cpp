@@ -0,0 +1,219 @@
+#include "Subsampler.h"
+
+/**
+ * Constructor
+ * @param fraction Fraction of the reads to keep (0 to 1)
+ * @param seed     Seed of the selection
+ * @param threads  Number of threads parsing the files
+ */
+genomeMaker::Subsampler::Subsampler( const double &fraction, const uint64_t &seed, const size_t &threads ) :
+    _fraction( fraction ),
+    _seed( seed ),
+    _threads( std::max( threads, (size_t) 1 ) ),
+    _seen( 0 ),
+    _kept( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::Subsampler::~Subsampler() {}
+
+/**
+ * Counts the records and bases of a reads file
+ * @param reads   Mapped reads file (FASTA or FASTQ)
+ * @param records Number of records found
+ * @param bases   Number of bases found
+ * @return Success
+ */
+bool genomeMaker::Subsampler::countBases( const MappedFile &reads, uint64_t &records, uint64_t &bases ) {
+    return runBatches( reads, nullptr, records, bases );
+}
+
+/**
+ * Writes the selected records of a reads file
+ * Note: records are copied as they are (wrapping, qualities) in their original order
+ * @param reads  Mapped reads file (FASTA or FASTQ)
+ * @param writer Writer of the subsampled file
+ * @return Success
+ */
+bool genomeMaker::Subsampler::subsample( const MappedFile &reads, eadlib::io::FileWriter &writer ) {
+    uint64_t records { 0 }, bases { 0 };
+    return runBatches( reads, &writer, records, bases );
+}
+
+/**
+ * Checks if a read is selected
+ * Note: the decision is a Bernoulli trial on a hash of the read name (up to the first space and
+ *       without any /1 or /2 mate suffix) so it does not depend on the order or the split of
+ *       the records between threads, and mates are kept or dropped together.
+ * @param name   Read name
+ * @param length Length of the name
+ * @return Selected state
+ */
+bool genomeMaker::Subsampler::isSelected( const char *name, const size_t &length ) const {
+    size_t end { 0 };
+    while( end < length && name[ end ] != ' ' && name[ end ] != '\t' ) {
+        end++;
+    }
+    if( end > 2 && name[ end - 2 ] == '/' && ( name[ end - 1 ] == '1' || name[ end - 1 ] == '2' ) ) {
+        end -= 2;
+    }
+    uint64_t hash { 14695981039346656037ULL ^ _seed }; //FNV-1a
+    for( size_t i = 0; i < end; i++ ) {
+        hash = ( hash ^ static_cast<unsigned char>( name[ i ] ) ) * 1099511628211ULL;
+    }
+    hash += 0x9E3779B97F4A7C15ULL; //splitmix64 finaliser
+    hash  = ( hash ^ ( hash >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    hash  = ( hash ^ ( hash >> 27 ) ) * 0x94D049BB133111EBULL;
+    hash ^= hash >> 31;
+    return static_cast<double>( hash >> 11 ) / 9007199254740992.0 < _fraction; //top 53 bits as a uniform on [0,1)
+}
+
+/**
+ * Gets the number of records looked at by subsample(..)
+ * @return Number of records
+ */
+uint64_t genomeMaker::Subsampler::seen() const {
+    return _seen;
+}
+
+/**
+ * Gets the number of records kept by subsample(..)
+ * @return Number of records
+ */
+uint64_t genomeMaker::Subsampler::kept() const {
+    return _kept;
+}
+
+/**
+ * Runs through a reads file in batches of one chunk per thread
+ * Note: chunk boundaries are moved to the next record start so each thread parses whole
+ *       records. Memory used stays at a chunk's output per thread whatever the file size.
+ * @param reads   Mapped reads file
+ * @param writer  Writer for the selected records (nullptr to only count)
+ * @param records Number of records found
+ * @param bases   Number of bases found
+ * @return Success
+ */
+bool genomeMaker::Subsampler::runBatches( const MappedFile &reads, eadlib::io::FileWriter *writer, uint64_t &records, uint64_t &bases ) {
+    records = 0;
+    bases   = 0;
+    if( reads.size() == 0 ) {
+        return true;
+    }
+    const RecordParser probe( reads.data(), reads.size() );
+    if( !probe.isValid() ) {
+        LOG_ERROR( "[genomeMaker::Subsampler::runBatches( ", reads.getFileName(), ", .. )] Not a FASTA or FASTQ file." );
+        return false;
+    }
+    const RecordParser::Format format = probe.format();
+    const char *cursor = reads.data();
+    const char *end    = reads.data() + reads.size();
+    _chunks.resize( _threads );
+    while( cursor < end ) {
+        //Splitting the next batch between the threads
+        size_t count { 0 };
+        for( ; count < _threads && cursor < end; count++ ) {
+            Chunk &chunk = _chunks[ count ];
+            chunk._begin = cursor;
+            chunk._end   = findRecordStart( cursor + std::min( static_cast<uint64_t>( _CHUNK_SIZE ), static_cast<uint64_t>( end - cursor ) ), end, format );
+            cursor       = chunk._end;
+        }
+        if( count == 1 ) {
+            processChunk( _chunks[ 0 ], writer != nullptr );
+        } else {
+            std::vector<std::thread> workers;
+            for( size_t i = 0; i < count; i++ ) {
+                workers.emplace_back( [ this, i, writer ]() { processChunk( _chunks[ i ], writer != nullptr ); } );
+            }
+            for( std::thread &worker : workers ) {
+                worker.join();
+            }
+        }
+        //Collecting in file order
+        for( size_t i = 0; i < count; i++ ) {
+            Chunk &chunk = _chunks[ i ];
+            if( !chunk._valid ) {
+                LOG_ERROR( "[genomeMaker::Subsampler::runBatches( ", reads.getFileName(), ", .. )] "
+                    "Malformed record around byte ", chunk._begin - reads.data(), "." );
+                return false;
+            }
+            records += chunk._records;
+            bases   += chunk._bases;
+            if( writer ) {
+                _seen += chunk._records;
+                _kept += chunk._kept;
+                if( !chunk._output.empty() && !writer->write( chunk._output ) ) {
+                    LOG_ERROR( "[genomeMaker::Subsampler::runBatches( ", reads.getFileName(), ", .. )] "
+                        "Could not write to '", writer->getFileName(), "'." );
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Parses the records of a chunk
+ * @param chunk  Chunk
+ * @param select Flag to copy the selected records to the chunk's output
+ */
+void genomeMaker::Subsampler::processChunk( Chunk &chunk, const bool &select ) const {
+    chunk._records = 0;
+    chunk._kept    = 0;
+    chunk._bases   = 0;
+    chunk._output.clear();
+    RecordParser parser( chunk._begin, static_cast<uint64_t>( chunk._end - chunk._begin ) );
+    parser.setSequenceCopy( false );
+    RecordParser::Record record;
+    while( parser.next( record ) ) {
+        chunk._records++;
+        chunk._bases += record._length;
+        if( select && isSelected( record._name, record._name_length ) ) {
+            chunk._kept++;
+            chunk._output.append( record._begin, record._end );
+            if( chunk._output.back() != '\n' ) { //last record of a file without a final new line
+                chunk._output.push_back( '\n' );
+            }
+        }
+    }
+    chunk._valid = parser.isValid();
+}
+
+/**
+ * Finds the first record starting at or after a position
+ * Note: a FASTQ header is a line starting with '@' that has a '+' line two lines down as a
+ *       quality line can start with '@' too.
+ * @param from   Position to look from
+ * @param end    End of the data
+ * @param format Format of the records
+ * @return Start of the record (or the end of the data)
+ */
+const char * genomeMaker::Subsampler::findRecordStart( const char *from, const char *end, const RecordParser::Format &format ) const {
+    const char marker = format == RecordParser::Format::FASTA ? '>' : '@';
+    const char *line  = from;
+    if( line < end && *( line - 1 ) != '\n' ) { //moving to the start of the next line
+        line = static_cast<const char *>( memchr( line, '\n', static_cast<size_t>( end - line ) ) );
+        line = line ? line + 1 : end;
+    }
+    while( line < end ) {
+        if( *line == marker ) {
+            if( format == RecordParser::Format::FASTA ) {
+                return line;
+            }
+            const char *next = line;
+            for( int i = 0; i < 2 && next; i++ ) {
+                next = static_cast<const char *>( memchr( next, '\n', static_cast<size_t>( end - next ) ) );
+                next = next ? next + 1 : nullptr;
+            }
+            if( next && next < end && *next == '+' ) {
+                return line;
+            }
+        }
+        line = static_cast<const char *>( memchr( line, '\n', static_cast<size_t>( end - line ) ) );
+        line = line ? line + 1 : end;
+    }
+    return end;
+}
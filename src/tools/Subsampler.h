@@ -0,0 +1,52 @@
+#ifndef GENOMEMAKER_SUBSAMPLER_H
+#define GENOMEMAKER_SUBSAMPLER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileWriter.h"
+
+#include "MappedFile.h"
+#include "RecordParser.h"
+
+namespace genomeMaker {
+    class Subsampler {
+      public:
+        Subsampler( const double &fraction, const uint64_t &seed, const size_t &threads );
+        ~Subsampler();
+        bool countBases( const MappedFile &reads, uint64_t &records, uint64_t &bases );
+        bool subsample( const MappedFile &reads, eadlib::io::FileWriter &writer );
+        bool isSelected( const char *name, const size_t &length ) const;
+        uint64_t seen() const;
+        uint64_t kept() const;
+
+      private:
+        //Work of a thread on its chunk of the file
+        struct Chunk {
+            const char *_begin;
+            const char *_end;
+            uint64_t    _records;
+            uint64_t    _kept;
+            uint64_t    _bases;
+            bool        _valid;
+            std::string _output;
+        };
+        bool runBatches( const MappedFile &reads, eadlib::io::FileWriter *writer, uint64_t &records, uint64_t &bases );
+        void processChunk( Chunk &chunk, const bool &select ) const;
+        const char * findRecordStart( const char *from, const char *end, const RecordParser::Format &format ) const;
+        //Private variables
+        static const size_t _CHUNK_SIZE = 1 << 23; //bytes of the file given to a thread at a time
+        double   _fraction;
+        uint64_t _seed;
+        size_t   _threads;
+        uint64_t _seen;
+        uint64_t _kept;
+        std::vector<Chunk> _chunks;
+    };
+}
+
+#endif //GENOMEMAKER_SUBSAMPLER_H
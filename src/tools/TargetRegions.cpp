@@ -0,0 +1,193 @@
+#include "TargetRegions.h"
+
+/**
+ * Constructor
+ */
+genomeMaker::TargetRegions::TargetRegions() :
+    _range( 0 ),
+    _target_bases( 0 ),
+    _on_density( 0 ),
+    _off_density( 0 ),
+    _cursor( 0 ),
+    _last( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::TargetRegions::~TargetRegions() {}
+
+/**
+ * Loads the target regions from a BED file
+ * Note: only the start and end columns are used (0-based, end exclusive) as the genome is a
+ *       single sequence. 'track', 'browser' and comment ('#') lines are skipped.
+ * @param file_name BED file name
+ * @return Success
+ */
+bool genomeMaker::TargetRegions::load( const std::string &file_name ) {
+    eadlib::io::FileReader reader( file_name );
+    if( !reader.open() ) {
+        LOG_ERROR( "[genomeMaker::TargetRegions::load( ", file_name, " )] Could not open the BED file." );
+        return false;
+    }
+    _intervals.clear();
+    std::vector<char> line;
+    size_t line_number { 0 };
+    while( !reader.isDone() && reader.readLine( line ) >= 0 ) {
+        line_number++;
+        line.emplace_back( '\0' );
+        const char *it = line.data();
+        while( *it == ' ' || *it == '\t' ) {
+            it++;
+        }
+        if( *it == '\0' || *it == '#' || std::strncmp( it, "track", 5 ) == 0 || std::strncmp( it, "browser", 7 ) == 0 ) {
+            continue;
+        }
+        while( *it != '\0' && !std::isspace( static_cast<unsigned char>( *it ) ) ) { //chromosome name
+            it++;
+        }
+        char *end_begin { nullptr }, *end_end { nullptr };
+        const uint64_t begin = std::strtoull( it, &end_begin, 10 );
+        const uint64_t end   = std::strtoull( end_begin, &end_end, 10 );
+        if( end_begin == it || end_end == end_begin || end < begin ) {
+            LOG_ERROR( "[genomeMaker::TargetRegions::load( ", file_name, " )] Invalid region on line ", line_number, "." );
+            return false;
+        }
+        if( end > begin ) {
+            _intervals.emplace_back( Interval { begin, end, 0 } );
+        }
+    }
+    if( _intervals.empty() ) {
+        LOG_ERROR( "[genomeMaker::TargetRegions::load( ", file_name, " )] No target regions found." );
+        return false;
+    }
+    LOG( "[genomeMaker::TargetRegions::load( ", file_name, " )] Loaded ", _intervals.size(), " regions." );
+    return true;
+}
+
+/**
+ * Builds the sampling index of the regions over the range read starts are drawn from
+ * Note: regions are sorted, clipped to the range and merged when they overlap. Each target base
+ *       then gets an equal share of (1 - off_target_rate) of the reads and each base outside
+ *       the targets an equal share of the rest.
+ * @param range           Size of the range read starts are drawn from [0, range)
+ * @param off_target_rate Fraction of the reads starting outside the targets
+ * @return Success
+ */
+bool genomeMaker::TargetRegions::build( const uint64_t &range, const double &off_target_rate ) {
+    std::sort( _intervals.begin(), _intervals.end(), []( const Interval &a, const Interval &b ) {
+        return a._begin < b._begin;
+    } );
+    size_t merged { 0 };
+    for( const Interval &interval : _intervals ) {
+        if( interval._begin >= range ) {
+            break;
+        }
+        const uint64_t end = std::min( interval._end, range );
+        if( merged > 0 && interval._begin <= _intervals[ merged - 1 ]._end ) {
+            _intervals[ merged - 1 ]._end = std::max( _intervals[ merged - 1 ]._end, end );
+        } else {
+            _intervals[ merged++ ] = Interval { interval._begin, end, 0 };
+        }
+    }
+    _intervals.resize( merged );
+    _intervals.shrink_to_fit();
+    _target_bases = 0;
+    for( Interval &interval : _intervals ) {
+        interval._before = _target_bases;
+        _target_bases   += interval._end - interval._begin;
+    }
+    if( _target_bases == 0 ) {
+        LOG_ERROR( "[genomeMaker::TargetRegions::build( ", range, ", ", off_target_rate, " )] No target region inside the genome." );
+        return false;
+    }
+    const uint64_t off_target_bases = range - _target_bases;
+    const double   rate             = off_target_bases > 0 ? off_target_rate : 0;
+    _range       = range;
+    _on_density  = ( 1 - rate ) / static_cast<double>( _target_bases );
+    _off_density = off_target_bases > 0 ? rate / static_cast<double>( off_target_bases ) : 0;
+    _cursor      = 0;
+    _last        = 0;
+    LOG( "[genomeMaker::TargetRegions::build( ", range, ", ", off_target_rate, " )] ",
+         _intervals.size(), " merged regions over ", _target_bases, " bases." );
+    return true;
+}
+
+/**
+ * Maps a uniform on [0,1) to a read start
+ * Note: ascending uniforms (as drawn by StartStream) walk the intervals along so each position
+ *       costs O(1) on average. Going back falls back to a binary search.
+ * @param u Uniform
+ * @return Read start
+ */
+uint64_t genomeMaker::TargetRegions::map( const double &u ) {
+    if( u < _last ) {
+        auto it = std::upper_bound( _intervals.begin(), _intervals.end(), u, [&]( const double &value, const Interval &interval ) {
+            return value < massEnd( static_cast<size_t>( &interval - _intervals.data() ) );
+        } );
+        _cursor = static_cast<size_t>( it - _intervals.begin() );
+    }
+    _last = u;
+    while( _cursor < _intervals.size() && massEnd( _cursor ) <= u ) {
+        _cursor++;
+    }
+    if( _cursor < _intervals.size() && u >= massBegin( _cursor ) ) { //inside a target
+        const Interval &interval = _intervals[ _cursor ];
+        const uint64_t offset = static_cast<uint64_t>( ( u - massBegin( _cursor ) ) / _on_density );
+        return std::min( interval._begin + offset, interval._end - 1 );
+    }
+    //in the gap before the target (or after the last one)
+    const uint64_t gap_begin = _cursor > 0 ? _intervals[ _cursor - 1 ]._end : 0;
+    const uint64_t gap_end   = _cursor < _intervals.size() ? _intervals[ _cursor ]._begin : _range;
+    if( gap_begin >= gap_end || _off_density <= 0 ) {
+        return _cursor < _intervals.size() ? _intervals[ _cursor ]._begin : _intervals.back()._end - 1;
+    }
+    const double   mass   = _cursor > 0 ? massEnd( _cursor - 1 ) : 0;
+    const uint64_t offset = static_cast<uint64_t>( ( u - mass ) / _off_density );
+    return std::min( gap_begin + offset, gap_end - 1 );
+}
+
+/**
+ * Gets the number of bases covered by the targets
+ * @return Target bases
+ */
+uint64_t genomeMaker::TargetRegions::targetBases() const {
+    return _target_bases;
+}
+
+/**
+ * Gets the fraction of reads starting outside the targets
+ * @return Off-target rate (0 when the targets cover everything)
+ */
+double genomeMaker::TargetRegions::offTargetRate() const {
+    return 1 - _on_density * static_cast<double>( _target_bases );
+}
+
+/**
+ * Gets the number of (merged) target regions
+ * @return Number of regions
+ */
+size_t genomeMaker::TargetRegions::size() const {
+    return _intervals.size();
+}
+
+/**
+ * Gets the share of reads starting before a target
+ * @param index Interval index
+ * @return Cumulative share
+ */
+double genomeMaker::TargetRegions::massBegin( const size_t &index ) const {
+    const Interval &interval = _intervals[ index ];
+    return _on_density * static_cast<double>( interval._before )
+         + _off_density * static_cast<double>( interval._begin - interval._before );
+}
+
+/**
+ * Gets the share of reads starting before the end of a target
+ * @param index Interval index
+ * @return Cumulative share
+ */
+double genomeMaker::TargetRegions::massEnd( const size_t &index ) const {
+    const Interval &interval = _intervals[ index ];
+    return massBegin( index ) + _on_density * static_cast<double>( interval._end - interval._begin );
+}
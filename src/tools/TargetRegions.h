@@ -0,0 +1,46 @@
+#ifndef GENOMEMAKER_TARGETREGIONS_H
+#define GENOMEMAKER_TARGETREGIONS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileReader.h"
+
+namespace genomeMaker {
+    class TargetRegions {
+      public:
+        TargetRegions();
+        ~TargetRegions();
+        bool load( const std::string &file_name );
+        bool build( const uint64_t &range, const double &off_target_rate );
+        uint64_t map( const double &u );
+        uint64_t targetBases() const;
+        double offTargetRate() const;
+        size_t size() const;
+
+      private:
+        //Target interval [begin, end) with the number of target bases that come before it
+        struct Interval {
+            uint64_t _begin;
+            uint64_t _end;
+            uint64_t _before;
+        };
+        double massBegin( const size_t &index ) const;
+        double massEnd( const size_t &index ) const;
+        //Private variables
+        std::vector<Interval> _intervals;
+        uint64_t              _range;
+        uint64_t              _target_bases;
+        double                _on_density;  //share of the reads per target base
+        double                _off_density; //share of the reads per off-target base
+        size_t                _cursor;      //interval the last mapped position fell in (or the gap before it)
+        double                _last;        //last mapped uniform
+    };
+}
+
+#endif //GENOMEMAKER_TARGETREGIONS_H
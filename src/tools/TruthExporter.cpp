@@ -0,0 +1,354 @@
+#include "TruthExporter.h"
+
+/**
+ * Constructor
+ * @param truth  Truth reader (opened)
+ * @param writer EADlib File Writer for the export
+ * @param genome Mapped genome file used to fill in the read sequences (nullptr for none)
+ */
+genomeMaker::TruthExporter::TruthExporter( TruthReader &truth, eadlib::io::FileWriter &writer, const MappedFile *genome ) :
+    _truth( truth ),
+    _writer( writer ),
+    _genome( genome ),
+    _read_number( 0 ),
+    _records( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::TruthExporter::~TruthExporter() {}
+
+/**
+ * Exports the truth records
+ * @param format Export format
+ * @return Success
+ */
+bool genomeMaker::TruthExporter::exportTo( const Format &format ) {
+    if( !_writer.isOpen() && !_writer.open() ) {
+        LOG_ERROR( "[genomeMaker::TruthExporter::exportTo(..)] Could not open '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _read_number = 0;
+    _records     = 0;
+    switch( format ) {
+        case Format::TSV:
+            return exportTSV();
+        case Format::SAM:
+            return exportSAM();
+    }
+    return false;
+}
+
+/**
+ * Gets the number of records exported
+ * @return Number of records
+ */
+uint64_t genomeMaker::TruthExporter::records() const {
+    return _records;
+}
+
+/**
+ * Appends the errors of a read as <read position><S|I|D>[:<base>] separated by commas ('-' when none)
+ * @param errors Errors of the read (positions are 0-based)
+ * @param output Output string
+ */
+void genomeMaker::TruthExporter::appendErrors( const std::vector<ErrorModel::Error> &errors, std::string &output ) {
+    const char types[] = { 'S', 'I', 'D' };
+    if( errors.empty() ) {
+        output.push_back( '-' );
+    }
+    for( size_t i = 0; i < errors.size(); i++ ) {
+        const ErrorModel::Error &error = errors[ i ];
+        if( i > 0 ) {
+            output.push_back( ',' );
+        }
+        output.append( std::to_string( error._position ) ).push_back( types[ static_cast<size_t>( error._type ) ] );
+        if( error._type != ErrorModel::Type::DELETION ) {
+            output.push_back( ':' );
+            output.push_back( error._base );
+        }
+    }
+}
+
+/**
+ * Exports the records as tab separated values
+ * Errors are listed as <read position><S|I|D>[:<base>] separated by commas (positions are 0-based).
+ * Runs with duplicates get a last column with the read each duplicate copies ('-' for the others).
+ * @return Success
+ */
+bool genomeMaker::TruthExporter::exportTSV() {
+    const bool duplicates { _truth.hasDuplicates() };
+    _output.append( "#read\tcontig\tposition\tstrand\tmate\tlength\tadapter\terrors" ).append( duplicates ? "\tduplicate\n" : "\n" );
+    TruthRecord record;
+    while( _truth.next( record ) ) {
+        _output.append( readName( record ) ).append( "\t" ).append( _truth.genomeName() );
+        _output.append( "\t" ).append( std::to_string( record._position ) );
+        _output.append( record._reverse ? "\t-\t" : "\t+\t" ).append( std::to_string( record._mate ) );
+        _output.append( "\t" ).append( std::to_string( record._length ) );
+        _output.append( "\t" ).append( std::to_string( record._adapter_bases ) ).append( "\t" );
+        appendErrors( record._errors, _output );
+        if( duplicates ) {
+            _output.append( record._duplicate > 0 ? "\tread#" + std::to_string( record._duplicate ) : "\t-" );
+        }
+        _output.push_back( '\n' );
+        _records++;
+        if( !flush( false ) ) {
+            return false;
+        }
+    }
+    return flush( true );
+}
+
+/**
+ * Exports the records as SAM alignments against the genome
+ * Note: sequences are rendered from the genome when it is available ('*' otherwise) and read-through
+ *       adapter bases are soft clipped. Chimeric reads get a line per segment with the other segments
+ *       soft clipped (the lines after the first are flagged as supplementary).
+ * @return Success
+ */
+bool genomeMaker::TruthExporter::exportSAM() {
+    _output.append( "@HD\tVN:1.6\tSO:unsorted\n" );
+    const uint64_t genome_size = _truth.genomeSize() > 0 ? _truth.genomeSize() : ( _genome ? _genome->size() : 0 ); //0: streamed genome
+    if( genome_size > 0 ) {
+        _output.append( "@SQ\tSN:" ).append( _truth.genomeName() ).append( "\tLN:" ).append( std::to_string( genome_size ) ).append( "\n" );
+    }
+    _output.append( "@PG\tID:genomeMaker\tPN:genomeMaker\n" );
+    TruthRecord record, mate;
+    Alignment   alignment, mate_alignment;
+    bool pending = _truth.next( record );
+    while( pending ) {
+        if( record._mate == 1 ) {
+            if( !_truth.next( mate ) || mate._mate != 2 ) {
+                LOG_ERROR( "[genomeMaker::TruthExporter::exportSAM()] Mate #2 missing for read ", _read_number, "." );
+                return false;
+            }
+            align( record, alignment );
+            align( mate, mate_alignment );
+            renderSequence( &record, 1 );
+            appendSAM( record, alignment, &mate, &mate_alignment );
+            renderSequence( &mate, 1 );
+            appendSAM( mate, mate_alignment, &record, &alignment );
+            _records += 2;
+            pending = _truth.next( record );
+        } else {
+            _segments.clear();
+            _segments.emplace_back( record );
+            while( ( pending = _truth.next( record ) ) && record._mate == 3 ) {
+                _segments.emplace_back( record );
+            }
+            renderSequence( _segments.data(), _segments.size() );
+            size_t clip_before { 0 }, clip_after { 0 };
+            for( const TruthRecord &segment : _segments ) {
+                clip_after += segment._length;
+            }
+            for( size_t i = 0; i < _segments.size(); i++ ) {
+                clip_after -= _segments[ i ]._length;
+                align( _segments[ i ], alignment, clip_before, clip_after );
+                appendSAM( _segments[ i ], alignment, nullptr, nullptr, i > 0 );
+                clip_before += _segments[ i ]._length;
+            }
+            _records += _segments.size();
+        }
+        if( !flush( false ) ) {
+            return false;
+        }
+    }
+    return flush( true );
+}
+
+/**
+ * Works out the alignment of a read on the genome from its errors
+ * @param record      Truth record of the read
+ * @param alignment   Alignment output
+ * @param clip_before Read bases soft clipped before the record (other segments of a chimeric read)
+ * @param clip_after  Read bases soft clipped after the record
+ */
+void genomeMaker::TruthExporter::align( const TruthRecord &record, Alignment &alignment,
+                                        const size_t &clip_before, const size_t &clip_after ) const {
+    const size_t genome_bases = ErrorModel::templateLength( record._length, record._errors ) - record._adapter_bases;
+    std::vector<std::pair<char, size_t>> operations;
+    size_t t { 0 }, r { 0 };
+    auto push = [&]( const char &operation ) {
+        if( !operations.empty() && operations.back().first == operation ) {
+            operations.back().second++;
+        } else {
+            operations.emplace_back( operation, 1 );
+        }
+    };
+    alignment._edits = 0;
+    if( clip_before > 0 ) {
+        operations.emplace_back( 'S', clip_before );
+    }
+    for( const ErrorModel::Error &error : record._errors ) {
+        for( ; r < error._position && r < record._length; r++, t++ ) {
+            push( t < genome_bases ? 'M' : 'S' );
+        }
+        switch( error._type ) {
+            case ErrorModel::Type::SUBSTITUTION:
+                alignment._edits += t < genome_bases ? 1 : 0;
+                push( t < genome_bases ? 'M' : 'S' );
+                r++;
+                t++;
+                break;
+            case ErrorModel::Type::INSERTION:
+                alignment._edits += t < genome_bases ? 1 : 0;
+                push( t < genome_bases ? 'I' : 'S' );
+                r++;
+                break;
+            case ErrorModel::Type::DELETION:
+                if( t < genome_bases ) {
+                    alignment._edits++;
+                    push( 'D' );
+                }
+                t++;
+                break;
+        }
+    }
+    for( ; r < record._length; r++, t++ ) {
+        push( t < genome_bases ? 'M' : 'S' );
+    }
+    for( size_t i = 0; i < clip_after; i++ ) {
+        push( 'S' );
+    }
+    if( record._reverse ) {
+        std::reverse( operations.begin(), operations.end() );
+    }
+    //Deletions at either end of the aligned part only move it along the genome
+    alignment._position = record._position;
+    auto first = std::find_if( operations.begin(), operations.end(), []( const std::pair<char, size_t> &op ) { return op.first != 'S'; } );
+    while( first != operations.end() && first->first == 'D' ) {
+        alignment._position += first->second;
+        alignment._edits    -= first->second;
+        first = operations.erase( first );
+    }
+    auto last = std::find_if( operations.rbegin(), operations.rend(), []( const std::pair<char, size_t> &op ) { return op.first != 'S'; } );
+    while( last != operations.rend() && last->first == 'D' ) {
+        alignment._edits -= last->second;
+        operations.erase( std::next( last ).base() );
+        last = std::find_if( operations.rbegin(), operations.rend(), []( const std::pair<char, size_t> &op ) { return op.first != 'S'; } );
+    }
+    alignment._cigar.clear();
+    alignment._span = 0;
+    for( const auto &op : operations ) {
+        alignment._cigar.append( std::to_string( op.second ) ).push_back( op.first );
+        if( op.first == 'M' || op.first == 'D' ) {
+            alignment._span += op.second;
+        }
+    }
+}
+
+/**
+ * Renders the sequence of a read (as written in the sequencer file) from the genome
+ * @param records Truth records of the read's segments
+ * @param count   Number of records
+ * @return Success (false when the genome is not available)
+ */
+bool genomeMaker::TruthExporter::renderSequence( const TruthRecord *records, const size_t &count ) {
+    _sequence.clear();
+    if( !_genome ) {
+        return false;
+    }
+    for( size_t i = 0; i < count; i++ ) {
+        if( !_truth.render( _genome->data(), _genome->size(), records[ i ], _segment ) ) {
+            _sequence.clear();
+            return false;
+        }
+        _sequence.append( _segment );
+    }
+    return true;
+}
+
+/**
+ * Appends the SAM line of a read to the output
+ * Note: the read's sequence is expected to be rendered beforehand (see renderSequence(..))
+ * @param record         Truth record of the read
+ * @param alignment      Alignment of the read
+ * @param mate           Truth record of the read's mate (nullptr for single reads)
+ * @param mate_alignment Alignment of the read's mate (nullptr for single reads)
+ * @param supplementary  Supplementary alignment flag (segments of a chimeric read after the first)
+ */
+void genomeMaker::TruthExporter::appendSAM( const TruthRecord &record, const Alignment &alignment,
+                                            const TruthRecord *mate, const Alignment *mate_alignment,
+                                            const bool &supplementary ) {
+    const bool mapped      = alignment._span > 0;
+    const bool mate_mapped = mate && mate_alignment->_span > 0;
+    unsigned flag = ( record._reverse ? 0x10 : 0 ) | ( supplementary ? 0x800 : 0 ) | ( record._duplicate > 0 ? 0x400 : 0 );
+    if( !mapped ) {
+        flag |= 0x4;
+    }
+    if( mate ) {
+        flag |= 0x1 | ( record._mate == 1 ? 0x40 : 0x80 ) | ( mate->_reverse ? 0x20 : 0 );
+        flag |= ( mapped && mate_mapped ) ? 0x2 : 0;
+        flag |= mate_mapped ? 0 : 0x8;
+    }
+    std::string name = readName( record );
+    if( mate ) {
+        name.resize( name.size() - 2 ); //mates share the template name
+    }
+    _output.append( name ).append( "\t" ).append( std::to_string( flag ) ).append( "\t" );
+    if( mapped ) {
+        _output.append( _truth.genomeName() ).append( "\t" ).append( std::to_string( alignment._position + 1 ) );
+        _output.append( "\t60\t" ).append( alignment._cigar );
+    } else {
+        _output.append( "*\t0\t0\t*" );
+    }
+    if( mate_mapped ) {
+        int64_t tlen { 0 };
+        if( mapped ) {
+            const uint64_t begin = std::min( alignment._position, mate_alignment->_position );
+            const uint64_t end   = std::max( alignment._position + alignment._span, mate_alignment->_position + mate_alignment->_span );
+            const bool leftmost  = alignment._position < mate_alignment->_position
+                                   || ( alignment._position == mate_alignment->_position && record._mate == 1 );
+            tlen = static_cast<int64_t>( end - begin ) * ( leftmost ? 1 : -1 );
+        }
+        _output.append( mapped ? "\t=\t" : ( "\t" + _truth.genomeName() + "\t" ) ).append( std::to_string( mate_alignment->_position + 1 ) );
+        _output.append( "\t" ).append( std::to_string( tlen ) ).append( "\t" );
+    } else {
+        _output.append( "\t*\t0\t0\t" );
+    }
+    if( !_sequence.empty() ) {
+        _segment = _sequence;
+        if( record._reverse ) {
+            sequence::reverseComplement( _segment, _truth.letters().find( 'U' ) != std::string::npos );
+        }
+        _output.append( _segment );
+    } else {
+        _output.push_back( '*' );
+    }
+    _output.append( "\t*\tNM:i:" ).append( std::to_string( alignment._edits ) ).append( "\n" );
+}
+
+/**
+ * Gets the name of a read as written in the sequencer file
+ * Note: reads are numbered in the order of the records unless the truth file stores their numbers
+ * @param record Truth record of the read
+ * @return Read name
+ */
+std::string genomeMaker::TruthExporter::readName( const TruthRecord &record ) {
+    if( record._mate == 0 || record._mate == 1 ) {
+        _read_number = record._read > 0 ? record._read : _read_number + 1;
+    }
+    std::string name = "read#" + std::to_string( _read_number );
+    if( record._mate == 1 || record._mate == 2 ) {
+        name.append( record._mate == 1 ? "/1" : "/2" );
+    }
+    return name;
+}
+
+/**
+ * Writes the output buffer to file when full (or when forced)
+ * @param force Write whatever is buffered
+ * @return Success
+ */
+bool genomeMaker::TruthExporter::flush( const bool &force ) {
+    if( _output.empty() || ( !force && _output.size() < _OUTPUT_BUFFER_SIZE ) ) {
+        return true;
+    }
+    if( !_writer.write( _output ) ) {
+        LOG_ERROR( "[genomeMaker::TruthExporter::flush(..)] Could not write to '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _output.clear();
+    return true;
+}
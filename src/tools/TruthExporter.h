@@ -0,0 +1,59 @@
+#ifndef GENOMEMAKER_TRUTHEXPORTER_H
+#define GENOMEMAKER_TRUTHEXPORTER_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileWriter.h"
+
+#include "MappedFile.h"
+#include "TruthReader.h"
+#include "ReverseComplement.h"
+
+namespace genomeMaker {
+    class TruthExporter {
+      public:
+        enum class Format {
+            TSV,
+            SAM
+        };
+        TruthExporter( TruthReader &truth, eadlib::io::FileWriter &writer, const MappedFile *genome );
+        ~TruthExporter();
+        bool exportTo( const Format &format );
+        uint64_t records() const;
+        static void appendErrors( const std::vector<ErrorModel::Error> &errors, std::string &output );
+
+      private:
+        struct Alignment {
+            uint64_t    _position; //leftmost aligned genome position
+            uint64_t    _span;     //genome bases covered
+            std::string _cigar;
+            size_t      _edits;
+        };
+        bool exportTSV();
+        bool exportSAM();
+        void align( const TruthRecord &record, Alignment &alignment,
+                    const size_t &clip_before = 0, const size_t &clip_after = 0 ) const;
+        bool renderSequence( const TruthRecord *records, const size_t &count );
+        void appendSAM( const TruthRecord &record, const Alignment &alignment,
+                        const TruthRecord *mate, const Alignment *mate_alignment,
+                        const bool &supplementary = false );
+        std::string readName( const TruthRecord &record );
+        bool flush( const bool &force );
+        //Private variables
+        static const size_t _OUTPUT_BUFFER_SIZE = 1 << 22;
+        TruthReader             &_truth;
+        eadlib::io::FileWriter  &_writer;
+        const MappedFile        *_genome;
+        std::vector<TruthRecord> _segments; //records of a chimeric read
+        std::string              _output;
+        std::string              _sequence; //read sequence as written in the sequencer file
+        std::string              _segment;
+        uint64_t                 _read_number;
+        uint64_t                 _records;
+    };
+}
+
+#endif //GENOMEMAKER_TRUTHEXPORTER_H
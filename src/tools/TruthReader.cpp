@@ -0,0 +1,246 @@
+#include "TruthReader.h"
+
+/**
+ * Constructor
+ * @param file_name Truth file name
+ */
+genomeMaker::TruthReader::TruthReader( const std::string &file_name ) :
+    _file( file_name ),
+    _cursor( nullptr ),
+    _end( nullptr ),
+    _paired( false ),
+    _numbered( false ),
+    _duplicates( false ),
+    _duplicate( 0 ),
+    _read_length( 0 ),
+    _genome_size( 0 ),
+    _last_position( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::TruthReader::~TruthReader() {}
+
+/**
+ * Opens the truth file and reads its header
+ * @return Success
+ */
+bool genomeMaker::TruthReader::open() {
+    if( !_file.open() ) {
+        LOG_ERROR( "[genomeMaker::TruthReader::open()] Could not open the truth file '", _file.getFileName(), "'." );
+        return false;
+    }
+    _cursor = _file.data();
+    _end    = _file.data() + _file.size();
+    if( _file.size() < TruthWriter::_MAGIC.size()
+        || std::string( _cursor, TruthWriter::_MAGIC.size() ) != TruthWriter::_MAGIC ) {
+        LOG_ERROR( "[genomeMaker::TruthReader::open()] '", _file.getFileName(), "' is not a genomeMaker truth file." );
+        return false;
+    }
+    _cursor += TruthWriter::_MAGIC.size();
+    uint64_t flags { 0 }, read_length { 0 }, name_length { 0 };
+    if( !readVarInt( flags ) || !readVarInt( read_length ) || _end - _cursor < 4 ) {
+        LOG_ERROR( "[genomeMaker::TruthReader::open()] Truncated header in '", _file.getFileName(), "'." );
+        return false;
+    }
+    _paired      = ( flags & 1 ) != 0;
+    _numbered    = ( flags & 2 ) != 0;
+    _duplicates  = ( flags & 4 ) != 0;
+    _read_length = read_length;
+    _letters.assign( _cursor, 4 );
+    _cursor += 4;
+    if( !readVarInt( name_length ) || static_cast<uint64_t>( _end - _cursor ) < name_length ) {
+        LOG_ERROR( "[genomeMaker::TruthReader::open()] Truncated header in '", _file.getFileName(), "'." );
+        return false;
+    }
+    _genome_name.assign( _cursor, name_length );
+    _cursor += name_length;
+    if( !readVarInt( _genome_size ) ) {
+        LOG_ERROR( "[genomeMaker::TruthReader::open()] Truncated header in '", _file.getFileName(), "'." );
+        return false;
+    }
+    _last_position = 0;
+    _duplicate     = 0;
+    return true;
+}
+
+/**
+ * Reads the next record
+ * @param record Record to fill
+ * @return Success (false when there are no more records or the file is truncated)
+ */
+bool genomeMaker::TruthReader::next( TruthRecord &record ) {
+    if( _cursor >= _end ) {
+        return false;
+    }
+    uint64_t zigzag { 0 }, bits { 0 };
+    if( !readVarInt( zigzag ) || !readVarInt( bits ) ) {
+        LOG_ERROR( "[genomeMaker::TruthReader::next(..)] Truncated record in '", _file.getFileName(), "'." );
+        return false;
+    }
+    _last_position        += static_cast<uint64_t>( static_cast<int64_t>( zigzag >> 1 ) ^ -static_cast<int64_t>( zigzag & 1 ) );
+    record._position       = _last_position;
+    record._reverse        = ( bits & 1 ) != 0;
+    record._mate           = static_cast<uint8_t>( ( bits >> 1 ) & 3 );
+    record._length         = static_cast<uint32_t>( _read_length );
+    record._adapter_bases  = 0;
+    record._read           = 0;
+    record._errors.clear();
+    uint64_t value { 0 };
+    if( bits & 8 ) {
+        if( !readVarInt( value ) ) return false;
+        record._length = static_cast<uint32_t>( value );
+    }
+    if( bits & 16 ) {
+        if( !readVarInt( value ) ) return false;
+        record._adapter_bases = static_cast<uint32_t>( value );
+    }
+    if( _numbered && record._mate < 2 ) {
+        if( !readVarInt( record._read ) ) return false;
+    }
+    if( _duplicates && record._mate < 2 ) {
+        if( !readVarInt( _duplicate ) ) return false;
+    }
+    record._duplicate = _duplicate;
+    uint32_t position { 0 };
+    for( uint64_t i = 0; i < ( bits >> 5 ); i++ ) {
+        if( !readVarInt( value ) ) {
+            LOG_ERROR( "[genomeMaker::TruthReader::next(..)] Truncated error list in '", _file.getFileName(), "'." );
+            return false;
+        }
+        position += static_cast<uint32_t>( value >> 4 );
+        auto type = static_cast<ErrorModel::Type>( ( value >> 2 ) & 3 );
+        record._errors.push_back( { position, type, type == ErrorModel::Type::DELETION ? '-' : _letters[ value & 3 ] } );
+    }
+    return true;
+}
+
+/**
+ * Renders the sequence of a read from the genome and its truth record
+ * @param genome      Genome content
+ * @param genome_size Size of the genome
+ * @param record      Truth record of the read
+ * @param read        Read output (as written in the sequencer file)
+ * @return Success (false when the record falls outside the genome)
+ */
+bool genomeMaker::TruthReader::render( const char *genome, const uint64_t &genome_size, const TruthRecord &record, std::string &read ) const {
+    const bool rna    = _letters.find( 'U' ) != std::string::npos;
+    size_t     length = ErrorModel::templateLength( record._length, record._errors );
+    if( length < record._adapter_bases || record._position + ( length - record._adapter_bases ) > genome_size ) {
+        return false;
+    }
+    std::string read_template( genome + record._position, length - record._adapter_bases );
+    if( record._reverse ) {
+        sequence::reverseComplement( read_template, rna );
+    }
+    if( record._adapter_bases > 0 ) {
+        read_template.append( FragmentModel::adapter( record._mate, record._adapter_bases, rna ) );
+    }
+    read.clear();
+    size_t t { 0 };
+    for( const ErrorModel::Error &error : record._errors ) {
+        while( read.size() < error._position && t < read_template.size() ) {
+            read.push_back( read_template[ t++ ] );
+        }
+        switch( error._type ) {
+            case ErrorModel::Type::SUBSTITUTION:
+                read.push_back( error._base );
+                t++;
+                break;
+            case ErrorModel::Type::INSERTION:
+                read.push_back( error._base );
+                break;
+            case ErrorModel::Type::DELETION:
+                t++;
+                break;
+        }
+    }
+    while( read.size() < record._length && t < read_template.size() ) {
+        read.push_back( read_template[ t++ ] );
+    }
+    return true;
+}
+
+/**
+ * Checks if the reads are paired
+ * @return Paired state
+ */
+bool genomeMaker::TruthReader::isPaired() const {
+    return _paired;
+}
+
+/**
+ * Checks if the read numbers are stored (reads not in the order of their number)
+ * @return Numbered state
+ */
+bool genomeMaker::TruthReader::isNumbered() const {
+    return _numbered;
+}
+
+/**
+ * Checks if the truth file stores the read each duplicate copies
+ * @return Duplicates state
+ */
+bool genomeMaker::TruthReader::hasDuplicates() const {
+    return _duplicates;
+}
+
+/**
+ * Gets the read length used in the simulation
+ * @return Read length
+ */
+size_t genomeMaker::TruthReader::readLength() const {
+    return _read_length;
+}
+
+/**
+ * Gets the letter set of the genome
+ * @return Letter set
+ */
+std::string genomeMaker::TruthReader::letters() const {
+    return _letters;
+}
+
+/**
+ * Gets the name of the genome the reads came from
+ * @return Genome name
+ */
+std::string genomeMaker::TruthReader::genomeName() const {
+    return _genome_name;
+}
+
+/**
+ * Gets the size of the genome the reads came from
+ * @return Genome size (0 when the genome was streamed)
+ */
+uint64_t genomeMaker::TruthReader::genomeSize() const {
+    return _genome_size;
+}
+
+/**
+ * Gets the truth file name
+ * @return File name
+ */
+std::string genomeMaker::TruthReader::getFileName() const {
+    return _file.getFileName();
+}
+
+/**
+ * Reads a LEB128 variable length integer
+ * @param value Value output
+ * @return Success
+ */
+bool genomeMaker::TruthReader::readVarInt( uint64_t &value ) {
+    value = 0;
+    unsigned shift { 0 };
+    while( _cursor < _end && shift < 64 ) {
+        const uint8_t byte = static_cast<uint8_t>( *_cursor++ );
+        value |= static_cast<uint64_t>( byte & 0x7F ) << shift;
+        if( !( byte & 0x80 ) ) {
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
@@ -0,0 +1,49 @@
+#ifndef GENOMEMAKER_TRUTHREADER_H
+#define GENOMEMAKER_TRUTHREADER_H
+
+#include <string>
+
+#include "eadlib/logger/Logger.h"
+
+#include "MappedFile.h"
+#include "FragmentModel.h"
+#include "ReverseComplement.h"
+#include "TruthWriter.h"
+#include "../containers/TruthRecord.h"
+
+namespace genomeMaker {
+    class TruthReader {
+      public:
+        TruthReader( const std::string &file_name );
+        ~TruthReader();
+        bool open();
+        bool next( TruthRecord &record );
+        bool render( const char *genome, const uint64_t &genome_size, const TruthRecord &record, std::string &read ) const;
+        bool isPaired() const;
+        bool isNumbered() const;
+        bool hasDuplicates() const;
+        size_t readLength() const;
+        std::string letters() const;
+        std::string genomeName() const;
+        uint64_t genomeSize() const;
+        std::string getFileName() const;
+
+      private:
+        bool readVarInt( uint64_t &value );
+        //Private variables
+        MappedFile  _file;
+        const char *_cursor;
+        const char *_end;
+        bool        _paired;
+        bool        _numbered;
+        bool        _duplicates;
+        uint64_t    _duplicate; //read duplicated by the current read (carried over to its other segments)
+        size_t      _read_length;
+        std::string _letters;
+        std::string _genome_name;
+        uint64_t    _genome_size;
+        uint64_t    _last_position;
+    };
+}
+
+#endif //GENOMEMAKER_TRUTHREADER_H
@@ -0,0 +1,108 @@
+#include "TruthVerifier.h"
+
+/**
+ * Constructor
+ * @param genome Mapped genome file
+ * @param truth  Truth reader (opened)
+ */
+genomeMaker::TruthVerifier::TruthVerifier( const MappedFile &genome, TruthReader &truth ) :
+    _genome( genome ),
+    _truth( truth ),
+    _checked( 0 ),
+    _mismatches( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::TruthVerifier::~TruthVerifier() {}
+
+/**
+ * Checks every read of a sequencer file against its rendering from the genome and truth record
+ * Note: the segments of a chimeric read follow its first record and are rendered back to back.
+ *       Without a mate file the mates #2 must be interleaved in the sequencer file: a split
+ *       paired run checked without its mate file is stopped at its first pair.
+ * @param reads Parser on the sequencer file
+ * @param mates Parser on the mate #2 file (nullptr when mates are interleaved or reads are single)
+ * @return Success (false on any mismatch or when the files are out of step)
+ */
+bool genomeMaker::TruthVerifier::verify( RecordParser &reads, RecordParser *mates ) {
+    _checked    = 0;
+    _mismatches = 0;
+    TruthRecord record;
+    bool pending = _truth.next( record );
+    while( pending ) {
+        _records.clear();
+        _records.emplace_back( record );
+        while( ( pending = _truth.next( record ) ) && record._mate == 3 ) {
+            _records.emplace_back( record );
+        }
+        const bool    interleaved = _records.front()._mate == 2 && !mates;
+        RecordParser &parser      = ( _records.front()._mate == 2 && mates ) ? *mates : reads;
+        if( !check( parser, _records, interleaved ) ) {
+            return false;
+        }
+    }
+    if( reads.next( _read ) || ( mates && mates->next( _read ) ) ) {
+        LOG_ERROR( "[genomeMaker::TruthVerifier::verify(..)] There are more reads than truth records." );
+        std::cerr << "Error: the sequencer file has more reads than the truth file." << std::endl;
+        return false;
+    }
+    return _mismatches == 0;
+}
+
+/**
+ * Gets the number of reads checked
+ * @return Number of reads
+ */
+uint64_t genomeMaker::TruthVerifier::checked() const {
+    return _checked;
+}
+
+/**
+ * Gets the number of reads not matching their truth record
+ * @return Number of reads
+ */
+uint64_t genomeMaker::TruthVerifier::mismatches() const {
+    return _mismatches;
+}
+
+/**
+ * Checks the next read of a parser against its truth record(s)
+ * @param parser      Parser on the sequencer file
+ * @param records     Truth records of the read's segments
+ * @param interleaved Mate #2 expected in the sequencer file flag
+ * @return Success (false when the parser ran out of reads or the mate #2 is not there)
+ */
+bool genomeMaker::TruthVerifier::check( RecordParser &parser, const std::vector<TruthRecord> &records, const bool &interleaved ) {
+    if( !parser.next( _read ) ) {
+        LOG_ERROR( "[genomeMaker::TruthVerifier::check(..)] Ran out of reads after ", _checked, " reads." );
+        std::cerr << "Error: the sequencer file has fewer reads than the truth file (" << _checked << " checked)." << std::endl;
+        return false;
+    }
+    if( interleaved && ( _read._name_length < 2 || std::string( _read._name + _read._name_length - 2, 2 ) != "/2" ) ) {
+        LOG_ERROR( "[genomeMaker::TruthVerifier::check(..)] Read '", std::string( _read._name, _read._name_length ),
+                   "' is not a mate #2: the mates are not interleaved in the sequencer file." );
+        std::cerr << "Error: the truth has mates but the sequencer file has no mate #2 reads; pass the mate file with -m2." << std::endl;
+        return false;
+    }
+    _checked++;
+    const TruthRecord &record = records.front();
+    bool rendered { true };
+    _expected.clear();
+    for( const TruthRecord &segment : records ) {
+        rendered = rendered && _truth.render( _genome.data(), _genome.size(), segment, _segment );
+        _expected.append( _segment );
+    }
+    if( !rendered || _expected != _read._sequence ) {
+        if( _mismatches < _MAX_REPORTED ) {
+            std::string name( _read._name, _read._name_length );
+            LOG_ERROR( "[genomeMaker::TruthVerifier::check(..)] Read '", name, "' does not match its truth record (position ",
+                       record._position, ", ", ( record._reverse ? "-" : "+" ), ")." );
+            std::cout << "-> Mismatch on read '" << name << "' (position " << record._position << ", "
+                      << ( record._reverse ? "-" : "+" ) << ")" << std::endl;
+        }
+        _mismatches++;
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef GENOMEMAKER_TRUTHVERIFIER_H
+#define GENOMEMAKER_TRUTHVERIFIER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "eadlib/logger/Logger.h"
+
+#include "MappedFile.h"
+#include "RecordParser.h"
+#include "TruthReader.h"
+
+namespace genomeMaker {
+    class TruthVerifier {
+      public:
+        TruthVerifier( const MappedFile &genome, TruthReader &truth );
+        ~TruthVerifier();
+        bool verify( RecordParser &reads, RecordParser *mates );
+        uint64_t checked() const;
+        uint64_t mismatches() const;
+
+      private:
+        bool check( RecordParser &parser, const std::vector<TruthRecord> &records, const bool &interleaved );
+        //Private variables
+        static const size_t _MAX_REPORTED = 10; //mismatching reads printed before going quiet
+        const MappedFile        &_genome;
+        TruthReader             &_truth;
+        RecordParser::Record      _read;
+        std::vector<TruthRecord>  _records; //records of the read being checked (chimeric reads have several)
+        std::string               _expected;
+        std::string               _segment;
+        uint64_t                  _checked;
+        uint64_t                  _mismatches;
+    };
+}
+
+#endif //GENOMEMAKER_TRUTHVERIFIER_H
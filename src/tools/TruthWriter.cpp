@@ -0,0 +1,202 @@
+#include "TruthWriter.h"
+
+const std::string genomeMaker::TruthWriter::_MAGIC = std::string( "GMTRUTH\1", 8 );
+
+/**
+ * Constructor
+ * Truth file layout:
+ *   header: magic, varint flags (bit 0: paired, bit 1: numbered, bit 2: duplicates), varint read length, 4 letters,
+ *           varint genome name length, genome name, varint genome size
+ *   record: zigzag varint of the position delta to the previous record,
+ *           varint of ( error count << 5 | adapter << 4 | short << 3 | mate << 1 | reverse ),
+ *           [varint read length when short], [varint adapter bases when adapter],
+ *           [varint read number when numbered and first segment of a read],
+ *           [varint number of the read duplicated (0: none) when duplicates and first segment of a read],
+ *           per error: varint of ( position delta << 4 | type << 2 | letter index )
+ * @param writer EADlib File Writer
+ */
+genomeMaker::TruthWriter::TruthWriter( eadlib::io::FileWriter &writer ) :
+    _writer( writer ),
+    _letters( "ACGT" ),
+    _read_length( 0 ),
+    _numbered( false ),
+    _duplicates( false ),
+    _last_position( 0 ),
+    _records( 0 ),
+    _bytes( 0 )
+{}
+
+/**
+ * Destructor
+ */
+genomeMaker::TruthWriter::~TruthWriter() {}
+
+/**
+ * Writes the header of the truth file
+ * @param genome_name Name of the genome (used as the contig name)
+ * @param genome_size Size of the genome
+ * @param read_length Length of the reads
+ * @param paired      Paired reads flag
+ * @param letters     Letter set of the genome (4 letters)
+ * @param numbered    Store the read numbers (for reads not written in the order of their number)
+ * @param duplicates  Store the read each duplicate copies (duplicate reads simulated)
+ * @return Success
+ */
+bool genomeMaker::TruthWriter::writeHeader( const std::string &genome_name,
+                                            const uint64_t &genome_size,
+                                            const size_t &read_length,
+                                            const bool &paired,
+                                            const std::string &letters,
+                                            const bool &numbered,
+                                            const bool &duplicates ) {
+    if( letters.size() != 4 ) {
+        LOG_ERROR( "[genomeMaker::TruthWriter::writeHeader(..)] Letter set '", letters, "' is not 4 letters." );
+        return false;
+    }
+    if( !_writer.isOpen() && !_writer.open() ) {
+        LOG_ERROR( "[genomeMaker::TruthWriter::writeHeader(..)] Could not open the truth file '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _letters       = letters;
+    _read_length   = read_length;
+    _numbered      = numbered;
+    _duplicates    = duplicates;
+    _last_position = 0;
+    _records       = 0;
+    _buffer.append( _MAGIC );
+    appendVarInt( ( duplicates ? 4 : 0 ) | ( numbered ? 2 : 0 ) | ( paired ? 1 : 0 ) );
+    appendVarInt( read_length );
+    _buffer.append( letters );
+    appendVarInt( genome_name.size() );
+    _buffer.append( genome_name );
+    appendVarInt( genome_size );
+    return flush();
+}
+
+/**
+ * Carries on a truth file written by an earlier run (records appended after its last one)
+ * @param read_length   Length of the reads
+ * @param letters       Letter set of the genome (4 letters)
+ * @param numbered      Read numbers are stored (as in the header of the file)
+ * @param duplicates    Duplicated reads are stored (as in the header of the file)
+ * @param last_position Position of the last record in the file
+ * @return Success
+ */
+bool genomeMaker::TruthWriter::resume( const size_t &read_length,
+                                       const std::string &letters,
+                                       const bool &numbered,
+                                       const bool &duplicates,
+                                       const uint64_t &last_position ) {
+    if( letters.size() != 4 ) {
+        LOG_ERROR( "[genomeMaker::TruthWriter::resume(..)] Letter set '", letters, "' is not 4 letters." );
+        return false;
+    }
+    if( !_writer.isOpen() && !_writer.open() ) {
+        LOG_ERROR( "[genomeMaker::TruthWriter::resume(..)] Could not open the truth file '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _letters       = letters;
+    _read_length   = read_length;
+    _numbered      = numbered;
+    _duplicates    = duplicates;
+    _last_position = last_position;
+    _records       = 0;
+    return true;
+}
+
+/**
+ * Adds a read record
+ * @param record Truth record of the read
+ */
+void genomeMaker::TruthWriter::add( const TruthRecord &record ) {
+    const int64_t delta    = static_cast<int64_t>( record._position - _last_position );
+    const bool    is_short = record._length != _read_length;
+    const bool    adapter  = record._adapter_bases > 0;
+    appendVarInt( ( static_cast<uint64_t>( delta ) << 1 ) ^ static_cast<uint64_t>( delta >> 63 ) );
+    appendVarInt( ( static_cast<uint64_t>( record._errors.size() ) << 5 )
+                  | ( adapter ? 16u : 0u ) | ( is_short ? 8u : 0u )
+                  | ( static_cast<uint64_t>( record._mate & 3 ) << 1 ) | ( record._reverse ? 1u : 0u ) );
+    if( is_short ) {
+        appendVarInt( record._length );
+    }
+    if( adapter ) {
+        appendVarInt( record._adapter_bases );
+    }
+    if( _numbered && record._mate < 2 ) {
+        appendVarInt( record._read );
+    }
+    if( _duplicates && record._mate < 2 ) {
+        appendVarInt( record._duplicate );
+    }
+    uint32_t last { 0 };
+    for( const ErrorModel::Error &error : record._errors ) {
+        size_t letter = error._type == ErrorModel::Type::DELETION ? 0 : _letters.find( error._base );
+        appendVarInt( ( static_cast<uint64_t>( error._position - last ) << 4 )
+                      | ( static_cast<uint64_t>( error._type ) << 2 )
+                      | ( letter < 4 ? letter : 0 ) );
+        last = error._position;
+    }
+    _last_position = record._position;
+    _records++;
+}
+
+/**
+ * Writes the buffered records to the file
+ * @return Success
+ */
+bool genomeMaker::TruthWriter::flush() {
+    if( _buffer.empty() ) {
+        return true;
+    }
+    if( !_writer.write( _buffer ) ) {
+        LOG_ERROR( "[genomeMaker::TruthWriter::flush()] Could not write to truth file '", _writer.getFileName(), "'." );
+        return false;
+    }
+    _bytes += _buffer.size();
+    _buffer.clear();
+    return true;
+}
+
+/**
+ * Gets the number of records added
+ * @return Number of records
+ */
+uint64_t genomeMaker::TruthWriter::records() const {
+    return _records;
+}
+
+/**
+ * Gets the number of bytes written
+ * @return Bytes written
+ */
+uint64_t genomeMaker::TruthWriter::bytes() const {
+    return _bytes;
+}
+
+/**
+ * Gets the position of the last record added
+ * @return Genome position
+ */
+uint64_t genomeMaker::TruthWriter::lastPosition() const {
+    return _last_position;
+}
+
+/**
+ * Gets the truth file name
+ * @return File name
+ */
+std::string genomeMaker::TruthWriter::getFileName() const {
+    return _writer.getFileName();
+}
+
+/**
+ * Appends a LEB128 variable length integer to the buffer
+ * @param value Value
+ */
+void genomeMaker::TruthWriter::appendVarInt( uint64_t value ) {
+    while( value >= 0x80 ) {
+        _buffer.push_back( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+    }
+    _buffer.push_back( static_cast<char>( value ) );
+}
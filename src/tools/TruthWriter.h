@@ -0,0 +1,51 @@
+#ifndef GENOMEMAKER_TRUTHWRITER_H
+#define GENOMEMAKER_TRUTHWRITER_H
+
+#include <string>
+
+#include "eadlib/logger/Logger.h"
+#include "eadlib/io/FileWriter.h"
+
+#include "../containers/TruthRecord.h"
+
+namespace genomeMaker {
+    class TruthWriter {
+      public:
+        TruthWriter( eadlib::io::FileWriter &writer );
+        ~TruthWriter();
+        bool writeHeader( const std::string &genome_name,
+                          const uint64_t &genome_size,
+                          const size_t &read_length,
+                          const bool &paired,
+                          const std::string &letters,
+                          const bool &numbered = false,
+                          const bool &duplicates = false );
+        bool resume( const size_t &read_length,
+                     const std::string &letters,
+                     const bool &numbered,
+                     const bool &duplicates,
+                     const uint64_t &last_position );
+        void add( const TruthRecord &record );
+        bool flush();
+        uint64_t records() const;
+        uint64_t bytes() const;
+        uint64_t lastPosition() const;
+        std::string getFileName() const;
+        static const std::string _MAGIC;
+
+      private:
+        void appendVarInt( uint64_t value );
+        //Private variables
+        eadlib::io::FileWriter &_writer;
+        std::string             _buffer;
+        std::string             _letters;
+        size_t                  _read_length;
+        bool                    _numbered;   //read numbers are stored (reads not in the order of their number)
+        bool                    _duplicates; //the read each duplicate copies is stored
+        uint64_t                _last_position;
+        uint64_t                _records;
+        uint64_t                _bytes;
+    };
+}
+
+#endif //GENOMEMAKER_TRUTHWRITER_H
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "../src/tools/CoverageBias.h"
+
+namespace {
+    //Builds an overdispersed bias over a synthetic genome and returns its window weights
+    std::vector<double> overdispersedWeights( const uint64_t &seed ) {
+        const std::string genome_file = "CoverageBias_Tests.genome";
+        {
+            std::ofstream out( genome_file, std::ios::binary );
+            for( size_t i = 0; i < 10000; i++ ) {
+                out << "ACGTTGCA";
+            }
+        }
+        genomeMaker::CoverageBias bias;
+        bias.setOverdispersion( 0.5 );
+        bias.setWindow( 1000 );
+        bias.setSeed( seed );
+        std::vector<double> weights;
+        if( bias.build( genome_file, 80000, 1 << 12 ) ) {
+            for( size_t w = 0; w < bias.windows(); w++ ) {
+                weights.emplace_back( bias.weight( w ) );
+            }
+        }
+        std::remove( genome_file.c_str() );
+        return weights;
+    }
+}
+
+TEST( CoverageBias_Tests, same_seed_same_weights ) {
+    const std::vector<double> a = overdispersedWeights( 1 );
+    const std::vector<double> b = overdispersedWeights( 1 );
+    ASSERT_EQ( 80, a.size() );
+    ASSERT_EQ( a, b );
+}
+
+TEST( CoverageBias_Tests, seeds_give_different_weights ) {
+    const std::vector<double> a = overdispersedWeights( 1 );
+    const std::vector<double> b = overdispersedWeights( 2 );
+    ASSERT_EQ( 80, a.size() );
+    ASSERT_EQ( a.size(), b.size() );
+    size_t differ { 0 };
+    for( size_t w = 0; w < a.size(); w++ ) {
+        if( a[ w ] != b[ w ] ) {
+            differ++;
+        }
+    }
+    ASSERT_EQ( a.size(), differ );
+}
@@ -1,7 +1,6 @@
 #include "gtest/gtest.h"
 
-#include "SequencerSim_Tests.cpp"
-#include "GenomeCreator_Tests.cpp"
+#include "CoverageBias_Tests.cpp"
  //TODO unit tests!
 
 int main(int argc, char **argv) {